@@ -0,0 +1,48 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__ALLOCATIONCOUNTER__H__
+#define __SGCT__ALLOCATIONCOUNTER__H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sgct {
+
+/**
+ * Counts the heap allocations of each thread that go through the global operator new.
+ * If SGCT is built with the allocation counter, the operator is replaced for the whole
+ * application and checks a flag on every allocation. Only while the counting is enabled,
+ * each allocation is also added to the counters of the calling thread, which do not need
+ * any synchronization. Allocations with an extended alignment or directly through malloc
+ * are not counted.
+ */
+class AllocationCounter {
+public:
+    struct Counts {
+        uint64_t nAllocations = 0;
+        uint64_t nBytes = 0;
+    };
+
+    /// \return true if SGCT was built with the allocation counter
+    static bool isAvailable();
+
+    /// Enables or disables the counting, which is disabled by default
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /// \return the allocations of the calling thread while the counting was enabled
+    static Counts threadCounts();
+
+    /// Adds an allocation of \p bytes to the calling thread, used by operator new
+    static void recordAllocation(size_t bytes);
+};
+
+} // namespace sgct
+
+#endif // __SGCT__ALLOCATIONCOUNTER__H__
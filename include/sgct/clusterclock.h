@@ -0,0 +1,79 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CLUSTERCLOCK__H__
+#define __SGCT__CLUSTERCLOCK__H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace sgct {
+
+/**
+ * A monotonic clock that is synchronized to the clock of the master node. The clients
+ * regularly exchange timestamps with the node that sends them the sync data in the same
+ * way as NTP does and estimate the offset between their local clock and the master's
+ * clock from the exchange with the smallest round-trip delay. A relay answers the
+ * requests of its children with its own synchronized time, so the offsets add up along
+ * the tree. On the master, the cluster time is the same as the local time.
+ */
+class ClusterClock {
+public:
+    static ClusterClock& instance();
+    static void destroy();
+
+    /// Returns the time of the local monotonic clock in seconds since its creation
+    double localTime() const;
+
+    /**
+     * Returns the synchronized time of the cluster in seconds. The time never decreases,
+     * even if the estimated offset to the master is corrected downwards.
+     */
+    double time() const;
+
+    /// Returns the current estimate of the cluster time minus the local time in seconds
+    double offset() const;
+
+    /// Returns the round-trip delay of the exchange that the offset is based on
+    double roundTripDelay() const;
+
+    /**
+     * Adds the timestamps of an exchange with the parent node. \p t0 is the local time at
+     * which the request was sent, \p t1 and \p t2 are the cluster time of the parent at
+     * which the request was received and the reply was sent, and \p t3 is the local time
+     * at which the reply was received.
+     */
+    void addSample(double t0, double t1, double t2, double t3);
+
+private:
+    ClusterClock();
+
+    struct Sample {
+        double offset = 0.0;
+        double delay = 0.0;
+    };
+
+    static ClusterClock* _instance;
+
+    const std::chrono::steady_clock::time_point _start;
+
+    /// The last exchanges from which the one with the smallest delay is used
+    std::array<Sample, 8> _samples;
+    size_t _nSamples = 0;
+    std::mutex _sampleMutex;
+
+    std::atomic<double> _offset = 0.0;
+    std::atomic<double> _delay = 0.0;
+    mutable std::atomic<double> _lastTime = 0.0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__CLUSTERCLOCK__H__
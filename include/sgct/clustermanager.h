@@ -108,6 +108,73 @@ public:
     /// \param the state of the firm frame lock sync
     void setFirmFrameLockSyncStatus(bool state);
 
+    /// \return whether all connections should be served by a single network reactor
+    bool useNetworkReactor() const;
+
+    /// \param state if all connections should be served by a single network reactor
+    void setUseNetworkReactor(bool state);
+
+    /// \return whether nodes on the same computer are connected through shared memory
+    bool useSharedMemory() const;
+
+    /// \param state if nodes on the same computer are connected through shared memory
+    void setUseSharedMemory(bool state);
+
+    /// \return whether the shared data is compressed before it is sent to the clients
+    bool useSyncCompression() const;
+
+    /// \return whether data transfer packages are compressed before they are sent
+    bool useDataTransferCompression() const;
+
+    /// \return the number of bytes a payload must have before it is compressed
+    int compressionThreshold() const;
+
+    /// \return whether the shared data is sent as a delta against the previous frame
+    bool useDeltaEncoding() const;
+
+    /// \return the number of frames between two full frames of delta encoded data
+    int keyframeInterval() const;
+
+    /**
+     * \return the directory in which received data transfer packages are cached or an
+     *         empty string if the packages are always sent
+     */
+    const std::string& dataTransferCache() const;
+
+    /**
+     * \return the time in microseconds that the render thread polls for the sync messages
+     *         of a frame before it blocks until they arrive
+     */
+    int syncSpinTime() const;
+
+    /**
+     * \return the number of frames that the master may send to the clients before they
+     *         have to be acknowledged. If this is 0, the master waits for the clients in
+     *         every frame
+     */
+    int renderAhead() const;
+
+    /**
+     * \return true if the clients decode the shared data on the receiving thread into a
+     *         staging copy of the application state, which is swapped in at the start of
+     *         the next frame. This requires the application to set a staged decode
+     *         function in the SharedData
+     */
+    bool useAsyncDecode() const;
+
+    /**
+     * \return the multicast group that the master uses to send the sync data to the
+     *         clients or an empty string if the sync data is sent over the sync
+     *         connections
+     */
+    const std::string& multicastAddress() const;
+
+    /// \return the UDP port of the multicast group
+    int multicastPort() const;
+
+    /// \return the address of the interface used for multicast or an empty string
+    const std::string& multicastInterface() const;
+
     /// \return the external control port number
     int externalControlPort() const;
 
@@ -129,6 +196,20 @@ private:
     const int _thisNodeId;
     bool _firmFrameLockSync = false;
     bool _ignoreSync = false;
+    bool _useNetworkReactor = false;
+    bool _useSharedMemory = true;
+    bool _useSyncCompression = false;
+    bool _useDataTransferCompression = false;
+    int _compressionThreshold = 1024;
+    bool _useDeltaEncoding = false;
+    int _keyframeInterval = 60;
+    std::string _dataTransferCache;
+    int _syncSpinTime = 0;
+    int _renderAhead = 0;
+    bool _useAsyncDecode = false;
+    std::string _multicastAddress;
+    int _multicastPort = 0;
+    std::string _multicastInterface;
     std::string _masterAddress;
     int _externalControlPort = 0;
 
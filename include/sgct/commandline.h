@@ -18,13 +18,18 @@
 namespace sgct {
 
 struct Configuration {
+    /// The API through which the contexts are created when running without a display
+    enum class HeadlessBackend { EGL, OSMesa };
+
     std::optional<std::string> configFilename;
     std::optional<bool> isServer;
     std::optional<Log::Level> logLevel;
+    std::optional<std::string> logFilePath;
     std::optional<bool> showHelpText;
     std::optional<int> nodeId;
     std::optional<bool> firmSync;
     std::optional<bool> ignoreSync;
+    std::optional<bool> useNetworkReactor;
     std::optional<Settings::CaptureFormat> captureFormat;
     std::optional<int> nCaptureThreads;
     std::optional<bool> exportCorrectionMeshes;
@@ -33,6 +38,18 @@ struct Configuration {
     std::optional<bool> addNodeNameInScreenshot;
     std::optional<bool> omitWindowNameInScreenshot;
     std::optional<bool> useOpenGLDebugContext;
+    std::optional<std::string> recordingPath;
+    std::optional<std::string> replayPath;
+    std::optional<bool> replayAtMaxRate;
+    std::optional<std::string> clusterStatisticsPath;
+    std::optional<std::string> stageTimingsPath;
+    std::optional<double> stageTimingsInterval;
+    std::optional<std::string> tracePath;
+    std::optional<int> traceFrames;
+    std::optional<bool> useGpuTimings;
+    std::optional<bool> countAllocations;
+    std::optional<HeadlessBackend> headless;
+    std::optional<int> maxFrames;
 };
 
 /**
@@ -48,6 +48,26 @@ void validateCapture(const Capture& capture);
 
 
 
+struct Compression {
+    std::optional<bool> sync;
+    std::optional<bool> dataTransfer;
+    std::optional<int> threshold;
+    std::optional<bool> delta;
+    std::optional<int> keyframeInterval;
+};
+void validateCompression(const Compression& compression);
+
+
+
+struct Multicast {
+    std::string address;
+    int port = 0;
+    std::optional<std::string> interfaceAddress;
+};
+void validateMulticast(const Multicast& multicast);
+
+
+
 struct Scene {
     std::optional<vec3> offset;
     std::optional<quat> orientation;
@@ -325,6 +345,7 @@ struct Node {
     int port = 0;
     std::optional<int> dataTransferPort;
     std::optional<bool> swapLock;
+    std::optional<int> parent;
     std::vector<Window> windows;
 };
 void validateNode(const Node& node);
@@ -339,10 +360,18 @@ struct Cluster {
     std::optional<int> setThreadAffinity;
     std::optional<int> externalControlPort;
     std::optional<bool> firmSync;
+    std::optional<bool> useNetworkReactor;
+    std::optional<bool> useSharedMemory;
+    std::optional<std::string> dataTransferCache;
+    std::optional<int> syncSpinTime;
+    std::optional<int> renderAhead;
+    std::optional<bool> asyncDecode;
     std::optional<Scene> scene;
     std::vector<Node> nodes;
     std::vector<User> users;
     std::optional<Capture> capture;
+    std::optional<Compression> compression;
+    std::optional<Multicast> multicast;
     std::vector<Tracker> trackers;
     std::optional<Settings> settings;
 };
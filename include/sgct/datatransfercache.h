@@ -0,0 +1,62 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__DATATRANSFERCACHE__H__
+#define __SGCT__DATATRANSFERCACHE__H__
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+namespace sgct {
+
+/**
+ * An on-disk cache of data transfer packages that is indexed by the content of the
+ * packages. Before a package is sent, the sender offers the key of the package and the
+ * receiver only requests the package if it is not in its cache already.
+ */
+class DataTransferCache {
+public:
+    /// Identifies the content of a package
+    struct Key {
+        /// The 64-bit FNV-1a hash of the package
+        uint64_t hash = 0;
+        /// The CRC-32 of the package, which makes a collision of both vanishingly rare
+        uint32_t checksum = 0;
+        uint32_t size = 0;
+
+        bool operator==(const Key& rhs) const;
+    };
+
+    /// Calculates the key for the \p size bytes of \p data
+    static Key key(const char* data, uint32_t size);
+
+    /// Creates a cache in the \p directory, which is created if it does not exist
+    explicit DataTransferCache(std::filesystem::path directory);
+
+    /**
+     * Maps the package with the \p key into memory and calls \p function with it. The
+     * mapping is private, so changes made to the data do not end up in the cache.
+     *
+     * \return false if the package is not in the cache
+     */
+    bool load(const Key& key, const std::function<void(char*, uint32_t)>& function) const;
+
+    /// Stores the \p size bytes of \p data in the cache under the \p key
+    void store(const Key& key, const char* data, uint32_t size) const;
+
+private:
+    std::filesystem::path path(const Key& key) const;
+
+    const std::filesystem::path _directory;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__DATATRANSFERCACHE__H__
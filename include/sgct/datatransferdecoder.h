@@ -0,0 +1,68 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__DATATRANSFERDECODER__H__
+#define __SGCT__DATATRANSFERDECODER__H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * Calls the decode function for received data transfer packages on a separate thread.
+ * This is used with the network reactor, whose single thread reads all connections and
+ * must not wait for the application to decode a package. The packages are decoded one
+ * after the other in the order in which they were received.
+ */
+class DataTransferDecoder {
+public:
+    /**
+     * \param decode called with the package data, its size in bytes, the package id,
+     *        and the id of the connection that received the package
+     */
+    explicit DataTransferDecoder(std::function<void(void*, int, int, int)> decode);
+    ~DataTransferDecoder();
+
+    /// Queues the \p data of the package \p packageId received by \p connectionId
+    void push(std::vector<char> data, int packageId, int connectionId);
+
+    /**
+     * Drops all queued packages and stops calling the decode function. If a package is
+     * being decoded, this function waits until the decode function has returned.
+     */
+    void clear();
+
+private:
+    struct Package {
+        std::vector<char> data;
+        int id = -1;
+        int connectionId = -1;
+    };
+
+    void run();
+
+    std::function<void(void*, int, int, int)> _decodeFn;
+    /// Held while the decode function is called so that it can be cleared safely
+    std::mutex _decodeMutex;
+
+    std::deque<Package> _queue;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::atomic_bool _shouldTerminate = false;
+    std::thread _thread;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__DATATRANSFERDECODER__H__
@@ -0,0 +1,129 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__DATATRANSFERQUEUE__H__
+#define __SGCT__DATATRANSFERQUEUE__H__
+
+#include <sgct/datatransfercache.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+class Network;
+
+/**
+ * Sends data transfer packages asynchronously on a separate thread so that the caller
+ * never waits for the network. Each package is split into chunks and only a limited
+ * number of chunks is in flight to each connection at any time; the receiving side
+ * acknowledges every chunk it has processed, which frees the slot for the next chunk.
+ * The chunks of all queued packages are sent in a round-robin fashion, so a small
+ * package is not held back by a large package that was queued before it. Packages that
+ * share the same id are sent to a connection one after the other, as the receiver
+ * assembles the chunks by the package id.
+ *
+ * If the data transfer cache is enabled, the key of each package is offered to each
+ * connection first and the package is only sent if the receiver does not have it in its
+ * cache already.
+ */
+class DataTransferQueue {
+public:
+    /**
+     * \param acknowledge called with the package id and the connection id once a package
+     *        was received completely and decoded by a connection
+     * \param progress called with the package id, the connection id, and the fraction of
+     *        the package that was acknowledged whenever a chunk was acknowledged
+     * \param useCompression whether packages should be compressed before they are sent
+     * \param compressionThreshold packages smaller than this are never compressed
+     * \param useCache whether the packages are offered before they are sent
+     */
+    DataTransferQueue(std::function<void(int, int)> acknowledge,
+        std::function<void(int, int, float)> progress, bool useCompression,
+        int compressionThreshold, bool useCache);
+    ~DataTransferQueue();
+
+    /// Queues the \p data to be sent to all \p connections as the package \p packageId
+    void push(std::vector<char> data, int packageId, std::vector<Network*> connections);
+
+    /// Called when the receiving side of the \p connection processed a chunk
+    void acknowledge(int packageId, const Network& connection);
+
+    /**
+     * Called when the receiving side of the \p connection answered the offer of a
+     * package. If the package \p isCached, the transfer is complete without sending it.
+     */
+    void offerReply(int packageId, const Network& connection, bool isCached);
+
+private:
+    struct Package {
+        int id = -1;
+        std::vector<char> data;
+        /// The key of the uncompressed package that is offered to the receivers
+        DataTransferCache::Key key;
+        /// The size of the package before compression or 0 if it is not compressed
+        uint32_t uncompressedSize = 0;
+        uint32_t nChunks = 0;
+    };
+
+    struct Transfer {
+        enum class State { Offer, WaitingForReply, Send };
+
+        std::shared_ptr<const Package> package;
+        Network* connection = nullptr;
+        State state = State::Send;
+        uint32_t nSent = 0;
+        uint32_t nAcknowledged = 0;
+    };
+
+    struct QueuedPackage {
+        std::shared_ptr<Package> package;
+        std::vector<Network*> connections;
+    };
+
+    void run();
+
+    /// Compresses the package if it is worth it and splits it into chunks
+    void prepare(Package& package) const;
+
+    /**
+     * Returns the next transfer that has an offer or a chunk to send or nullptr if there
+     * is none
+     */
+    std::shared_ptr<Transfer> nextTransfer();
+
+    /// Sends the key of the transfer's package to the transfer's connection
+    void sendOffer(const Transfer& transfer);
+
+    /// Sends the chunk \p index of the transfer's package to the transfer's connection
+    void sendChunk(const Transfer& transfer, uint32_t index);
+
+    const std::function<void(int, int)> _acknowledgeFn;
+    const std::function<void(int, int, float)> _progressFn;
+    const bool _useCompression;
+    const int _compressionThreshold;
+    const bool _useCache;
+
+    std::vector<QueuedPackage> _queue;
+    std::vector<std::shared_ptr<Transfer>> _transfers;
+    size_t _nextTransfer = 0;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::atomic_bool _shouldTerminate = false;
+    std::thread _thread;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__DATATRANSFERQUEUE__H__
@@ -13,21 +13,28 @@
 #include <sgct/callbackdata.h>
 #include <sgct/config.h>
 #include <sgct/frustum.h>
+#include <sgct/gputimings.h>
 #include <sgct/joystick.h>
 #include <sgct/keys.h>
 #include <sgct/modifiers.h>
 #include <sgct/mouse.h>
+#include <sgct/networkmanager.h>
 #include <sgct/window.h>
 #include <array>
+#include <cstdint>
 #include <functional>
+#include <iosfwd>
 #include <optional>
 #include <thread>
+#include <vector>
 
 namespace sgct {
 
 struct Configuration;
 class Node;
+class StageTimings;
 class StatisticsRenderer;
+class SyncPlayer;
 
 // The `path` should be an absolute path or relative to the current working directory
 config::Cluster loadCluster(std::optional<std::string> path);
@@ -48,6 +55,37 @@ public:
         std::array<double, HistoryLength> syncTimes = {};
         std::array<double, HistoryLength> loopTimeMin = {};
         std::array<double, HistoryLength> loopTimeMax = {};
+        /// The time between the earliest and latest swap of a frame across the cluster
+        std::array<double, HistoryLength> swapSkews = {};
+        unsigned int nSwapSkews = 0;
+        /// The time that a frame is delayed by rendering ahead. On the clients this is
+        /// the time a frame was queued, on the master the frames in flight times the
+        /// frame time
+        std::array<double, HistoryLength> renderAheadLatencies = {};
+        /// The time that the render thread was blocked on locks shared with the network
+        /// threads during a frame
+        std::array<double, HistoryLength> lockWaitTimes = {};
+        /// The GPU time of each GpuTimings::Pass, which is available a few frames later
+        std::array<std::array<double, HistoryLength>, GpuTimings::PassCount>
+            gpuPassTimes = {};
+        /// The number of heap allocations of the render thread in each frame, which is
+        /// only counted if the AllocationCounter is enabled
+        std::array<uint64_t, HistoryLength> allocations = {};
+
+        /// The timings that a node reported to the master for its last frames
+        struct NodeTimes {
+            std::array<double, HistoryLength> frameTimes = {};
+            /// The time from the start of the frame until it was ready to be swapped
+            std::array<double, HistoryLength> drawTimes = {};
+            std::array<double, HistoryLength> decodeTimes = {};
+            std::array<double, HistoryLength> syncTimes = {};
+            std::array<double, HistoryLength> swapTimes = {};
+        };
+        /// The reported timings of each node indexed by the node id, only on the master
+        std::vector<NodeTimes> nodeTimes;
+        /// The node with the longest draw and decode time of each frame or -1 if no node
+        /// reported its timings for the frame
+        std::array<int, HistoryLength> slowestNodes = {};
 
         /// \return the frame time (delta time) in seconds
         double dt() const;
@@ -61,6 +99,11 @@ public:
         /// \return the maximum frame time (delta time) in the averaging window (seconds)
         double maxDt() const;
 
+        /// \return the median swap skew in the averaging window (seconds)
+        double swapSkewP50() const;
+
+        /// \return the 99th percentile of the swap skew in the averaging window (seconds)
+        double swapSkewP99() const;
     };
 
     struct Callbacks {
@@ -103,6 +146,16 @@ public:
         /// decoding.
         std::function<void(const std::vector<std::byte>&, unsigned int)> decode;
 
+        /// Alternative to encode that appends the shared data to the provided buffer.
+        /// The buffer is reused between frames, which avoids allocating and copying the
+        /// data every frame. If both are set, this function is used.
+        std::function<void(std::vector<std::byte>&)> encodeInPlace;
+
+        /// Alternative to decode that is called with a pointer to the shared data and
+        /// its size in bytes. The pointer refers to SGCT's receive buffer and is only
+        /// valid for the duration of the call. If both are set, this function is used.
+        std::function<void(const std::byte*, size_t)> decodeInPlace;
+
         /// This function is called when a TCP message is received
         std::function<void(const char*, int)> externalDecode;
 
@@ -118,6 +171,11 @@ public:
         /// This function is called when data is successfully sent
         std::function<void(int, int)> dataTransferAcknowledge;
 
+        /// This function is called whenever a part of a package has been received by a
+        /// node. The parameters are the package id, the node's connection id, and the
+        /// fraction of the package that has been received so far
+        std::function<void(int, int, float)> dataTransferProgress;
+
         /// This function sets the keyboard callback (GLFW wrapper) for all windows
         std::function<void(Key, Modifier, Action, int)> keyboard;
 
@@ -156,6 +214,19 @@ public:
     /// Returns the statistic object containing all information about the frametimes, etc
     const Statistics& statistics() const;
 
+    /**
+     * Returns the CPU times of the stages of the render loop. Snapshots of these can be
+     * taken from any thread while the render loop is running.
+     */
+    const StageTimings& stageTimings() const;
+
+    /**
+     * Returns the GPU timings of the render passes, which are measured while the
+     * statistics are shown or if they were requested on the command line. The results
+     * are added to the statistics a few frames after they were measured.
+     */
+    GpuTimings& gpuTimings();
+
     /// \return the clear color as 4 floats (RGBA)
     vec4 clearColor() const;
 
@@ -229,6 +300,9 @@ public:
     /// Get the time from program start in seconds
     static double getTime();
 
+    /// Get the time in seconds that is synchronized to the master node across the cluster
+    static double clusterTime();
+
     /// \return a reference to this node (running on this computer).
     const Node& thisNode() const;
 
@@ -286,6 +360,17 @@ private:
      */
     void frameLockPostStage();
 
+    /**
+     * Decodes the next frame of the replayed recording, waiting until it is due if the
+     * recording is replayed at its recorded rate.
+     *
+     * \return false if the end of the recording was reached
+     */
+    bool replayFrame();
+
+    /// Writes the recorded trace to the next file derived from the trace path
+    void dumpTrace();
+
     /// Draw viewport overlays if there are any.
     void drawOverlays(const Window& window, Frustum::Mode frustum);
 
@@ -333,15 +418,45 @@ private:
 
     Statistics _statistics;
     double _statsPrevTimestamp = 0.0;
+    uint64_t _statsPrevAllocations = 0;
+    /// The timings that the nodes reported, kept between frames so that it does not
+    /// allocate each frame
+    std::vector<NetworkManager::NodeTiming> _nodeTimingsScratch;
     std::unique_ptr<StatisticsRenderer> _statisticsRenderer;
+    std::unique_ptr<StageTimings> _stageTimings;
+    GpuTimings _gpuTimings;
+    bool _useGpuTimings = false;
+
+    /// The file name of the traces that are written, if the trace recorder is enabled
+    std::optional<std::string> _tracePath;
+    /// The number of frames after which the trace is written automatically
+    std::optional<int> _traceFrames;
+    int _nTraceDumps = 0;
 
     bool _createDebugContext = false;
     bool _takeScreenshot = false;
     bool _shouldTerminate = false;
+    /// The number of frames after which the render loop ends, if any
+    std::optional<int> _maxFrames;
+
+    /// Whether the windows are hidden and only hold contexts without a display
+    bool _isHeadless = false;
+    /// Whether a headless context has a default framebuffer to render the warping into
+    bool _hasHeadlessFramebuffer = false;
 
     bool _printSyncMessage = true;
     float _syncTimeout = 60.f;
 
+    /// The recording that is decoded instead of encoding the shared data, if any
+    std::unique_ptr<SyncPlayer> _replay;
+    bool _replayAtMaxRate = false;
+    /// The local time minus the recorded time of the frames, set by the first frame
+    std::optional<double> _replayTimeOffset;
+    int _nReplayedFrames = 0;
+
+    /// The file into which the master writes the timings that the nodes report, if any
+    std::unique_ptr<std::ofstream> _clusterStatisticsFile;
+
     struct FXAAShader {
         ShaderProgram shader;
         int sizeX = -1;
@@ -353,8 +468,6 @@ private:
     ShaderProgram _fboQuad;
     ShaderProgram _overlay;
 
-    std::unique_ptr<std::thread> _thread;
-
     unsigned int _frameCounter = 0;
     unsigned int _shotCounter = 0;
 };
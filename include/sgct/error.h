@@ -22,6 +22,11 @@ namespace sgct {
  * 1003: User / Name 'default' is not permitted for a user
  * 1010: Capture / Capture path must not be empty
  * 1011: Capture / Screenshot ranges beginning has to be before the end
+ * 1015: Compression / Compression threshold must not be negative
+ * 1016: Compression / Compression keyframe interval must be positive
+ * 1017: Multicast / Multicast address must not be empty
+ * 1018: Multicast / Multicast port must be positive
+ * 1019: Multicast / Multicast interface address must not be empty
  * 1020: Settings / Swap interval must not be negative
  * 1021: Settings / Refresh rate must not be negative
  * 1030: Device / Device name must not be empty
@@ -74,6 +79,11 @@ namespace sgct {
  * 1125: Cluster / All trackers specified in the 'User's have to be valid tracker names
  * 1127: Cluster / Configuration must contain at least one node
  * 1128: Cluster / Two or more nodes are using the same port
+ * 1129: Cluster / Node %i has an invalid parent node %i
+ * 1130: Cluster / Parent of node %i forms a cycle
+ * 1131: Cluster / Cluster data transfer cache must not be empty
+ * 1132: Cluster / Cluster sync spin time must be non-negative
+ * 1133: Cluster / Cluster render ahead must be non-negative
 
  * 2000s: Correction Meshes
  * 2000: CorrectionMesh / Failed to export. Geometry type is not supported"
@@ -122,7 +132,11 @@ namespace sgct {
  * 3004: Engine / No sync signal from master after X seconds
  * 3005: Engine / No sync signal from clients after X seconds
  * 3006: Engine / Error requesting maximum number of swap groups
+ * 3007: Engine / Replaying a recording requires a cluster with a single node
+ * 3008: Engine / Failed to open cluster statistics file
+ * 3009: Engine / Failed to open stage timings file
  * 3010: Engine / GLFW error
+ * 3011: Engine / Headless mode requires GLFW 3.4 or later with the null platform
 
  * 4000s: MPCDI
  * 4000: MPCDI / Failed to parse position from XML
@@ -170,6 +184,11 @@ namespace sgct {
  * 5012: Network / Failed to uncompress data for connection %i: %s // Data Transfer
  * 5013: Network / TCP connection %i receive failed: %s
  * 5014: Network / Send data failed: %s
+ * 5015: NetworkReactor / Failed to create network reactor: %s
+ * 5016: NetworkReactor / Failed to register socket with network reactor: %s
+ * 5017: SharedData / Received malformed shared data frame %i
+ * 5018: SharedData / Shared variable id %i is already registered
+ * 5019: SharedData / Received %i bytes for shared variable %i in frame %i
  * 5020: NetworkManager / Winsock 2.2 startup failed
  * 5021: NetworkManager / No address information for this node available
  * 5022: NetworkManager / No address information for master available
@@ -179,6 +198,22 @@ namespace sgct {
  * 5026: NetworkManager / Empty address for connection to %i
  * 5027: NetworkManager / Failed to get host name
  * 5028: NetworkManager / Failed to get address info: %s
+ * 5030: MulticastChannel / Invalid multicast group address %s
+ * 5031: MulticastChannel / Failed to create multicast socket: %s
+ * 5032: MulticastChannel / Failed to bind multicast socket: %s
+ * 5033: MulticastChannel / Failed to join multicast group %s: %s
+ * 5034: Network / Received malformed multicast message %i
+ * 5035: Network / Received malformed data chunk for package %i
+ * 5036: Network / Received malformed data offer for package %i
+ * 5037: Network / Received malformed time sync message on connection %i
+ * 5038: SharedMemoryChannel / Failed to create shared memory segment %s: %i
+ * 5039: SharedMemoryChannel / Shared memory channel is not supported on this OS
+ * 5040: Network / Send data failed on shared memory connection %i
+ * 5041: SyncRecorder / Failed to create recording %s: %i
+ * 5042: SyncRecorder / Failed to write recording %s: %i
+ * 5043: SyncPlayer / Failed to open recording %s: %i
+ * 5044: SyncPlayer / File %s is not a valid recording
+ * 5045: Network / Send queue of connection %i exceeds %i bytes
 
  * 6000s: XML configuration parsing
  * 6000: PlanarProjection / Missing specification of field-of-view values
@@ -196,6 +231,8 @@ namespace sgct {
  * 6050: Settings / Wrong buffer precision value. Must be 16 or 32
  * 6051: Settings / Wrong buffer precision value type
  * 6060: Capture / Unknown capturing format. Needs to be png, tga, jpg
+ * 6065: Multicast / Missing field address in multicast
+ * 6066: Multicast / Missing field port in multicast
  * 6070: Tracker / Tracker is missing 'name'
  * 6080: XML Parsing / No XML file provided
  * 6081: XML Parsing / Could not find configureation file: %s
@@ -0,0 +1,106 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__GPUTIMINGS__H__
+#define __SGCT__GPUTIMINGS__H__
+
+#include <array>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * Measures the GPU time of the render passes with timestamp queries without waiting for
+ * the GPU. The queries of a frame are only read back when the same slot of the ring is
+ * used again, a few frames later, by which time the GPU has finished the frame. If the
+ * results are not available yet, they are dropped instead of stalling the pipeline. A
+ * pass that is rendered several times in a frame, for example once per window or eye,
+ * is reported as the sum of all its measurements. Passes can be nested, in which case
+ * the outer pass includes the time of the inner ones.
+ */
+class GpuTimings {
+public:
+    enum class Pass {
+        /// The whole frame from the first window to the last warp
+        Frame = 0,
+        CubemapRight,
+        CubemapLeft,
+        CubemapBottom,
+        CubemapTop,
+        CubemapFront,
+        CubemapBack,
+        /// Resampling the cubemap into the non-linear projection
+        Resample,
+        /// All regular viewports of a window, including their post processing
+        Viewports,
+        FXAA,
+        /// Rendering the window's texture to the screen with warping and blending
+        Warp,
+        Overlays
+    };
+    static constexpr const int PassCount = 12;
+
+    /// The number of frames between issuing the queries and reading them back
+    static constexpr const int FrameLatency = 4;
+
+    /// Measures the GPU time of the commands that are issued during its lifetime
+    class Scope {
+    public:
+        Scope(GpuTimings& timings, Pass pass);
+        ~Scope();
+
+    private:
+        GpuTimings& _timings;
+        int _index = -1;
+    };
+
+    /// \return the human readable name of the \p pass
+    static std::string_view name(Pass pass);
+
+    /// Enables or disables the measurements, which are disabled by default
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * Starts the next frame by reading back the queries of the frame that used the same
+     * slot of the ring. This has to be called at the start of each frame.
+     *
+     * \return the time of each pass in seconds of the frame that was read back, or an
+     *         empty optional if no frame was read back
+     */
+    std::optional<std::array<double, PassCount>> beginFrame();
+
+    /// \return the number of frames whose results were not available in time
+    int nDroppedFrames() const;
+
+    /// Deletes the query objects, which requires the OpenGL context to be current
+    void deleteQueries();
+
+private:
+    struct Frame {
+        std::vector<unsigned int> queries;
+        /// The pass of each begin and end pair of queries
+        std::vector<Pass> passes;
+        int nUsed = 0;
+    };
+
+    /// \return the index of the query pair that was started for the \p pass
+    int begin(Pass pass);
+    void end(int index);
+
+    std::array<Frame, FrameLatency> _frames;
+    int _current = 0;
+    bool _isEnabled = false;
+    int _nDroppedFrames = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__GPUTIMINGS__H__
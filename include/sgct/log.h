@@ -9,14 +9,27 @@
 #ifndef __SGCT__LOGGER__H__
 #define __SGCT__LOGGER__H__
 
+#include <sgct/fmt.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
 #include <functional>
 #include <mutex>
 #include <string>
 #include <string_view>
-#include <vector>
+#include <thread>
 
 namespace sgct {
 
+/**
+ * The messages are passed to a background thread that writes them to the console, the
+ * log file, and the callback. Logging a message only pushes it onto a lock-free queue,
+ * so it never waits for the output. The writer thread takes all queued messages at once
+ * and flushes the outputs once per batch. At exit, the remaining messages are written
+ * and the log falls back to writing synchronously on the calling thread.
+ */
 class Log {
 public:
     /// Different notify levels for messages
@@ -30,6 +43,19 @@ public:
     static void Info(std::string_view message);
     static void Error(std::string_view message);
 
+    /// Formats the message with the \p format and \p args only if the level is enabled
+    template <typename T, typename... Args>
+    static void Debug(std::string_view format, T&& arg, Args&&... args);
+    template <typename T, typename... Args>
+    static void Warning(std::string_view format, T&& arg, Args&&... args);
+    template <typename T, typename... Args>
+    static void Info(std::string_view format, T&& arg, Args&&... args);
+    template <typename T, typename... Args>
+    static void Error(std::string_view format, T&& arg, Args&&... args);
+
+    /// \return true if messages of the \p level are currently logged
+    static bool isEnabled(Level level);
+
     /// Set the notify level for displaying messages
     void setNotifyLevel(Level nl);
 
@@ -42,29 +68,109 @@ public:
     /// Set if log to console should be enabled. It is enabled on default
     void setLogToConsole(bool state);
 
+    /**
+     * Writes all messages into the file at \p path in addition to the other outputs. An
+     * empty path closes the file.
+     */
+    void setLogFile(const std::string& path);
+
     /// Set the callback that gets invoked for each log. If you want to disable logging to
-    /// the callback, pass a null function as a parameter
+    /// the callback, pass a null function as a parameter. The callback is invoked on the
+    /// writer thread unless the asynchronous writer is disabled
     void setLogCallback(std::function<void(Level, std::string_view)> fn);
 
+    /**
+     * Sets whether the messages are written by the background thread, which is the
+     * default, or directly by the thread that logs them. Disabling it writes all queued
+     * messages before returning.
+     */
+    void setUseAsyncWriter(bool state);
+
+    /// Blocks until all messages that were logged before this call have been written
+    void flush();
+
 private:
+    struct Message {
+        Level level;
+        time_t time;
+        std::string text;
+        Message* next = nullptr;
+    };
+
     Log();
+    ~Log();
 
     void printv(Level level, std::string message);
+    void write(const Message& message);
+    void writeBatch(Message* messages);
+    void startWriter();
+    void stopWriter();
+    void writerLoop();
 
     static Log* _instance;
 
-    std::vector<char> _parseBuffer;
-
-    Level _level = Level::Info;
+    std::atomic<Level> _level = Level::Info;
     bool _showTime = false;
     bool _showLevel = true;
     bool _logToConsole = true;
+    std::ofstream _file;
 
-    std::mutex _mutex;
+    /// Protects the outputs, which are only used by one thread at a time
+    std::recursive_mutex _mutex;
 
     std::function<void(Level, std::string_view)> _messageCallback;
+
+    /// The messages that were not written yet with the newest one first
+    std::atomic<Message*> _queue = nullptr;
+    std::atomic<uint64_t> _nQueued = 0;
+    std::atomic<uint64_t> _nWritten = 0;
+
+    std::thread _writer;
+    std::atomic_bool _isWriterRunning = false;
+    std::mutex _writerMutex;
+    std::condition_variable _writerCondition;
 };
 
+template <typename T, typename... Args>
+void Log::Debug(std::string_view format, T&& arg, Args&&... args) {
+    if (isEnabled(Level::Debug)) {
+        instance().printv(
+            Level::Debug,
+            fmt::vformat(format, fmt::make_format_args(arg, args...))
+        );
+    }
+}
+
+template <typename T, typename... Args>
+void Log::Warning(std::string_view format, T&& arg, Args&&... args) {
+    if (isEnabled(Level::Warning)) {
+        instance().printv(
+            Level::Warning,
+            fmt::vformat(format, fmt::make_format_args(arg, args...))
+        );
+    }
+}
+
+template <typename T, typename... Args>
+void Log::Info(std::string_view format, T&& arg, Args&&... args) {
+    if (isEnabled(Level::Info)) {
+        instance().printv(
+            Level::Info,
+            fmt::vformat(format, fmt::make_format_args(arg, args...))
+        );
+    }
+}
+
+template <typename T, typename... Args>
+void Log::Error(std::string_view format, T&& arg, Args&&... args) {
+    if (isEnabled(Level::Error)) {
+        instance().printv(
+            Level::Error,
+            fmt::vformat(format, fmt::make_format_args(arg, args...))
+        );
+    }
+}
+
 } // namespace sgct
 
 #endif // __SGCT__LOGGER__H__
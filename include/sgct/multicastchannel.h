@@ -0,0 +1,98 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__MULTICASTCHANNEL__H__
+#define __SGCT__MULTICASTCHANNEL__H__
+
+#include <sgct/network.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * A UDP multicast channel that the master uses to send the sync data to all clients at
+ * once. Each message is identified by a sequence number and is split into datagrams
+ * that are reassembled on the receiving side. The channel itself is unreliable; lost
+ * messages are requested again by the clients over their sync connection. Every sending
+ * side picks a random session id, and the receiving side drops all datagrams that do not
+ * belong to the session that was announced to it, for example those of another cluster
+ * that uses the same group and port.
+ */
+class MulticastChannel {
+public:
+    /**
+     * Creates a channel for the multicast \p group and \p port. The sending side only
+     * sends messages, the receiving side joins the group and starts a thread that
+     * reassembles the incoming messages.
+     *
+     * \param group the IPv4 multicast address of the group
+     * \param port the UDP port that is used by the group
+     * \param interfaceAddress the IPv4 address of the interface that is used for the
+     *        multicast traffic. If it is empty, the operating system picks the interface
+     * \param isSender whether this is the sending or the receiving side
+     */
+    MulticastChannel(const std::string& group, int port,
+        const std::string& interfaceAddress, bool isSender);
+    ~MulticastChannel();
+
+    /// Sends the \p size bytes of \p data to the group as the message \p sequence
+    void send(uint32_t sequence, const void* data, uint32_t size);
+
+    /// \return the session id of the sending side, which is never 0
+    uint32_t session() const;
+
+    /**
+     * Waits until the message \p sequence of the \p session has been received completely
+     * and copies it into \p data. Datagrams of other sessions are ignored from then on.
+     *
+     * \return false if the message was not received within the \p timeout
+     */
+    bool receive(uint32_t session, uint32_t sequence, std::vector<char>& data,
+        std::chrono::milliseconds timeout);
+
+private:
+    struct Message {
+        uint32_t session = 0;
+        uint32_t sequence = 0;
+        uint32_t nMissingFragments = 0;
+        std::vector<bool> hasFragment;
+        std::vector<char> data;
+    };
+
+    void receiveLoop();
+    void addFragment(const char* datagram, int size);
+
+    SGCT_SOCKET _socket;
+    const bool _isSender;
+    /// The multicast group and port in network byte order
+    uint32_t _group = 0;
+    uint16_t _port = 0;
+    /// Picked by the sending side, set from the announcements on the receiving side
+    std::atomic<uint32_t> _session = 0;
+    std::vector<char> _sendBuffer;
+
+    /// The most recent messages indexed by their sequence number modulo the size
+    std::array<Message, 8> _messages;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::atomic_bool _shouldTerminate = false;
+    std::unique_ptr<std::thread> _thread;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__MULTICASTCHANNEL__H__
@@ -9,13 +9,56 @@
 #ifndef __SGCT__MUTEXES__H__
 #define __SGCT__MUTEXES__H__
 
+#include <chrono>
 #include <mutex>
 
 namespace sgct::mutex {
 
-inline std::mutex DataSync;
 inline std::mutex Tracking;
 
 } // namespace sgct::mutex
 
+namespace sgct {
+
+/**
+ * A lock like std::unique_lock that adds the time the calling thread was blocked while
+ * acquiring the mutex to the lock wait time of that thread. An uncontended lock only
+ * costs a single try_lock, so this is used for the locks that the render thread takes
+ * every frame.
+ */
+class TimedLock {
+public:
+    explicit TimedLock(std::mutex& mutex);
+
+    /// \return the time in seconds that the calling thread waited for a TimedLock since
+    ///         the last call to this function
+    static double takeWaitTime();
+
+private:
+    std::unique_lock<std::mutex> _lock;
+
+    static inline thread_local double _waitTime = 0.0;
+};
+
+inline TimedLock::TimedLock(std::mutex& mutex)
+    : _lock(mutex, std::try_to_lock)
+{
+    if (_lock.owns_lock()) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point t0 = Clock::now();
+    _lock.lock();
+    _waitTime += std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+inline double TimedLock::takeWaitTime() {
+    const double res = _waitTime;
+    _waitTime = 0.0;
+    return res;
+}
+
+} // namespace sgct
+
 #endif // __SGCT__MUTEXES__H__
@@ -9,11 +9,15 @@
 #ifndef __SGCT__NETWORK__H__
 #define __SGCT__NETWORK__H__
 
+#include <sgct/datatransfercache.h>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
@@ -26,15 +30,28 @@
 
 namespace sgct {
 
-/// Network manages peer-to-peer tcp connections.
+class NetworkReactor;
+class SharedMemoryChannel;
+
+/**
+ * Network manages peer-to-peer tcp connections. Connections between two nodes on the same
+ * computer can use a shared memory channel instead of the TCP loopback connection.
+ */
 class Network {
 public:
-    // ASCII device control chars = 17, 18, 19 & 20
+    // ASCII control chars: ACK = 6, device controls = 17, 18, 19 & 20, NAK = 21,
+    // SYN = 22, ETB = 23, CAN = 24, EM = 25
     static constexpr const char DefaultId = 0;
     static constexpr const char Ack = 6;
     static constexpr const char DataId = 17;
     static constexpr const char ConnectedId = 18;
     static constexpr const char DisconnectId = 19;
+    static constexpr const char CompressedDataId = 20;
+    static constexpr const char Nack = 21;
+    static constexpr const char MulticastDataId = 22;
+    static constexpr const char DataChunkId = 23;
+    static constexpr const char TimeSyncId = 24;
+    static constexpr const char DataOfferId = 25;
 
     enum class ConnectionType { SyncConnection, ExternalConnection, DataTransfer };
 
@@ -45,11 +62,21 @@ public:
      * \param address is the hostname, IPv4 address or ip6 address
      * \param isServer indicates if this connection is a server or client
      * \param connectionType is the type of connection
+     * \param useSharedMemory if the messages are exchanged through a shared memory
+     *        channel, which requires both sides to run on the same computer
      */
-    Network(int port, std::string address, bool isServer, ConnectionType type);
+    Network(int port, std::string address, bool isServer, ConnectionType type,
+        bool useSharedMemory = false);
     ~Network();
 
-    void initialize();
+    /**
+     * Starts the communication for this connection. If a \p reactor is provided, the
+     * socket of this connection is switched to non-blocking mode and all reading is
+     * performed by the reactor's thread. Otherwise, a dedicated connection and
+     * communication thread are created for this connection. A shared memory connection
+     * is always read by a single thread of its own.
+     */
+    void initialize(NetworkReactor* reactor = nullptr);
     void closeNetwork(bool forced);
     void initShutdown();
 
@@ -59,6 +86,38 @@ public:
     void setConnectedFunction(std::function<void (void)> fn);
     void setAcknowledgeFunction(std::function<void(int, int)> fn);
 
+    /**
+     * Sets a function that is called with the header and the raw, potentially still
+     * compressed, payload of every sync message before it is decoded. This is used by
+     * relay nodes to pass the sync data on to their children with minimal delay.
+     */
+    void setForwardFunction(std::function<void(const char*, const char*, uint32_t)> fn);
+
+    /**
+     * Sets the function that a client uses to retrieve the multicast message with a
+     * specific session and sequence number. The function returns false if the message
+     * was not received, in which case it is requested from the server over this
+     * connection.
+     */
+    void setMulticastFunction(
+        std::function<bool(uint32_t, uint32_t, std::vector<char>&)> fn);
+
+    /**
+     * Sets the function that the server calls when a client requests a multicast message
+     * again. The parameters are the frame and the sequence number of the message.
+     */
+    void setNackFunction(std::function<void(int32_t, uint32_t)> fn);
+
+    /**
+     * Sets the function that the sender of a data transfer package calls when the
+     * receiver answered the offer of the package. The parameters are the package id and
+     * whether the receiver loaded the package from its cache instead.
+     */
+    void setOfferReplyFunction(std::function<void(int, bool)> fn);
+
+    /// Sets the cache that offered data transfer packages are looked up in and stored to
+    void setDataTransferCache(const DataTransferCache* cache);
+
     void setConnectedStatus(bool state);
     void setOptions(SGCT_SOCKET* socketPtr);
     void closeSocket(SGCT_SOCKET lSocket);
@@ -76,6 +135,9 @@ public:
     /// Get the time in seconds from send to receive of sync data.
     double loopTime() const;
 
+    /// \return the number of frames that were sent but not acknowledged yet
+    int framesInFlight() const;
+
     /**
      * This function compares the received frame number with the sent frame number. The
      * server starts by sending a frame sync number to the client. The client receives the
@@ -87,15 +149,41 @@ public:
     bool isUpdated() const;
     void sendData(const void* data, int length);
 
+    /**
+     * Sends the \p headerLength bytes of \p header followed by the \p length bytes of
+     * \p data with a single gather write, which avoids copying them into one buffer.
+     */
+    void sendData(const void* header, int headerLength, const void* data, int length);
+
+    /**
+     * Queues a small control message that is sent in front of the next message, or once
+     * all messages that have arrived on this connection have been handled. This lets
+     * the replies to several messages share a single system call and packet.
+     */
+    void queueData(const void* data, int length);
+
     /// \return last error code
     static int lastError();
+
+    /// \return the number of system calls that were made to send and receive messages
+    static uint64_t syscallCount();
+
     static int receiveData(SGCT_SOCKET& lsocket, char* buffer, int length, int flags);
 
     /// Iterates the send frame number and returns the new frame number
     int iterateFrameCounter();
 
-    /// The client sends ack message to server + console messages
-    void pushClientMessage();
+    /**
+     * The client sends the ack message for the current frame to the server. The \p size
+     * bytes of \p data are sent along with it and passed to the server's decode function.
+     */
+    void pushClientMessage(const char* data = nullptr, uint32_t size = 0);
+
+    /**
+     * The client requests the cluster time from the server to synchronize its clock. The
+     * request is queued and sent along with the next acknowledgement.
+     */
+    void sendTimeRequest();
 
     /// \return the port of this connection
     int port() const;
@@ -103,18 +191,109 @@ public:
     std::condition_variable& startConnectionConditionVar();
 
 private:
+    friend class NetworkReactor;
+
     void setRecvFrame(int i);
     void updateBuffer(std::vector<char>& buffer, uint32_t reqSize, uint32_t& currSize);
+
+    /// Receives exactly \p length bytes from the socket or the shared memory channel
+    int receive(char* buffer, int length);
+
+    /// Sends the queued control messages. The send mutex has to be locked
+    void flushQueuedData();
+
+    struct Buffer {
+        const char* data = nullptr;
+        size_t size = 0;
+    };
+
+    /**
+     * Writes the non-empty \p buffers in a single system call if possible. If the socket
+     * buffer cannot take the whole message at once, the rest is written by further calls.
+     * The send mutex has to be locked.
+     */
+    void writeBuffers(std::array<Buffer, 3> buffers);
+
+    /**
+     * Appends the \p n \p buffers to the data that is sent once the socket of a reactor
+     * is writable again. The send mutex has to be locked.
+     */
+    void queuePendingData(const Buffer* buffers, size_t n);
     int readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize,
         uint32_t& uncompressedDataSize);
     int readDataTransferMessage(char* header, int32_t& packageId, uint32_t& dataSize,
         uint32_t& uncompressedDataSize);
     int readExternalMessage();
 
+    /// Extracts the frame number or package id and the data sizes from a \p header
+    void parseHeader(const char* header, int32_t& id, uint32_t& dataSize,
+        uint32_t& uncompressedDataSize);
+
+    /**
+     * Handles a completely received message of a sync or data transfer connection.
+     *
+     * \return false if the connection was terminated by the message
+     */
+    bool processMessage(const char* header, int32_t packageId, uint32_t dataSize,
+        uint32_t uncompressedDataSize);
+
+    /**
+     * Returns the payload of the last received message. If the message was compressed,
+     * it is uncompressed into the uncompress buffer first and \p dataSize is updated to
+     * the size of the uncompressed data.
+     */
+    char* messagePayload(uint32_t& dataSize, uint32_t uncompressedDataSize);
+
+    /// Forwards and decodes the sync data in the receive buffer
+    void handleSyncData(const char* header, uint32_t dataSize,
+        uint32_t uncompressedDataSize);
+
+    /**
+     * Adds the chunk of the data transfer package \p packageId in the receive buffer to
+     * the package and decodes the package once it is complete. Every chunk is
+     * acknowledged to the sender, which limits the number of chunks in flight.
+     */
+    void handleDataChunk(int32_t packageId, uint32_t dataSize);
+
+    /**
+     * Answers the offer of the data transfer package \p packageId in the receive buffer.
+     * If the package is in the cache, it is decoded from there and the sender is told
+     * that it does not have to send the package.
+     */
+    void handleDataOffer(int32_t packageId, uint32_t dataSize);
+
+    /// Decodes the sync data of \p frame that was sent as the multicast \p sequence of
+    /// the master's \p session
+    void receiveMulticastMessage(int32_t frame, uint32_t session, uint32_t sequence);
+
+    /**
+     * Answers a time request of a client with the server's cluster time or adds the
+     * timestamps of a reply from the server to the cluster clock
+     */
+    void handleTimeSync(uint32_t dataSize);
+
+    /**
+     * Handles a chunk of received ASCII characters of an external connection.
+     *
+     * \return false if the connection was terminated by the message
+     */
+    bool processExternalMessage(int length);
+
     /// function to decode messages
     void communicationHandler();
     void connectionHandler();
 
+    /// Runs the communication of a shared memory connection until it is shut down
+    void sharedMemoryHandler();
+
+    /// Called by the reactor's thread whenever the registered socket is readable
+    void handleReadable();
+
+    /// Called by the reactor's thread when the socket can take more of the pending data
+    void handleWritable();
+    void acceptReactorConnection();
+    void closeReactorConnection();
+
     SGCT_SOCKET _socket;
     SGCT_SOCKET _listenSocket;
 
@@ -129,6 +308,7 @@ private:
     std::atomic_bool _shouldTerminate = false; // set to true upon exit
 
     mutable std::mutex _connectionMutex;
+    std::mutex _sendMutex;
     std::unique_ptr<std::thread> _commThread;
     std::unique_ptr<std::thread> _mainThread;
 
@@ -142,7 +322,48 @@ private:
 
     std::vector<char> _recvBuffer;
     std::vector<char> _uncompressBuffer;
+    std::vector<char> _multicastBuffer;
+
+    /// Control messages that are sent along with the next message; guarded by the send
+    /// mutex
+    std::vector<char> _queuedData;
+    std::atomic_bool _hasQueuedData = false;
+
+    /// Data that the non-blocking socket of a reactor did not take yet, starting at the
+    /// offset; guarded by the send mutex
+    std::vector<char> _pendingData;
+    size_t _pendingOffset = 0;
+    /// Notified when the pending data was sent or dropped
+    std::condition_variable_any _pendingCond;
+
+    /// The data transfer packages that are currently received in chunks
+    struct IncomingPackage {
+        std::vector<char> data;
+        uint32_t nReceived = 0;
+        /// The key of the package if it was offered and should be stored in the cache
+        std::optional<DataTransferCache::Key> key;
+    };
+    std::map<int32_t, IncomingPackage> _incomingPackages;
+    const DataTransferCache* _dataTransferCache = nullptr;
     char _headerId = 0;
+    std::string _extBuffer; // for external communication
+
+    /// The reactor that is reading from this connection or nullptr if this connection
+    /// uses its own blocking communication thread
+    NetworkReactor* _reactor = nullptr;
+
+    /// The channel that replaces the socket if both nodes are on the same computer
+    std::unique_ptr<SharedMemoryChannel> _sharedMemory;
+
+    /// Progress of the incrementally parsed message when running on a reactor
+    struct {
+        std::array<char, HeaderSize> header = {};
+        uint32_t headerBytes = 0;
+        uint32_t dataBytes = 0;
+        uint32_t dataSize = 0;
+        uint32_t uncompressedDataSize = 0;
+        int32_t packageId = -1;
+    } _reactorState;
 
     std::condition_variable _startConnectionCond;
 
@@ -151,6 +372,10 @@ private:
     std::function<void(Network*)> _updateCallback;
     std::function<void(void)> _connectedCallback;
     std::function<void(int, int)> _acknowledgeCallback;
+    std::function<void(const char*, const char*, uint32_t)> _forwardCallback;
+    std::function<bool(uint32_t, uint32_t, std::vector<char>&)> _multicastCallback;
+    std::function<void(int32_t, uint32_t)> _nackCallback;
+    std::function<void(int, bool)> _offerReplyCallback;
 };
 
 } // namespace sgct
@@ -10,9 +10,13 @@
 #define __SGCT__NETWORKMANAGER__H__
 
 #include <sgct/network.h>
+#include <sgct/syncbarrier.h>
+#include <array>
 #include <atomic>
-#include <condition_variable>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>
@@ -20,7 +24,12 @@
 
 namespace sgct {
 
+class DataTransferCache;
+class DataTransferDecoder;
+class DataTransferQueue;
+class MulticastChannel;
 class Network;
+class NetworkReactor;
 
 /// The network manager manages all network connections for SGCT.
 class NetworkManager {
@@ -28,16 +37,30 @@ public:
     enum class SyncMode { SendDataToClients = 0, Acknowledge };
     enum class NetworkMode { Remote = 0, LocalServer, LocalClient };
 
+    /// The timings of a frame in seconds that a node reports to the master
+    struct NodeTiming {
+        int32_t node = -1;
+        /// The frame that the timings belong to, counted like the swap times
+        int32_t frame = -1;
+        float frameTime = 0.f;
+        float drawTime = 0.f;
+        float decodeTime = 0.f;
+        float syncTime = 0.f;
+        float swapTime = 0.f;
+    };
+
     static NetworkManager& instance();
     static void create(NetworkMode nm,
         std::function<void(const char*, int)> externalDecode,
         std::function<void(bool)> externalStatus,
         std::function<void(void*, int, int, int)> dataTransferDecode,
         std::function<void(bool, int)> dataTransferStatus,
-        std::function<void(int, int)> dataTransferAcknowledge);
+        std::function<void(int, int)> dataTransferAcknowledge,
+        std::function<void(int, int, float)> dataTransferProgress);
     static void destroy();
 
-    static std::condition_variable cond;
+    /// Notified by the connections whenever a sync message or connection change arrived
+    static SyncBarrier barrier;
 
     ~NetworkManager();
 
@@ -58,6 +81,44 @@ public:
      */
     bool isSyncComplete() const;
 
+    /**
+     * Sets the cluster time at which this node swapped its buffers for the last time. The
+     * clients report this time to the master with their next acknowledgement.
+     */
+    void setSwapTime(double time);
+
+    /**
+     * Returns the difference between the earliest and the latest swap of the previous
+     * frame across the cluster in seconds. This is only available on the master after
+     * the acknowledgements of the current frame have been received.
+     */
+    std::optional<double> swapSkew();
+
+    /**
+     * Sets the timings of the last frame that this node swapped. A client reports them to
+     * the master with its next acknowledgement; the node and frame are filled in here.
+     */
+    void setNodeTiming(NodeTiming timing);
+
+    /**
+     * Replaces the content of \p timings with the timings that the nodes of the cluster
+     * reported since the last call, including the ones of this node. This is only
+     * available on the master.
+     */
+    void nodeTimings(std::vector<NodeTiming>& timings);
+
+    /**
+     * When rendering ahead, a client queues the sync data of the frames that it receives
+     * and decodes them in order with this function before it acknowledges the frame.
+     *
+     * \return the time in seconds that the decoded frame was queued or nullopt if no
+     *         frame was decoded
+     */
+    std::optional<double> decodeQueuedFrame();
+
+    /// \return the largest number of frames that a client has not acknowledged yet
+    int framesInFlight() const;
+
     bool matchesAddress(std::string_view address) const;
 
     /// Retrieve the node id if this node is part of the cluster configuration
@@ -65,9 +126,20 @@ public:
     bool isRunning() const;
     bool areAllNodesConnected() const;
     Network* externalControlConnection();
+
+    /**
+     * Queues the \p length bytes of \p data to be sent as the package \p packageId to
+     * all connected data transfer connections and returns immediately. The data is
+     * copied, so the buffer can be reused as soon as this function returns.
+     */
     void transferData(const void* data, int length, int packageId);
+
+    /// Queues the package \p packageId to be sent to a single \p connection
     void transferData(const void* data, int length, int packageId, Network& connection);
 
+    /// Queues the package \p packageId without copying the \p data
+    void transferData(std::vector<char> data, int packageId);
+
     unsigned int activeConnectionsCount() const;
     int connectionsCount() const;
     int syncConnectionsCount() const;
@@ -79,14 +151,45 @@ private:
         std::function<void(bool)> externalStatus,
         std::function<void(void*, int, int, int)> dataTransferDecode,
         std::function<void(bool, int)> dataTransferStatus,
-        std::function<void(int, int)> dataTransferAcknowledge);
+        std::function<void(int, int)> dataTransferAcknowledge,
+        std::function<void(int, int, float)> dataTransferProgress);
 
     void addConnection(int port, std::string address,
         Network::ConnectionType connectionType = Network::ConnectionType::SyncConnection);
+    void addConnection(int port, std::string address,
+        Network::ConnectionType connectionType, bool isServer);
     void updateConnectionStatus(Network* connection);
     void setAllNodesConnected();
-    void prepareTransferData(const void* data, std::vector<char>& buffer, int& length,
-        int packageId);
+
+    /// Updates the connected status of a client and, if this client is a relay, informs
+    /// its children once the parent and all children are connected
+    void updateClientConnectedStatus();
+
+    /// Passes a sync message that a relay received from its parent on to its children
+    void forwardSyncMessage(const char* header, const char* data, uint32_t dataSize);
+
+    /// Sends the shared data to the multicast group and returns its sequence number
+    uint32_t sendMulticastMessage();
+
+    /// Sends a multicast message that a client did not receive over its connection
+    void retransmitMulticastMessage(Network& connection, int32_t frame,
+        uint32_t sequence);
+
+    /// Sets up a new data transfer connection to decode and acknowledge the packages
+    void setupDataTransferConnection(Network& connection);
+
+    /// Adds the sync data of a frame that was received ahead of time to the queue
+    void queueFrame(const char* data, int length);
+
+    /// Sets up a connection to a child node to receive the swap times that it reports
+    void setupSwapReportConnection(Network& connection);
+
+    /**
+     * Returns the earliest and latest swap time of the \p frame of this node and the
+     * swap times of the \p frame that the children reported since the last call. The
+     * swap report mutex has to be locked when calling this function.
+     */
+    std::optional<std::pair<double, double>> swapRange(int32_t frame);
 
     static NetworkManager* _instance;
 
@@ -95,6 +198,7 @@ private:
     std::function<void(void*, int, int, int)> _dataTransferDecodeFn;
     std::function<void(bool, int)> _dataTransferStatusFn;
     std::function<void(int, int)> _dataTransferAcknowledgeFn;
+    std::function<void(int, int, float)> _dataTransferProgressFn;
 
     // This could be a std::vector<Network>, but Network is not move-constructible
     // because of the std::condition_variable in it
@@ -103,15 +207,96 @@ private:
     std::vector<Network*> _dataTransferConnections;
     Network* _externalControlConnection = nullptr;
 
+    /// The sync connection to the master or relay that sends the sync data to this client
+    Network* _parentConnection = nullptr;
+
+    /// If this is set, all connections are served by this reactor instead of their own
+    /// communication threads
+    std::unique_ptr<NetworkReactor> _reactor;
+
+    /// If this is set, the sync data is sent to all clients at once through this channel
+    /// and the sync connections only carry the frame numbers and acknowledgements
+    std::unique_ptr<MulticastChannel> _multicastChannel;
+
+    /// Sends the data transfer packages without blocking the calling thread
+    std::unique_ptr<DataTransferQueue> _dataTransferQueue;
+
+    /// Decodes the received data transfer packages if the network reactor is used
+    std::unique_ptr<DataTransferDecoder> _dataTransferDecoder;
+
+    /// If this is set, received data transfer packages are cached in this directory
+    std::unique_ptr<DataTransferCache> _dataTransferCache;
+    uint32_t _multicastSequence = 0;
+
+    /// The last multicast messages that can be requested again by clients. There is one
+    /// message for every frame that can be in flight with the render-ahead setting
+    struct MulticastMessage {
+        uint32_t sequence = 0;
+        std::vector<char> data;
+    };
+    std::vector<MulticastMessage> _multicastHistory;
+    std::mutex _multicastMutex;
+
+    /// The earliest and latest swap time of a frame in the subtree that a child reported
+    struct SwapReport {
+        int32_t frame = -1;
+        double earliest = 0.0;
+        double latest = 0.0;
+        bool isValid = false;
+    };
+    std::vector<SwapReport> _swapReports;
+
+    /// The last swap times of this node, which are kept for a few frames as the reports
+    /// of the clients can lag behind when rendering ahead
+    struct SwapTime {
+        int32_t frame = -1;
+        double time = 0.0;
+    };
+    std::array<SwapTime, 16> _swapTimes;
+    size_t _nSwapTimes = 0;
+
+    /// The latest timings of this node and the nodes in its subtree indexed by the node
+    /// id. Entries that were already reported have their node set to -1
+    std::vector<NodeTiming> _nodeTimings;
+    std::vector<char> _acknowledgeData;
+    std::mutex _swapReportMutex;
+
+    /// The sync data of the frames that a client received but has not rendered yet. The
+    /// network thread is the only producer and the render thread the only consumer, so
+    /// the frames are handed over through a ring without locking. The buffers of the
+    /// slots are kept to be reused for the next frames
+    struct QueuedFrame {
+        std::vector<char> data;
+        double arrivalTime = 0.0;
+    };
+    std::vector<QueuedFrame> _frameQueue;
+    std::atomic<uint32_t> _frameQueueHead = 0; // number of frames that were queued
+    std::atomic<uint32_t> _frameQueueTail = 0; // number of frames that were decoded
+
+    /// The number of frames that the master may send before they are acknowledged
+    int _renderAhead = 0;
+
+    /// The local time at which this client last requested the cluster time
+    double _lastTimeRequest = -std::numeric_limits<double>::max();
+
     std::vector<std::string> _localAddresses; // stores this computers ip addresses
 
     bool _isServer = true;
-    bool _isRunning = true;
-    bool _allNodesConnected = false;
+    bool _isRelay = false;
+    std::atomic_bool _isRunning = true;
+    std::atomic_bool _allNodesConnected = false;
+    std::atomic_bool _isParentConnected = false;
+
+    /// The last frame of the parent that a relay has passed on to its children
+    std::atomic<int32_t> _forwardedFrame = -1;
     const NetworkMode _mode;
-    unsigned int _nActiveConnections = 0;
-    unsigned int _nActiveSyncConnections = 0;
-    unsigned int _nActiveDataTransferConnections = 0;
+    std::atomic<unsigned int> _nActiveConnections = 0;
+    std::atomic<unsigned int> _nActiveSyncConnections = 0;
+    std::atomic<unsigned int> _nActiveDataTransferConnections = 0;
+
+    /// Guards the lists of connections, which are rebuilt while the threads of the
+    /// previously added connections might already update the connection status
+    mutable std::mutex _connectionsMutex;
 };
 
 } // namespace sgct
@@ -0,0 +1,68 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__NETWORKREACTOR__H__
+#define __SGCT__NETWORKREACTOR__H__
+
+#include <sgct/network.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace sgct {
+
+/**
+ * The network reactor owns a single thread that waits for incoming data on the
+ * non-blocking sockets of all registered connections. Instead of each connection blocking
+ * in its own communication thread, the reactor dispatches to a connection whenever its
+ * socket becomes readable and the connection then parses as many messages as are
+ * available. Messages that the reactor's thread sends and that do not fit into a
+ * socket's buffer are sent by the reactor once the socket becomes writable, so the
+ * reactor never waits for a slow receiver. This is currently only supported on Linux as
+ * it is based on epoll.
+ */
+class NetworkReactor {
+public:
+    /// \return true if the reactor is supported on the current operating system
+    static bool isSupported();
+
+    NetworkReactor();
+    ~NetworkReactor();
+
+    /**
+     * Registers the \p socket with the reactor. The \p connection will be notified
+     * whenever the socket becomes readable. Only one socket per connection can be
+     * registered at a time.
+     */
+    void add(SGCT_SOCKET socket, Network& connection);
+
+    /// Removes the \p socket from the reactor. Closed sockets are removed automatically
+    void remove(SGCT_SOCKET socket);
+
+    /**
+     * Sets whether the \p connection of the registered \p socket is also notified when
+     * the socket becomes writable. This is used while the connection has data that the
+     * socket could not take without blocking.
+     */
+    void watchWritable(SGCT_SOCKET socket, Network& connection, bool state);
+
+    /// \return true if the calling thread is the reactor's thread
+    bool isReactorThread() const;
+
+private:
+    void run();
+
+    int _epoll = -1;
+    int _wakeup = -1;
+    std::atomic_bool _shouldTerminate = false;
+    std::unique_ptr<std::thread> _thread;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__NETWORKREACTOR__H__
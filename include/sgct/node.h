@@ -45,10 +45,17 @@ public:
     /// \return the data transfer port of this node
     int dataTransferPort() const;
 
+    /**
+     * \return the index of the node that relays the sync data to this node or -1 if this
+     *         node receives the sync data directly from the master
+     */
+    int parent() const;
+
 private:
     std::string _address;
     int _syncPort = 0;
     int _dataTransferPort = 0;
+    int _parent = -1;
 
     std::vector<std::unique_ptr<Window>> _windows;
     bool _useSwapGroups = false;
@@ -10,6 +10,7 @@
 #define __SGCT__PROFILING__H__
 
 #include <sgct/opengl.h>
+#include <cstddef>
 
 #ifdef WIN32
 #include <CodeAnalysis/warnings.h>
@@ -23,12 +24,12 @@
 #include <Tracy.hpp>
 #include <TracyOpenGL.hpp>
 
-#ifdef TRACY_ENABLE
+#if defined(TRACY_ENABLE) || defined(SGCT_HAS_ALLOCATION_COUNTER)
 
 void* operator new(size_t count);
 void operator delete(void* ptr) noexcept;
 
-#endif // TRACY_ENABLE
+#endif // TRACY_ENABLE || SGCT_HAS_ALLOCATION_COUNTER
 
 #ifdef WIN32
 #pragma warning(pop)
@@ -36,4 +37,18 @@ void operator delete(void* ptr) noexcept;
 #pragma GCC diagnostic pop
 #endif // WIN32
 
+// Without Tracy, the zones are passed to the built-in trace recorder instead
+#if defined(SGCT_HAS_TRACE_RECORDER) && !defined(TRACY_ENABLE)
+#include <sgct/tracerecorder.h>
+
+#undef ZoneScoped
+#undef ZoneScopedN
+#define SGCT_TRACE_CONCAT_IMPL(a, b) a##b
+#define SGCT_TRACE_CONCAT(a, b) SGCT_TRACE_CONCAT_IMPL(a, b)
+#define ZoneScoped \
+    sgct::TraceRecorder::Zone SGCT_TRACE_CONCAT(sgctTraceZone, __LINE__)(__FUNCTION__);
+#define ZoneScopedN(name) \
+    sgct::TraceRecorder::Zone SGCT_TRACE_CONCAT(sgctTraceZone, __LINE__)(name);
+#endif // SGCT_HAS_TRACE_RECORDER && !TRACY_ENABLE
+
 #endif // __SGCT__PROFILING__H__
@@ -22,6 +22,7 @@
 #include <sgct/node.h>
 #include <sgct/shadermanager.h>
 #include <sgct/shareddata.h>
+#include <sgct/sharedvariable.h>
 #include <sgct/texturemanager.h>
 
 #ifdef SGCT_HAS_TEXT
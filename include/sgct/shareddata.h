@@ -9,16 +9,25 @@
 #ifndef __SGCT__SHAREDDATA__H__
 #define __SGCT__SHAREDDATA__H__
 
-#include <sgct/mutexes.h>
 #include <sgct/network.h>
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace sgct {
 
+class SharedVariableBase;
+class SyncRecorder;
+
 /**
  * This class shares application data between nodes in a cluster where the master encodes
  * and transmits the data and the clients receives and decode the data.
@@ -32,26 +41,195 @@ public:
     void setDecodeFunction(
         std::function<void(const std::vector<std::byte>&, unsigned int)> function);
 
+    /**
+     * Sets a function that appends the shared data to the provided buffer. The buffer is
+     * owned by SGCT and reused between frames, so unlike the function set through
+     * setEncodeFunction, no memory is allocated or copied in the steady state. If both
+     * functions are set, this function is used.
+     */
+    void setEncodeInPlaceFunction(std::function<void(std::vector<std::byte>&)> function);
+
+    /**
+     * Sets a function that decodes the \p size bytes of shared data that the pointer
+     * points to. The pointer is only valid for the duration of the call. If both this
+     * function and the one set through setDecodeFunction are set, this function is used.
+     */
+    void setDecodeInPlaceFunction(
+        std::function<void(const std::byte*, size_t)> function);
+
+    /**
+     * Sets the functions that are used instead of the other decode functions if the
+     * cluster enables asynchronous decoding. The \p decodeFunction is called on the
+     * receiving thread as soon as a frame arrives, while the render thread might still be
+     * drawing the previous frame, so it has to write into a staging copy of the
+     * application state. The \p swapFunction is called on the render thread at the start
+     * of the frame that the data belongs to and should only exchange the staging and the
+     * current state, for example by swapping two pointers.
+     */
+    void setStagedDecodeFunctions(
+        std::function<void(const std::byte*, size_t)> decodeFunction,
+        std::function<void()> swapFunction);
+
+    /**
+     * Registers the \p variable so that its value is shared with all clients. The
+     * variables are encoded in front of the data of the encode function, which receives
+     * and decodes only its own data. The variable has to be registered on all nodes with
+     * the same id and has to stay alive until it is unregistered.
+     *
+     * While any variable is registered on the master, the vector that is passed to the
+     * function set through setDecodeFunction also contains the variables and its data
+     * starts at the position that is passed with it. Without registered variables, the
+     * vector contains only the data of the encode function and the position is 0.
+     */
+    void registerVariable(SharedVariableBase& variable);
+
+    /// Stops sharing the \p variable. Values for it received afterwards are ignored
+    void unregisterVariable(SharedVariableBase& variable);
+
     /// This fuction is called internally by SGCT and shouldn't be used by the user.
     void encode();
 
     /// This function is called internally by SGCT and shouldn't be used by the user.
     void decode(const char* receivedData, int receivedLength);
 
+    /// \return the time in seconds that it took to decode the last received frame
+    double lastDecodeTime() const;
+
+    /**
+     * Swaps in the state that was decoded asynchronously for the current frame. This
+     * function is called internally by SGCT and shouldn't be used by the user.
+     */
+    void applyStagedFrame();
+
+    /**
+     * \return true if the frame that arrived last was completely decoded into the
+     *         staging state or if decoding is not asynchronous
+     */
+    bool isStagedFrameReady() const;
+
+    /**
+     * Sets whether the frames are decoded into the staging state of the application on
+     * the receiving thread. This only has an effect if the staged decode functions are
+     * set. Disabling it wakes up a receiving thread that is waiting for the render thread
+     * to take the previous staged frame.
+     */
+    void setAsyncDecode(bool state);
+
+    /**
+     * Sets whether the encoded data should be compressed before it is sent to the
+     * clients. Payloads that are smaller than \p threshold bytes are always sent
+     * uncompressed as the compression would cost more time than it saves.
+     */
+    void setCompression(bool state, int threshold);
+
+    /**
+     * Sets whether the encoded data should be sent as a delta against the previous
+     * frame. Only the byte ranges that changed since the previous frame are sent and the
+     * clients reconstruct the full data before it is passed to the decode function. A
+     * full keyframe is sent every \p keyframeInterval frames.
+     */
+    void setDeltaEncoding(bool state, int keyframeInterval);
+
+    /**
+     * Forces the next encoded frame to be a keyframe. This function is called internally
+     * by SGCT whenever a client connects that has not received the previous frames.
+     */
+    void requestKeyframe();
+
+    /**
+     * Records all frames that are encoded from now on into the file at \p path, which
+     * can be replayed on a single node without a cluster. The recording starts with a
+     * keyframe so that it can be replayed with delta encoding enabled.
+     */
+    void startRecording(std::string path);
+
+    /// Stops the recording and closes its file
+    void stopRecording();
+
     unsigned char* dataBlock();
     int dataSize();
     int bufferSize();
 
 private:
+    enum class Encoding : uint8_t { Full = 0, Delta = 1 };
+    /// Set in the encoding of a frame whose data starts with the shared variables
+    static constexpr const uint8_t VariablesFlag = 0x80;
+
     SharedData();
 
+    /**
+     * Appends the delta between \p data and the previous frame to the data block.
+     *
+     * \return false if the delta would not be smaller than the full frame, in which case
+     *         nothing is appended
+     */
+    bool encodeDelta(const std::vector<std::byte>& data, bool hasVariables);
+
+    /**
+     * Appends the shared variables and the data of the encode function to the \p buffer.
+     * A keyframe contains all shared variables, other frames only the changed ones. The
+     * variables are only encoded if any are registered.
+     *
+     * \return true if the shared variables were encoded
+     */
+    bool encodeData(std::vector<std::byte>& buffer, bool isKeyframe);
+
+    /**
+     * Applies the shared variables at the beginning of the \p size bytes of \p data.
+     *
+     * \return the number of bytes that the variables occupied
+     */
+    size_t decodeVariables(const std::byte* data, size_t size, uint32_t frame);
+
+    /**
+     * Decodes the frame in the \p receivedLength bytes of \p receivedData.
+     *
+     * \return false if the frame was skipped as its reference frame is missing
+     */
+    bool decodeFrame(const char* receivedData, int receivedLength);
+
+    /// \return true if the frames are decoded into the staging state
+    bool isDecodeStaged() const;
+
     // function pointers
     std::function<std::vector<std::byte>()> _encodeFn;
     std::function<void(const std::vector<std::byte>&, unsigned int)> _decodeFn;
+    std::function<void(std::vector<std::byte>&)> _encodeInPlaceFn;
+    std::function<void(const std::byte*, size_t)> _decodeInPlaceFn;
+    std::function<void(const std::byte*, size_t)> _stagedDecodeFn;
+    std::function<void()> _swapFn;
 
     static SharedData* _instance;
     std::vector<std::byte> _dataBlock;
+    std::vector<std::byte> _compressedBlock;
     std::array<std::byte, Network::HeaderSize> _headerSpace;
+    std::unique_ptr<SyncRecorder> _recorder;
+    bool _useCompression = false;
+    int _compressionThreshold = 0;
+
+    /// The full data of the last frame that was encoded or decoded
+    std::vector<std::byte> _payload;
+    /// The data of the current frame while it is compared against the previous frame
+    std::vector<std::byte> _encodeBuffer;
+    uint32_t _frameNumber = 0;
+    bool _useDeltaEncoding = false;
+    int _keyframeInterval = 0;
+    int _framesSinceKeyframe = 0;
+    std::atomic_bool _forceKeyframe = true;
+    bool _hasKeyframe = false;
+
+    std::vector<SharedVariableBase*> _variables;
+    std::mutex _variablesMutex;
+
+    /// Whether a decoded frame is waiting for the render thread in the staging state
+    std::atomic_bool _isStagedFrameReady = false;
+    /// Whether the staged frame has to be swapped in, which is not the case if the frame
+    /// was skipped. Only written before the frame is marked as ready
+    bool _needsSwap = false;
+    std::atomic_bool _useAsyncDecode = false;
+    std::atomic<double> _lastDecodeTime = 0.0;
+    std::mutex _stagingMutex;
+    std::condition_variable _stagingCond;
 };
 
 template <typename T>
@@ -88,36 +266,46 @@ void serializeObject(std::vector<std::byte>& buffer, const std::string& value);
 void serializeObject(std::vector<std::byte>& buffer, const std::wstring& value);
 
 template <typename T>
-void deserializeObject(const std::vector<std::byte>& buffer, unsigned int& pos,
-                       T& value)
-{
+void deserializeObject(const std::byte* buffer, unsigned int& pos, T& value) {
     static_assert(std::is_pod_v<T>, "Type has to be a plain-old data type");
 
-    value = *reinterpret_cast<const T*>(&buffer[pos]);
+    std::memcpy(&value, buffer + pos, sizeof(T));
     pos += sizeof(T);
 }
 
 template <typename T>
-void deserializeObject(const std::vector<std::byte>& buffer, unsigned int& pos,
-                       std::vector<T>& value)
+void deserializeObject(const std::byte* buffer, unsigned int& pos, std::vector<T>& value)
 {
-    value.clear();
+    static_assert(std::is_pod_v<T>, "Type has to be a plain-old data type");
 
     uint32_t size;
-    deserializeObject<uint32_t>(buffer, pos, size);
-
-    if (size == 0) {
-        return;
-    }
+    deserializeObject(buffer, pos, size);
 
-    value.clear();
+    // assign reuses the capacity of the vector if the size has not grown
     value.assign(
-        reinterpret_cast<const T*>(buffer.data() + pos),
-        reinterpret_cast<const T*>(buffer.data() + pos + size * sizeof(T))
+        reinterpret_cast<const T*>(buffer + pos),
+        reinterpret_cast<const T*>(buffer + pos + size * sizeof(T))
     );
     pos += size * sizeof(T);
 }
 
+void deserializeObject(const std::byte* buffer, unsigned int& pos, std::string& value);
+void deserializeObject(const std::byte* buffer, unsigned int& pos, std::wstring& value);
+
+template <typename T>
+void deserializeObject(const std::vector<std::byte>& buffer, unsigned int& pos,
+                       T& value)
+{
+    deserializeObject(buffer.data(), pos, value);
+}
+
+template <typename T>
+void deserializeObject(const std::vector<std::byte>& buffer, unsigned int& pos,
+                       std::vector<T>& value)
+{
+    deserializeObject(buffer.data(), pos, value);
+}
+
 template <>
 void deserializeObject(const std::vector<std::byte>& buffer, unsigned int& pos,
     std::string& value);
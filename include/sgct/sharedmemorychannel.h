@@ -0,0 +1,100 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__SHAREDMEMORYCHANNEL__H__
+#define __SGCT__SHAREDMEMORYCHANNEL__H__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace sgct {
+
+/**
+ * A connection between two node processes on the same computer that replaces the TCP
+ * loopback connection. The server creates a shared memory segment named after the port
+ * of the connection that contains one ring buffer for each direction. Each ring has a
+ * single producer and a single consumer, so writing a message only copies it into the
+ * ring and publishes the new write position; a futex wake is only issued if the other
+ * side is blocked waiting for data. The channel is a byte stream just like the TCP
+ * connection, so the messages are framed by the headers of the Network class. This is
+ * currently only supported on Linux as it is based on futexes.
+ */
+class SharedMemoryChannel {
+public:
+    /// \return true if the channel is supported on the current operating system
+    static bool isSupported();
+
+    /// \return the number of futex system calls that all channels have made
+    static uint64_t syscallCount();
+
+    /**
+     * Creates the shared memory segment for the \p port if this is the server side. The
+     * client side only opens the segment once connect is called.
+     */
+    SharedMemoryChannel(int port, bool isServer);
+    ~SharedMemoryChannel();
+
+    /**
+     * Waits on the server side until a client has connected to the channel.
+     *
+     * \return false if the channel was closed before a client connected
+     */
+    bool accept();
+
+    /**
+     * Tries to connect the client side to the segment of the server.
+     *
+     * \return false if the server has not created the segment yet
+     */
+    bool connect();
+
+    /// Resets the rings on the server side so that a new client can connect
+    void reset();
+
+    /**
+     * Copies the \p size bytes of \p data into the ring buffer to the other side and
+     * blocks while the ring is full. If \p shouldNotify is false, a blocked receiver is
+     * not woken up unless the ring is full, which is used to write the parts of a message
+     * with a single wake up.
+     *
+     * \return false if the channel was closed or the other process terminated
+     */
+    bool send(const void* data, uint32_t size, bool shouldNotify = true);
+
+    /**
+     * Blocks until \p size bytes were received and copies them into \p buffer.
+     *
+     * \return false if the channel was closed or the other process terminated
+     */
+    bool receive(char* buffer, uint32_t size);
+
+    /// Wakes up and terminates all calls that are blocked on this channel
+    void close();
+
+private:
+    struct Segment;
+    struct Ring;
+
+    /**
+     * Blocks until \p word has changed from \p value. The wait is interrupted
+     * regularly to detect if the other process terminated without closing the channel.
+     *
+     * \return false if the channel was closed or the other process terminated
+     */
+    bool wait(std::atomic<uint32_t>& word, uint32_t value);
+
+    const std::string _name;
+    const bool _isServer;
+    Segment* _segment = nullptr;
+    std::atomic_bool _isClosed = false;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__SHAREDMEMORYCHANNEL__H__
@@ -0,0 +1,182 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__SHAREDVARIABLE__H__
+#define __SGCT__SHAREDVARIABLE__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * The type-independent part of a shared variable that is used by the SharedData to
+ * encode and decode the registered variables. See SharedVariable for the details.
+ */
+class SharedVariableBase {
+public:
+    explicit SharedVariableBase(uint32_t id) : _id(id) {}
+    virtual ~SharedVariableBase() = default;
+
+    /// Returns the identifier that is used to match the variable across the nodes
+    uint32_t id() const { return _id; }
+
+    /// Returns whether the value has changed since the variable was last encoded
+    bool isDirty() const { return _isDirty; }
+
+private:
+    friend class SharedData;
+
+    /// Appends the raw bytes of the value to the \p buffer and clears the dirty flag
+    virtual void encode(std::vector<std::byte>& buffer) = 0;
+
+    /**
+     * Replaces the value with the \p size bytes of \p data and calls the change callback
+     * if the value changed.
+     *
+     * \return false if the \p size does not fit the type of the variable
+     */
+    virtual bool decode(const std::byte* data, uint32_t size) = 0;
+
+    const uint32_t _id;
+
+protected:
+    /// Starts out dirty as the clients might have been initialized with another value
+    std::atomic_bool _isDirty = true;
+};
+
+/**
+ * A value that is shared from the master to all clients without having to be serialized
+ * by the encode and decode callbacks. The variable has to be registered with
+ * SharedData::registerVariable and is identified by an \p id that has to be the same on
+ * all nodes. The master only sends a variable in the frames after its value was changed
+ * as well as in every keyframe, so unchanged state costs nothing on the network and no
+ * decoding work on the clients. The supported types are plain-old data types, vectors of
+ * plain-old data types, and std::string.
+ *
+ * The value is updated from the network thread on the clients, so it is only accessed
+ * by copy through value() and setValue().
+ */
+template <typename T>
+class SharedVariable : public SharedVariableBase {
+public:
+    SharedVariable(uint32_t id, T value = T())
+        : SharedVariableBase(id)
+        , _value(std::move(value))
+    {
+        static_assert(
+            std::is_pod_v<T> || std::is_same_v<T, std::string> || IsPodVector<T>::value,
+            "Type has to be a plain-old data type, a vector of them, or a string"
+        );
+    }
+
+    T value() const {
+        std::unique_lock lock(_mutex);
+        return _value;
+    }
+
+    /// Sets the value and marks the variable as changed if it differs from the old one
+    void setValue(T value) {
+        std::unique_lock lock(_mutex);
+        // Plain-old data structs do not necessarily provide a comparison operator
+        bool isEqual = false;
+        if constexpr (std::is_pod_v<T>) {
+            isEqual = std::memcmp(&value, &_value, sizeof(T)) == 0;
+        }
+        else {
+            isEqual = value == _value;
+        }
+        if (!isEqual) {
+            _value = std::move(value);
+            _isDirty = true;
+        }
+    }
+
+    /**
+     * Sets a function that is called on the clients when a value that differs from the
+     * current one is received. The function is called from the network thread.
+     */
+    void setChangeCallback(std::function<void(const T&)> callback) {
+        std::unique_lock lock(_mutex);
+        _changeCallback = std::move(callback);
+    }
+
+private:
+    template <typename U> struct IsPodVector : std::false_type {};
+    template <typename U> struct IsPodVector<std::vector<U>> :
+        std::bool_constant<std::is_pod_v<U> && !std::is_same_v<U, bool>> {};
+
+    void encode(std::vector<std::byte>& buffer) override {
+        std::unique_lock lock(_mutex);
+        _isDirty = false;
+
+        const std::byte* p = nullptr;
+        size_t size = 0;
+        if constexpr (std::is_pod_v<T>) {
+            p = reinterpret_cast<const std::byte*>(&_value);
+            size = sizeof(T);
+        }
+        else {
+            p = reinterpret_cast<const std::byte*>(_value.data());
+            size = _value.size() * sizeof(typename T::value_type);
+        }
+        buffer.insert(buffer.end(), p, p + size);
+    }
+
+    bool decode(const std::byte* data, uint32_t size) override {
+        std::unique_lock lock(_mutex);
+        if constexpr (std::is_pod_v<T>) {
+            if (size != sizeof(T)) {
+                return false;
+            }
+            if (std::memcmp(&_value, data, sizeof(T)) == 0) {
+                return true;
+            }
+            std::memcpy(&_value, data, sizeof(T));
+        }
+        else {
+            using V = typename T::value_type;
+            if (size % sizeof(V) != 0) {
+                return false;
+            }
+            const size_t count = size / sizeof(V);
+            if (count == _value.size() &&
+                (size == 0 || std::memcmp(_value.data(), data, size) == 0))
+            {
+                return true;
+            }
+            // resize reuses the capacity of the value if it has not grown
+            _value.resize(count);
+            std::memcpy(_value.data(), data, size);
+        }
+
+        if (_changeCallback) {
+            // The callback is called without the lock so that it can access the variable
+            const T value = _value;
+            const std::function<void(const T&)> callback = _changeCallback;
+            lock.unlock();
+            callback(value);
+        }
+        return true;
+    }
+
+    mutable std::mutex _mutex;
+    T _value;
+    std::function<void(const T&)> _changeCallback;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__SHAREDVARIABLE__H__
@@ -0,0 +1,142 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__STAGETIMINGS__H__
+#define __SGCT__STAGETIMINGS__H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * Measures the CPU time that the render thread spends in each stage of the render loop.
+ * Every stage keeps the times of its last frames in a ring buffer and counts all times
+ * in a histogram with logarithmic buckets, from which the percentiles of the whole run
+ * are estimated to within about 10%. The render thread is the only writer and publishes
+ * each value with an atomic counter, so a snapshot can be taken from any thread without
+ * blocking the render loop. A snapshot that overlaps with a frame might contain the
+ * values of that frame for some of the stages only. While the AllocationCounter is
+ * enabled, the heap allocations of the render thread are attributed to the stages, too.
+ */
+class StageTimings {
+public:
+    static constexpr const int HistoryLength = 1024;
+    static constexpr const int BucketCount = 96;
+
+    enum class Stage {
+        PollEvents = 0,
+        PreSync,
+        Encode,
+        FrameLockPreStage,
+        PostSyncPreDraw,
+        PostDraw,
+        FrameLockPostStage,
+        Swap
+    };
+
+    /// The stages that exist once for each window of the node
+    enum class WindowStage { Cubemaps = 0, Viewports, Warp };
+
+    struct Snapshot {
+        std::string name;
+        /// The number of frames in which the stage was measured
+        uint64_t count = 0;
+        /// The values of this struct are in seconds
+        double last = 0.0;
+        /// The mean, minimum and maximum of the frames in the history
+        double mean = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        /// The percentiles of all frames since the start
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        /// The times of the frames in the history, starting with the oldest one
+        std::vector<float> history;
+        /// The number of heap allocations in the last frame and since the start
+        uint64_t allocations = 0;
+        uint64_t totalAllocations = 0;
+    };
+
+    /**
+     * Measures the time between its creation and destruction. A stage that is measured
+     * several times in a frame, for example once per eye, is recorded as the sum of all
+     * measurements at the end of the frame.
+     */
+    class Scope {
+    public:
+        Scope(StageTimings& timings, Stage stage);
+        Scope(StageTimings& timings, int window, WindowStage stage);
+        ~Scope();
+
+    private:
+        StageTimings& _timings;
+        const int _stage;
+        const std::chrono::steady_clock::time_point _start;
+        const uint64_t _startAllocations;
+    };
+
+    /// Creates the stages of the render loop and the stages of \p nWindows windows
+    explicit StageTimings(int nWindows);
+    ~StageTimings();
+
+    /**
+     * Records the times that were measured during the frame for all stages that were
+     * measured and exports the snapshots if the export interval has passed. This has to
+     * be called by the render thread at the end of each frame.
+     */
+    void endFrame();
+
+    /// \return the current snapshot of all stages, which can be called from any thread
+    std::vector<Snapshot> snapshot() const;
+
+    /**
+     * Appends the snapshot of all stages to the file at \p path every \p interval
+     * seconds and at the end of the run. The file is written as JSON with one object per
+     * line if its extension is json and as CSV otherwise.
+     */
+    void exportTo(const std::string& path, double interval);
+
+private:
+    struct Data {
+        std::string name;
+        std::array<std::atomic<float>, HistoryLength> history = {};
+        std::array<std::atomic<uint64_t>, BucketCount> buckets = {};
+        std::atomic<uint64_t> count = 0;
+        std::atomic<uint64_t> lastAllocations = 0;
+        std::atomic<uint64_t> totalAllocations = 0;
+
+        /// The time measured during the current frame, only used by the render thread
+        double current = 0.0;
+        uint64_t currentAllocations = 0;
+        bool isMeasured = false;
+    };
+
+    void add(int stage, double time, uint64_t nAllocations);
+    void writeSnapshot();
+
+    std::vector<std::unique_ptr<Data>> _stages;
+    const int _nGlobalStages;
+
+    std::ofstream _exportFile;
+    bool _isJson = false;
+    double _exportInterval = 0.0;
+    std::chrono::steady_clock::time_point _exportStart;
+    std::chrono::steady_clock::time_point _lastExport;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__STAGETIMINGS__H__
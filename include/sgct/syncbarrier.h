@@ -0,0 +1,76 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__SYNCBARRIER__H__
+#define __SGCT__SYNCBARRIER__H__
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace sgct {
+
+/**
+ * The barrier that the render thread waits on for the sync messages of a frame. The
+ * waiting thread passes the condition it is waiting for, and the network threads call
+ * notify whenever a message arrived that could complete the condition. The condition is
+ * evaluated on the notifying thread, so the waiting thread is only woken up when it can
+ * actually continue. Only a single thread may wait on the barrier at a time.
+ */
+class SyncBarrier {
+public:
+    /**
+     * Waits until \p isComplete returns true. The condition is polled for the
+     * \p spinTime first, which avoids the latency of being woken up by the operating
+     * system if the condition is completed shortly, before the thread blocks.
+     *
+     * \return false if the condition was not completed within the \p timeout
+     */
+    template <typename Predicate>
+    bool wait(Predicate isComplete, std::chrono::microseconds spinTime,
+              std::chrono::microseconds timeout);
+
+    /// Wakes up the waiting thread if its condition is complete
+    void notify();
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cond;
+
+    /// The condition of the waiting thread or empty if no thread is blocked
+    std::function<bool()> _isComplete;
+};
+
+template <typename Predicate>
+bool SyncBarrier::wait(Predicate isComplete, std::chrono::microseconds spinTime,
+                       std::chrono::microseconds timeout)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point t0 = Clock::now();
+
+    while (Clock::now() - t0 < spinTime) {
+        if (isComplete()) {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+
+    // The notifying thread changes the state before it takes the lock, so the condition
+    // cannot be completed between the check and the wait without waking this thread
+    std::unique_lock lock(_mutex);
+    _isComplete = std::ref(isComplete);
+    const bool res = _cond.wait_until(lock, t0 + timeout, std::ref(isComplete));
+    _isComplete = nullptr;
+    return res;
+}
+
+} // namespace sgct
+
+#endif // __SGCT__SYNCBARRIER__H__
@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__SYNCRECORDING__H__
+#define __SGCT__SYNCRECORDING__H__
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace sgct {
+
+/**
+ * Records the shared data frames that the master encodes into an append-only file. Each
+ * frame is stored uncompressed with its frame number and the cluster time at which it
+ * was encoded, so that the recording can be replayed by the SyncPlayer without a
+ * cluster. The file is memory mapped and grows in large steps, so recording a frame only
+ * copies it into the mapping. As the frames are written straight into the file, the
+ * frames recorded before a crash can still be replayed.
+ */
+class SyncRecorder {
+public:
+    /// Creates the recording at \p path, replacing an existing file
+    explicit SyncRecorder(std::string path);
+    ~SyncRecorder();
+
+    /// Appends the \p size bytes of \p data as the frame \p frame encoded at \p time
+    void record(uint32_t frame, double time, const std::byte* data, size_t size);
+
+    /// \return the number of frames that have been recorded
+    uint64_t nFrames() const;
+
+private:
+    /// Resizes the file to \p capacity bytes and maps it again
+    void resize(size_t capacity);
+
+    /// Unmaps the file and closes it after cutting off the part that was not used
+    void closeFile();
+
+    const std::string _path;
+#ifdef WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#else // WIN32
+    int _file = -1;
+#endif // WIN32
+    std::byte* _data = nullptr;
+    size_t _size = 0;
+    size_t _capacity = 0;
+    uint64_t _nFrames = 0;
+};
+
+/**
+ * Reads back the frames of a recording made by the SyncRecorder. The whole file is
+ * memory mapped, so the frames are passed on without copying them.
+ */
+class SyncPlayer {
+public:
+    struct Frame {
+        uint32_t number = 0;
+        /// The cluster time at which the master encoded the frame
+        double time = 0.0;
+        /// The data as it is passed to SharedData::decode, valid as long as the player
+        const char* data = nullptr;
+        int size = 0;
+    };
+
+    /// Opens the recording at \p path
+    explicit SyncPlayer(std::string path);
+    ~SyncPlayer();
+
+    /// \return the next frame of the recording or an empty optional at its end
+    std::optional<Frame> next();
+
+private:
+    /// Unmaps and closes the file
+    void closeFile();
+
+    const std::string _path;
+#ifdef WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#else // WIN32
+    int _file = -1;
+#endif // WIN32
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+    size_t _position = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__SYNCRECORDING__H__
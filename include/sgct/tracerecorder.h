@@ -0,0 +1,86 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__TRACERECORDER__H__
+#define __SGCT__TRACERECORDER__H__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace sgct {
+
+/**
+ * Records the profiling zones of all threads so that they can be written to a file in
+ * the Chrome trace format, which can be opened in chrome://tracing or Perfetto. If SGCT
+ * is built with the trace recorder and without Tracy, the ZoneScoped and ZoneScopedN
+ * macros create a Zone. A zone does nothing but check a flag while the recording is
+ * disabled. Otherwise, each thread writes its zones into its own ring buffer that keeps
+ * the latest zones, so recording never blocks and a dump contains the last few seconds.
+ * The buffer of a thread that has ended is reused by the next thread that records.
+ */
+class TraceRecorder {
+public:
+    /// The number of zones that are kept for each thread
+    static constexpr const uint64_t BufferSize = 1 << 16;
+
+    /// Records the time between its creation and destruction as a complete event
+    class Zone {
+    public:
+        explicit Zone(const char* name)
+            : _name(name)
+            , _start(_isEnabled.load(std::memory_order_relaxed) ? now() : -1)
+        {}
+
+        ~Zone() {
+            if (_start >= 0) {
+                record(_name, _start);
+            }
+        }
+
+    private:
+        const char* _name;
+        const int64_t _start;
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /// Sets the frame number that is attached to the zones that end from now on
+    static void setFrameNumber(uint64_t frame);
+
+    /**
+     * Requests that the recording is written to a file at the end of the current frame.
+     * This only sets a flag, so it can be called from a signal handler.
+     */
+    static void requestDump();
+
+    /// \return true if a dump was requested since the last call, resetting the request
+    static bool takeDumpRequest();
+
+    /**
+     * Writes the zones that all threads recorded into the file at \p path. The events of
+     * this node use the \p node as the process id and the cluster time as the timestamp,
+     * so the files of all nodes can be merged by concatenating their event arrays. Each
+     * event also carries the frame number during which it ended.
+     */
+    static void dump(const std::string& path, int node);
+
+private:
+    /// \return the current time in nanoseconds of the steady clock
+    static int64_t now();
+    static void record(const char* name, int64_t start);
+
+    static inline std::atomic_bool _isEnabled = false;
+    static inline std::atomic_bool _isDumpRequested = false;
+    static inline std::atomic<uint64_t> _frame = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__TRACERECORDER__H__
@@ -325,7 +325,7 @@ void initOGL(GLFWwindow*) {
         }
     }
 
-    Log::Info(fmt::format("Number of active viewports: {}", numberOfActiveViewports));
+    Log::Info("Number of active viewports: {}", numberOfActiveViewports);
 
     constexpr const uint8_t RestartIndex = std::numeric_limits<uint8_t>::max();
 
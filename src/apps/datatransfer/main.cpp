@@ -111,10 +111,12 @@ void startDataTransfer() {
     std::vector<char> buffer(size);
     if (file.read(buffer.data(), size)) {
         const int s = static_cast<int>(size);
-        NetworkManager::instance().transferData(buffer.data(), s, id);
 
         // read the image on master
         readImage(reinterpret_cast<unsigned char*>(buffer.data()), s);
+
+        // The transfer runs in the background and takes ownership of the buffer
+        NetworkManager::instance().transferData(std::move(buffer), id);
     }
 }
 
@@ -194,10 +196,10 @@ void uploadTexture() {
 
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    Log::Info(fmt::format(
+    Log::Info(
         "Texture id {} loaded ({}x{}x{}).",
         tex, transImg->size().x, transImg->size().y, transImg->channels()
-    ));
+    );
 
     texIds.push_back(tex);
     transImg = nullptr;
@@ -360,9 +362,9 @@ void keyboard(Key key, Modifier, Action action, int) {
 }
 
 void dataTransferDecoder(void* data, int length, int packageId, int clientIndex) {
-    Log::Info(fmt::format(
+    Log::Info(
         "Decoding {} bytes in transfer id: {} on node {}", length, packageId, clientIndex
-    ));
+    );
 
     currentPackage = packageId;
 
@@ -372,15 +374,20 @@ void dataTransferDecoder(void* data, int length, int packageId, int clientIndex)
 }
 
 void dataTransferStatus(bool connected, int clientIndex) {
-    Log::Info(fmt::format(
+    Log::Info(
         "Transfer node {} is {}", clientIndex, connected ? "connected" : "disconnected"
-    ));
+    );
+}
+
+void dataTransferProgress(int packageId, int clientIndex, float progress) {
+    Log::Debug(
+        "Transfer id: {} is {:.0f}% done on node {}", packageId, progress * 100.f,
+        clientIndex
+    );
 }
 
 void dataTransferAcknowledge(int packageId, int clientIndex) {
-    Log::Info(fmt::format(
-        "Transfer id: {} is completed on node {}", packageId, clientIndex
-    ));
+    Log::Info("Transfer id: {} is completed on node {}", packageId, clientIndex);
 
     if (packageId == currentPackage) {
         static int counter = 0;
@@ -389,10 +396,10 @@ void dataTransferAcknowledge(int packageId, int clientIndex) {
             clientsUploadDone = true;
             counter = 0;
 
-            Log::Info(fmt::format(
+            Log::Info(
                 "Time to distribute and upload textures on cluster: {} ms",
                 (Engine::getTime() - sendTimer) * 1000.0
-            ));
+            );
         }
     }
 }
@@ -443,6 +450,7 @@ int main(int argc, char** argv) {
     callbacks.dataTransferDecode = dataTransferDecoder;
     callbacks.dataTransferStatus = dataTransferStatus;
     callbacks.dataTransferAcknowledge = dataTransferAcknowledge;
+    callbacks.dataTransferProgress = dataTransferProgress;
 
     try {
         Engine::create(cluster, callbacks, config);
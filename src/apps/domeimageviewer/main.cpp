@@ -108,8 +108,8 @@ void startDataTransfer() {
         std::vector<char> buffer(size);
         if (file.read(buffer.data(), size)) {
             const int s = static_cast<int>(buffer.size());
-            NetworkManager::instance().transferData(buffer.data(), s, i);
             readImage(reinterpret_cast<unsigned char*>(buffer.data()), s);
+            NetworkManager::instance().transferData(std::move(buffer), i);
         }
     }
 }
@@ -180,11 +180,11 @@ void uploadTexture() {
         // unbind
         glBindTexture(GL_TEXTURE_2D, 0);
 
-        Log::Info(fmt::format(
+        Log::Info(
             "Texture id %d loaded ({}x{}x{})",
             tex, transImages[i]->size().x, transImages[i]->size().y,
             transImages[i]->channels()
-        ));
+        );
 
         texIds.push_back(tex);
         transImages[i] = nullptr;
@@ -376,10 +376,10 @@ void keyboard(Key key, Modifier, Action action, int) {
 void dataTransferDecoder(void* receivedData, int receivedLength, int packageId,
                          int clientIndex)
 {
-    Log::Info(fmt::format(
+    Log::Info(
         "Decoding {} bytes in transfer id: {} on node {}",
         receivedLength, packageId, clientIndex
-    ));
+    );
 
     lastPackage = packageId;
 
@@ -389,15 +389,13 @@ void dataTransferDecoder(void* receivedData, int receivedLength, int packageId,
 }
 
 void dataTransferStatus(bool connected, int clientIndex) {
-    Log::Info(fmt::format(
+    Log::Info(
         "Transfer node {} is {}", clientIndex, connected ? "connected" : "disconnected"
-    ));
+    );
 }
 
 void dataTransferAcknowledge(int packageId, int clientIndex) {
-    Log::Info(fmt::format(
-        "Transfer id: {} is completed on node {}", packageId, clientIndex
-    ));
+    Log::Info("Transfer id: {} is completed on node {}", packageId, clientIndex);
 
     if (packageId == lastPackage) {
         static int counter = 0;
@@ -406,10 +404,10 @@ void dataTransferAcknowledge(int packageId, int clientIndex) {
             clientsUploadDone = true;
             counter = 0;
 
-            Log::Info(fmt::format(
+            Log::Info(
                 "Time to distribute and upload textures on cluster: {} ms",
                 (Engine::getTime() - sendTimer) * 1000.0
-            ));
+            );
         }
     }
 }
@@ -104,13 +104,12 @@ void preSync() {
     }
 }
 
-std::vector<std::byte> encode() {
-    std::vector<std::byte> data;
+void encode(std::vector<std::byte>& data) {
     serializeObject(data, currentTime);
-    return data;
 }
 
-void decode(const std::vector<std::byte>& data, unsigned int pos) {
+void decode(const std::byte* data, size_t) {
+    unsigned int pos = 0;
     deserializeObject(data, pos, currentTime);
 }
 
@@ -136,8 +135,8 @@ int main(int argc, char** argv) {
     Engine::Callbacks callbacks;
     callbacks.initOpenGL = initOGL;
     callbacks.preSync = preSync;
-    callbacks.encode = encode;
-    callbacks.decode = decode;
+    callbacks.encodeInPlace = encode;
+    callbacks.decodeInPlace = decode;
     callbacks.draw = draw;
     callbacks.cleanup = cleanup;
     callbacks.keyboard = keyboard;
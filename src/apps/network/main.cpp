@@ -69,25 +69,21 @@ void networkConnectionUpdated(Network* conn) {
 
     connected = conn->isConnected();
 
-    Log::Info(fmt::format(
-        "Network is {}", conn->isConnected() ? "connected" : "disconneced"
-    ));
+    Log::Info("Network is {}", conn->isConnected() ? "connected" : "disconneced");
 }
 
 void networkAck(int packageId, int) {
-    Log::Info(fmt::format("Network package {} is received", packageId));
+    Log::Info("Network package {} is received", packageId);
 
     if (timerData.second == packageId) {
-        Log::Info(fmt::format(
-            "Loop time: {} ms", (Engine::getTime() - timerData.first) * 1000.0
-        ));
+        Log::Info("Loop time: {} ms", (Engine::getTime() - timerData.first) * 1000.0);
     }
 }
 
 void networkDecode(void* receivedData, int receivedLength, int packageId, int) {
-    Log::Info(fmt::format("Network decoding package {}", packageId));
+    Log::Info("Network decoding package {}", packageId);
     std::string test(reinterpret_cast<char*>(receivedData), receivedLength);
-    Log::Info(fmt::format("Message: \"{}\"", test));
+    Log::Info("Message: \"{}\"", test);
 }
 
 void connect() {
@@ -110,7 +106,7 @@ void connect() {
 
     // init
     try {
-        Log::Debug(fmt::format("Initiating network connection at port {}", port));
+        Log::Debug("Initiating network connection at port {}", port);
 
         networkPtr->setUpdateFunction(networkConnectionUpdated);
         networkPtr->setPackageDecodeFunction(networkDecode);
@@ -118,7 +114,7 @@ void connect() {
         networkPtr->initialize();
     }
     catch (const std::runtime_error& err) {
-        Log::Error(fmt::format("Network error: {}", err.what()));
+        Log::Error("Network error: {}", err.what());
         networkPtr->initShutdown();
         std::this_thread::sleep_for(std::chrono::seconds(1));
         networkPtr->closeNetwork(true);
@@ -284,11 +280,11 @@ int main(int argc, char** argv) {
         std::string_view v(argv[i]);
         if (v == "-port" && argc > (i + 1)) {
             port = std::stoi(argv[i + 1]);
-            Log::Info(fmt::format("Setting port to: {}", port));
+            Log::Info("Setting port to: {}", port);
         }
         else if (v == "-address" && argc > (i + 1)) {
             address = argv[i + 1];
-            Log::Info(fmt::format("Setting address to: {}", address));
+            Log::Info("Setting address to: {}", address);
         }
         else if (v == "--server") {
             isServer = true;
@@ -0,0 +1,567 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+// Runs a master and a number of clients on the loopback interface without opening any
+// windows and measures how fast the shared data is synchronized through the regular
+// NetworkManager code paths. As the managers are singletons, every node runs in its own
+// process; the master starts the clients by running this executable again with --node
+//
+// The star and the relay tree topologies are compared by running the same number of
+// clients once with --relays 0, where the master sends every frame to all clients, and
+// once with about the square root of the number of clients as relays, for example
+// --clients 64 --relays 8. The master's system calls and CPU time per frame show the
+// cost of the fan-out on the master
+
+#include <sgct/clusterclock.h>
+#include <sgct/clustermanager.h>
+#include <sgct/config.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/mutexes.h>
+#include <sgct/networkmanager.h>
+#include <sgct/shareddata.h>
+#include <sgct/sharedmemorychannel.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define VC_EXTRALEAN
+    #define NOMINMAX
+    #include <Windows.h>
+    #include <process.h>
+#else
+    #include <spawn.h>
+    #include <sys/resource.h>
+    #include <sys/wait.h>
+    extern char** environ;
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        int node = 0;
+        int nClients = 3;
+        int nRelays = 0;
+        int nFrames = 1000;
+        int nWarmupFrames = 50;
+        int payloadSize = 64 * 1024;
+        float changedFraction = 1.f;
+        double rate = 0.0;
+        int spinTime = 0;
+        int renderAhead = 0;
+        int decodeTime = 0;
+        int port = 20401;
+        bool useReactor = false;
+        bool useTcp = false;
+        bool useCompression = false;
+        bool useDelta = false;
+        bool useAsyncDecode = false;
+        std::string multicastAddress;
+    };
+
+    constexpr const std::chrono::seconds ConnectionTimeout(30);
+
+    uint32_t randomState = 0x9e3779b9;
+
+    void printHelp() {
+        std::cout << R"(Usage: networkbenchmark [options]
+  --clients <n>     Number of client processes (default 3)
+  --relays <n>      Number of clients that act as relays for the remaining clients,
+                    0 for a star where the master sends to all clients (default 0)
+  --frames <n>      Number of measured frames (default 1000)
+  --warmup <n>      Number of frames that are not measured (default 50)
+  --size <bytes>    Size of the shared data payload (default 65536)
+  --change <f>      Fraction of the payload that changes every frame (default 1.0)
+  --rate <hz>       Frames per second that are sent, 0 for as fast as possible
+  --spin <us>       Microseconds to poll for the sync messages before blocking
+  --ahead <n>       Number of frames the master may send before they are acknowledged
+  --decode <us>     Microseconds of work that the clients do to decode each frame
+  --async           Decode on the receiving thread into a staging copy of the state
+  --port <port>     First port that is used by the nodes (default 20401)
+  --reactor         Use the network reactor instead of one thread per connection
+  --tcp             Use TCP loopback connections instead of shared memory
+  --compression     Compress the shared data
+  --delta           Send only the changed parts of the shared data
+  --multicast <ip>  Send the shared data to this multicast group
+)";
+    }
+
+    Options parseArguments(const std::vector<std::string>& args) {
+        Options opts;
+        auto value = [&args](size_t& i) -> const std::string& {
+            if (i + 1 >= args.size()) {
+                throw std::runtime_error(fmt::format("Missing value for {}", args[i]));
+            }
+            return args[++i];
+        };
+
+        for (size_t i = 0; i < args.size(); i++) {
+            const std::string& a = args[i];
+            if (a == "--node") {
+                opts.node = std::stoi(value(i));
+            }
+            else if (a == "--clients") {
+                opts.nClients = std::stoi(value(i));
+            }
+            else if (a == "--relays") {
+                opts.nRelays = std::stoi(value(i));
+            }
+            else if (a == "--frames") {
+                opts.nFrames = std::stoi(value(i));
+            }
+            else if (a == "--warmup") {
+                opts.nWarmupFrames = std::stoi(value(i));
+            }
+            else if (a == "--size") {
+                opts.payloadSize = std::stoi(value(i));
+            }
+            else if (a == "--change") {
+                opts.changedFraction = std::clamp(std::stof(value(i)), 0.f, 1.f);
+            }
+            else if (a == "--rate") {
+                opts.rate = std::stod(value(i));
+            }
+            else if (a == "--spin") {
+                opts.spinTime = std::stoi(value(i));
+            }
+            else if (a == "--ahead") {
+                opts.renderAhead = std::stoi(value(i));
+            }
+            else if (a == "--decode") {
+                opts.decodeTime = std::stoi(value(i));
+            }
+            else if (a == "--async") {
+                opts.useAsyncDecode = true;
+            }
+            else if (a == "--port") {
+                opts.port = std::stoi(value(i));
+            }
+            else if (a == "--reactor") {
+                opts.useReactor = true;
+            }
+            else if (a == "--tcp") {
+                opts.useTcp = true;
+            }
+            else if (a == "--compression") {
+                opts.useCompression = true;
+            }
+            else if (a == "--delta") {
+                opts.useDelta = true;
+            }
+            else if (a == "--multicast") {
+                opts.multicastAddress = value(i);
+            }
+            else if (a == "--help") {
+                printHelp();
+                std::exit(EXIT_SUCCESS);
+            }
+            else {
+                throw std::runtime_error(fmt::format("Unknown argument {}", a));
+            }
+        }
+
+        if (opts.nClients < 1 || opts.nClients > 250) {
+            throw std::runtime_error("The number of clients has to be in [1, 250]");
+        }
+        if (opts.nRelays < 0 || opts.nRelays >= opts.nClients) {
+            throw std::runtime_error("The number of relays has to be less than clients");
+        }
+        if (opts.spinTime < 0 || opts.renderAhead < 0 || opts.decodeTime < 0) {
+            throw std::runtime_error(
+                "The spin time, render ahead, and decode time must be non-negative"
+            );
+        }
+        if (opts.nFrames < 1 || opts.nWarmupFrames < 0 || opts.payloadSize < 0) {
+            throw std::runtime_error("Invalid number of frames or payload size");
+        }
+        return opts;
+    }
+
+    // Builds the same cluster in every process; the nodes only differ in their address
+    // and port, and the clients after the relays are distributed evenly among them
+    sgct::config::Cluster createCluster(const Options& opts) {
+        sgct::config::Cluster cluster;
+        cluster.masterAddress = "127.0.0.1";
+        cluster.useNetworkReactor = opts.useReactor;
+        cluster.useSharedMemory = !opts.useTcp;
+        cluster.syncSpinTime = opts.spinTime;
+        cluster.renderAhead = opts.renderAhead;
+        cluster.asyncDecode = opts.useAsyncDecode;
+
+        sgct::config::Compression compression;
+        compression.sync = opts.useCompression;
+        compression.delta = opts.useDelta;
+        cluster.compression = compression;
+
+        if (!opts.multicastAddress.empty()) {
+            sgct::config::Multicast multicast;
+            multicast.address = opts.multicastAddress;
+            multicast.port = opts.port + opts.nClients + 1;
+            cluster.multicast = multicast;
+        }
+
+        for (int i = 0; i <= opts.nClients; i++) {
+            sgct::config::Node node;
+            node.address = fmt::format("127.0.0.{}", i + 1);
+            node.port = opts.port + i;
+            if (opts.nRelays > 0 && i > opts.nRelays) {
+                node.parent = 1 + (i - opts.nRelays - 1) % opts.nRelays;
+            }
+            cluster.nodes.push_back(std::move(node));
+        }
+        return cluster;
+    }
+
+    double cpuTime() {
+#ifdef WIN32
+        FILETIME creation, exit, kernel, user;
+        GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+        auto seconds = [](const FILETIME& t) {
+            const uint64_t v = (static_cast<uint64_t>(t.dwHighDateTime) << 32) |
+                               t.dwLowDateTime;
+            return v * 1e-7;
+        };
+        return seconds(kernel) + seconds(user);
+#else // WIN32
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        auto seconds = [](const timeval& t) { return t.tv_sec + t.tv_usec * 1e-6; };
+        return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+#endif // WIN32
+    }
+
+    /// Waits until the current frame is acknowledged or the network has stopped
+    void waitForSync(const Options& opts, std::chrono::seconds timeout) {
+        using namespace sgct;
+
+        NetworkManager& nm = NetworkManager::instance();
+        auto isComplete = [&nm]() {
+            return !nm.isRunning() || nm.isSyncComplete() ||
+                   (nm.isComputerServer() && nm.activeConnectionsCount() == 0);
+        };
+        const std::chrono::microseconds spinTime(opts.spinTime);
+        if (!NetworkManager::barrier.wait(isComplete, spinTime, timeout)) {
+            throw std::runtime_error(
+                fmt::format("No sync signal after {} s", timeout.count())
+            );
+        }
+    }
+
+    std::vector<int> startClients(const std::string& executable,
+                                  const std::vector<std::string>& args,
+                                  const Options& opts)
+    {
+        std::vector<int> processes;
+        for (int i = 1; i <= opts.nClients; i++) {
+            std::vector<std::string> a = { executable };
+            a.insert(a.end(), args.begin(), args.end());
+            a.push_back("--node");
+            a.push_back(std::to_string(i));
+
+            std::vector<char*> argv;
+            for (std::string& s : a) {
+                argv.push_back(s.data());
+            }
+            argv.push_back(nullptr);
+
+#ifdef WIN32
+            const intptr_t res = _spawnv(_P_NOWAIT, executable.c_str(), argv.data());
+            if (res == -1) {
+                throw std::runtime_error(fmt::format("Failed to start client {}", i));
+            }
+            processes.push_back(static_cast<int>(res));
+#else // WIN32
+            pid_t pid = 0;
+            const int res = posix_spawn(
+                &pid,
+                executable.c_str(),
+                nullptr,
+                nullptr,
+                argv.data(),
+                environ
+            );
+            if (res != 0) {
+                throw std::runtime_error(fmt::format("Failed to start client {}", i));
+            }
+            processes.push_back(static_cast<int>(pid));
+#endif // WIN32
+        }
+        return processes;
+    }
+
+    /// \return false if any of the client \p processes failed or was killed by a signal
+    bool waitForClients(const std::vector<int>& processes) {
+        using namespace sgct;
+
+        bool isSuccess = true;
+        for (size_t i = 0; i < processes.size(); i++) {
+            int status = 0;
+#ifdef WIN32
+            const bool hasExited = _cwait(&status, processes[i], _WAIT_CHILD) != -1;
+            const bool isClientSuccess = hasExited && status == EXIT_SUCCESS;
+#else // WIN32
+            const pid_t pid = static_cast<pid_t>(processes[i]);
+            const bool hasExited = waitpid(pid, &status, 0) != -1;
+            const bool isClientSuccess =
+                hasExited && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+#endif // WIN32
+            if (!isClientSuccess) {
+                // The clients are started with the node ids following the master's
+                Log::Error("Client {} failed with status {}", i + 1, status);
+                isSuccess = false;
+            }
+        }
+        return isSuccess;
+    }
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        // Nearest-rank percentile
+        const size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    /// Waits until the master has reported that all nodes of the cluster are connected
+    void waitForConnections() {
+        using namespace sgct;
+
+        NetworkManager& nm = NetworkManager::instance();
+        const Clock::time_point t0 = Clock::now();
+        while (nm.isRunning() && !nm.areAllNodesConnected()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (Clock::now() - t0 > ConnectionTimeout) {
+                throw std::runtime_error("Not all clients connected in time");
+            }
+        }
+    }
+
+    void runMaster(const Options& opts) {
+        using namespace sgct;
+
+        NetworkManager& nm = NetworkManager::instance();
+        waitForConnections();
+        Log::Info("All clients connected, starting the benchmark");
+
+        std::vector<std::byte> payload(opts.payloadSize);
+        const size_t nChanged =
+            static_cast<size_t>(opts.changedFraction * opts.payloadSize);
+        size_t changeOffset = 0;
+        SharedData::instance().setEncodeInPlaceFunction(
+            [&](std::vector<std::byte>& buffer) {
+                // Changes a window of pseudo-random bytes that moves through the payload
+                for (size_t i = 0; i < nChanged; i++) {
+                    randomState ^= randomState << 13;
+                    randomState ^= randomState >> 17;
+                    randomState ^= randomState << 5;
+                    const size_t idx = (changeOffset + i) % payload.size();
+                    payload[idx] = static_cast<std::byte>(randomState);
+                }
+                if (!payload.empty()) {
+                    changeOffset = (changeOffset + nChanged) % payload.size();
+                }
+                buffer.insert(buffer.end(), payload.begin(), payload.end());
+            }
+        );
+
+        const Clock::duration period = opts.rate > 0.0 ?
+            std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(1.0 / opts.rate)
+            ) :
+            Clock::duration::zero();
+
+        std::vector<double> roundTrips;
+        roundTrips.reserve(opts.nFrames);
+        uint64_t wireBytes = 0;
+        double cpuStart = 0.0;
+        uint64_t syscallStart = 0;
+        Clock::time_point measureStart;
+        Clock::time_point nextFrame = Clock::now();
+        const int nTotalFrames = opts.nWarmupFrames + opts.nFrames;
+        for (int frame = 0; frame < nTotalFrames && nm.isRunning(); frame++) {
+            if (frame == opts.nWarmupFrames) {
+                cpuStart = cpuTime();
+                syscallStart = Network::syscallCount();
+                TimedLock::takeWaitTime();
+                measureStart = Clock::now();
+            }
+
+            const Clock::time_point ts = Clock::now();
+            SharedData::instance().encode();
+            nm.sync(NetworkManager::SyncMode::SendDataToClients);
+            waitForSync(opts, std::chrono::seconds(10));
+            const std::chrono::duration<double> rtt = Clock::now() - ts;
+
+            if (frame >= opts.nWarmupFrames) {
+                roundTrips.push_back(rtt.count());
+                wireBytes += SharedData::instance().dataSize();
+            }
+
+            if (period > Clock::duration::zero()) {
+                nextFrame += period;
+                std::this_thread::sleep_until(nextFrame);
+            }
+        }
+        const std::chrono::duration<double> wall = Clock::now() - measureStart;
+        const double cpu = cpuTime() - cpuStart;
+        const uint64_t nSyscalls = Network::syscallCount() - syscallStart;
+        const double lockWait = TimedLock::takeWaitTime();
+
+        if (roundTrips.empty()) {
+            throw std::runtime_error("The network stopped before any frame was measured");
+        }
+        std::sort(roundTrips.begin(), roundTrips.end());
+        const double n = static_cast<double>(roundTrips.size());
+        // The master sends each frame to every direct child or once to the multicast
+        // group
+        const double nDirect = !opts.multicastAddress.empty() ? 1.0 :
+            (opts.nRelays > 0 ? opts.nRelays : opts.nClients);
+        const double mb = 1024.0 * 1024.0;
+        Log::Info(
+            "Benchmark results\n"
+            "  Clients: {} ({} relays), payload: {} bytes, frames: {}, ahead: {}\n"
+            "  Transport: {}, decode: {} ({} us per frame)\n"
+            "  Sync round trip [ms]: p50 {:.3f}, p99 {:.3f}, max {:.3f}\n"
+            "  Throughput: {:.1f} frames/s, {:.2f} MB/s payload, {:.2f} MB/s sent\n"
+            "  Master CPU time: {:.3f} s ({:.1f}% of {:.3f} s)\n"
+            "  Master network system calls: {:.1f} per frame\n"
+            "  Master lock wait time: {:.3f} us per frame",
+            opts.nClients, opts.nRelays, opts.payloadSize, roundTrips.size(),
+            opts.renderAhead,
+            opts.useTcp || !SharedMemoryChannel::isSupported() ? "TCP" : "shared memory",
+            opts.useAsyncDecode ? "async" : "sync", opts.decodeTime,
+            percentile(roundTrips, 0.5) * 1000.0, percentile(roundTrips, 0.99) * 1000.0,
+            roundTrips.back() * 1000.0,
+            n / wall.count(), n * opts.payloadSize * opts.nClients / mb / wall.count(),
+            wireBytes * nDirect / mb / wall.count(),
+            cpu, 100.0 * cpu / wall.count(), wall.count(),
+            static_cast<double>(nSyscalls) / n,
+            lockWait / n * 1e6
+        );
+    }
+
+    void runClient(const Options& opts) {
+        using namespace sgct;
+
+        // The clients keep a copy of the payload as their application state and spend
+        // the decode time on it to simulate rebuilding data that is derived from it
+        uint64_t nDecoded = 0;
+        std::vector<std::byte> state;
+        std::vector<std::byte> stagingState;
+        auto decode = [&opts, &nDecoded](std::vector<std::byte>& target,
+                                         const std::byte* data, size_t size)
+        {
+            target.assign(data, data + size);
+            const Clock::time_point end =
+                Clock::now() + std::chrono::microseconds(opts.decodeTime);
+            while (Clock::now() < end) {}
+            nDecoded++;
+        };
+        if (opts.useAsyncDecode) {
+            SharedData::instance().setStagedDecodeFunctions(
+                [&decode, &stagingState](const std::byte* data, size_t size) {
+                    decode(stagingState, data, size);
+                },
+                [&state, &stagingState]() { std::swap(state, stagingState); }
+            );
+        }
+        else {
+            SharedData::instance().setDecodeInPlaceFunction(
+                [&decode, &state](const std::byte* data, size_t size) {
+                    decode(state, data, size);
+                }
+            );
+        }
+
+        // Before the connection to the parent is established, the sync would count as
+        // complete and the client would acknowledge a frame that it never received
+        waitForConnections();
+
+        NetworkManager& nm = NetworkManager::instance();
+        const double cpuStart = cpuTime();
+        while (nm.isRunning()) {
+            waitForSync(opts, ConnectionTimeout);
+            if (!nm.isRunning()) {
+                break;
+            }
+            nm.decodeQueuedFrame();
+            SharedData::instance().applyStagedFrame();
+            nm.sync(NetworkManager::SyncMode::Acknowledge);
+        }
+        Log::Info(
+            "Client {} decoded {} frames using {:.3f} s of CPU time",
+            opts.node, nDecoded, cpuTime() - cpuStart
+        );
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace sgct;
+
+    std::vector<std::string> arg(argv + 1, argv + argc);
+    Options opts;
+    try {
+        opts = parseArguments(arg);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        printHelp();
+        return EXIT_FAILURE;
+    }
+
+    const bool isMaster = opts.node == 0;
+    std::vector<int> clients;
+    bool isSuccess = true;
+    try {
+        if (isMaster) {
+            clients = startClients(argv[0], arg, opts);
+        }
+
+        NetworkManager::create(
+            isMaster ?
+                NetworkManager::NetworkMode::LocalServer :
+                NetworkManager::NetworkMode::LocalClient,
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+        );
+        ClusterManager::create(createCluster(opts), opts.node);
+        NetworkManager::instance().initialize();
+
+        if (isMaster) {
+            runMaster(opts);
+        }
+        else {
+            runClient(opts);
+        }
+    }
+    catch (const std::runtime_error& e) {
+        Log::Error(e.what());
+        isSuccess = false;
+    }
+
+    // Destroying the network on the master disconnects the clients, which makes them exit
+    NetworkManager::destroy();
+    ClusterManager::destroy();
+    ClusterClock::destroy();
+    SharedData::destroy();
+    if (isMaster) {
+        // A client that failed invalidates the results of the master as well
+        isSuccess &= waitForClients(clients);
+    }
+    Log::destroy();
+    return isSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -156,9 +156,9 @@ void initOmniStereo(bool mask) {
         win.framebufferResolution().y / tileSize
     };
 
-    Log::Info(fmt::format(
+    Log::Info(
         "Allocating: {} MB data", (sizeof(OmniData) * res.x * res.y) / (1024 * 1024)
-    ));
+    );
     omniProjections.resize(res.x);
     for (int i = 0; i < res.x; i++) {
         omniProjections[i].resize(res.y);
@@ -339,10 +339,10 @@ void initOmniStereo(bool mask) {
     }
 
     int percentage = (100 * VPCounter) / (res.x * res.y * 3);
-    Log::Info(fmt::format(
+    Log::Info(
         "Time to init viewports: {} s\n{} %% will be rendered.",
         Engine::instance().getTime() - t0, percentage
-    ));
+    );
     omniInited = true;
 }
 
@@ -411,7 +411,7 @@ void drawOmniStereo(const RenderData& renderData) {
     }
 
     const double t1 = Engine::instance().getTime();
-    Log::Info(fmt::format("Time to draw frame: {}s", t1 - t0));
+    Log::Info("Time to draw frame: {}s", t1 - t0);
 }
 
 void draw(const RenderData& data) {
@@ -542,11 +542,11 @@ int main(int argc, char** argv) {
 
         if (argument == "-turnmap" && argc > i + 1) {
             turnMapSrc = argv[i + 1];
-            Log::Info(fmt::format("Setting turn map path to {}", turnMapSrc));
+            Log::Info("Setting turn map path to {}", turnMapSrc);
         }
         if (argument == "-sepmap" && argc > i + 1) {
             sepMapSrc = argv[i + 1];
-            Log::Info(fmt::format("Setting separation map path to '{}'", sepMapSrc));
+            Log::Info("Setting separation map path to '{}'", sepMapSrc);
         }
     }
 
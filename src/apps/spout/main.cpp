@@ -79,9 +79,7 @@ using namespace sgct;
 bool bindSpout() {
     const bool creationSuccess = receiver->CreateReceiver(senderName, width, height);
     if (!initialized && creationSuccess) {
-        Log::Info(fmt::format(
-            "Spout: Initing {}x{} texture from '{}'", width, height, senderName
-        ));
+        Log::Info("Spout: Initing {}x{} texture from '{}'", width, height, senderName);
         initialized = true;
     }
 
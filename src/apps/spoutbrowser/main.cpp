@@ -97,9 +97,9 @@ bool bindSpout() {
     }
     const bool creationSuccess = receiver->CreateReceiver(name.data(), width, height);
     if (!isInitialized && creationSuccess) {
-        Log::Info(fmt::format(
+        Log::Info(
             "Spout: Initializing {}x{} texture from '{}'", width, height, name.data()
-        ));
+        );
         isInitialized = true;
     }
 
@@ -59,9 +59,7 @@ using namespace sgct;
 bool bindSpout() {
     const bool creationSuccess = receiver->CreateReceiver(sender.data(), width, height);
     if (!initialized && creationSuccess) {
-        Log::Info(fmt::format(
-            "Spout: Initing {}x{} texture from '{}'", width, height, sender
-        ));
+        Log::Info("Spout: Initing {}x{} texture from '{}'", width, height, sender);
         initialized = true;
     }
 
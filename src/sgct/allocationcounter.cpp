@@ -0,0 +1,50 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/allocationcounter.h>
+
+#include <atomic>
+
+namespace {
+    std::atomic_bool isCounting = false;
+
+    // The counters are trivial so that they can be used by operator new while a thread
+    // is being started or destroyed
+    thread_local sgct::AllocationCounter::Counts counts;
+} // namespace
+
+namespace sgct {
+
+bool AllocationCounter::isAvailable() {
+#ifdef SGCT_HAS_ALLOCATION_COUNTER
+    return true;
+#else // SGCT_HAS_ALLOCATION_COUNTER
+    return false;
+#endif // SGCT_HAS_ALLOCATION_COUNTER
+}
+
+void AllocationCounter::setEnabled(bool enabled) {
+    isCounting = enabled;
+}
+
+bool AllocationCounter::isEnabled() {
+    return isCounting;
+}
+
+AllocationCounter::Counts AllocationCounter::threadCounts() {
+    return counts;
+}
+
+void AllocationCounter::recordAllocation(size_t bytes) {
+    if (isCounting.load(std::memory_order_relaxed)) {
+        counts.nAllocations++;
+        counts.nBytes += bytes;
+    }
+}
+
+} // namespace sgct
@@ -98,7 +98,7 @@ void BaseViewport::linkUserName() {
             _user = user;
         }
         else {
-            Log::Warning(fmt::format("Could not find user with name '{}'", _userName));
+            Log::Warning("Could not find user with name '{}'", _userName);
         }
     }
 }
@@ -0,0 +1,82 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/clusterclock.h>
+
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <algorithm>
+
+namespace sgct {
+
+ClusterClock* ClusterClock::_instance = nullptr;
+
+ClusterClock& ClusterClock::instance() {
+    if (!_instance) {
+        _instance = new ClusterClock;
+    }
+    return *_instance;
+}
+
+void ClusterClock::destroy() {
+    delete _instance;
+    _instance = nullptr;
+}
+
+ClusterClock::ClusterClock() : _start(std::chrono::steady_clock::now()) {}
+
+double ClusterClock::localTime() const {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now() - _start).count();
+}
+
+double ClusterClock::time() const {
+    const double t = localTime() + _offset;
+
+    // Keep the time monotonic if a better estimate moved the offset backwards
+    double last = _lastTime;
+    while (t > last && !_lastTime.compare_exchange_weak(last, t)) {}
+    return std::max(t, last);
+}
+
+double ClusterClock::offset() const {
+    return _offset;
+}
+
+double ClusterClock::roundTripDelay() const {
+    return _delay;
+}
+
+void ClusterClock::addSample(double t0, double t1, double t2, double t3) {
+    Sample sample;
+    sample.offset = ((t1 - t0) + (t2 - t3)) / 2.0;
+    sample.delay = (t3 - t0) - (t2 - t1);
+
+    std::unique_lock lock(_sampleMutex);
+    _samples[_nSamples % _samples.size()] = sample;
+    _nSamples++;
+
+    // The exchange with the smallest delay is the least affected by queueing, so its
+    // offset is the most accurate one
+    const size_t n = std::min(_nSamples, _samples.size());
+    const Sample& best = *std::min_element(
+        _samples.begin(),
+        _samples.begin() + n,
+        [](const Sample& a, const Sample& b) { return a.delay < b.delay; }
+    );
+    if (_nSamples == 1) {
+        Log::Debug(
+            "Cluster clock offset {:.6f} s with a round trip of {:.6f} s",
+            best.offset, best.delay
+        );
+    }
+    _offset = best.offset;
+    _delay = best.delay;
+}
+
+} // namespace sgct
@@ -73,6 +73,39 @@ void ClusterManager::applyCluster(const config::Cluster& cluster) {
     if (cluster.firmSync) {
         setFirmFrameLockSyncStatus(*cluster.firmSync);
     }
+    if (cluster.useNetworkReactor) {
+        setUseNetworkReactor(*cluster.useNetworkReactor);
+    }
+    if (cluster.useSharedMemory) {
+        setUseSharedMemory(*cluster.useSharedMemory);
+    }
+    if (cluster.compression) {
+        _useSyncCompression = cluster.compression->sync.value_or(_useSyncCompression);
+        _useDataTransferCompression =
+            cluster.compression->dataTransfer.value_or(_useDataTransferCompression);
+        _compressionThreshold =
+            cluster.compression->threshold.value_or(_compressionThreshold);
+        _useDeltaEncoding = cluster.compression->delta.value_or(_useDeltaEncoding);
+        _keyframeInterval =
+            cluster.compression->keyframeInterval.value_or(_keyframeInterval);
+    }
+    if (cluster.dataTransferCache) {
+        _dataTransferCache = *cluster.dataTransferCache;
+    }
+    if (cluster.syncSpinTime) {
+        _syncSpinTime = *cluster.syncSpinTime;
+    }
+    if (cluster.renderAhead) {
+        _renderAhead = *cluster.renderAhead;
+    }
+    if (cluster.asyncDecode) {
+        _useAsyncDecode = *cluster.asyncDecode;
+    }
+    if (cluster.multicast) {
+        _multicastAddress = cluster.multicast->address;
+        _multicastPort = cluster.multicast->port;
+        _multicastInterface = cluster.multicast->interfaceAddress.value_or("");
+    }
     if (cluster.scene) {
         const glm::mat4 translate = cluster.scene->offset ?
             glm::translate(
@@ -97,7 +130,7 @@ void ClusterManager::applyCluster(const config::Cluster& cluster) {
             name = *u.name;
             std::unique_ptr<User> usr = std::make_unique<User>(*u.name);
             addUser(std::move(usr));
-            Log::Info(fmt::format("Adding user '{}'", *u.name));
+            Log::Info("Adding user '{}'", *u.name);
         }
         else {
             name = "default";
@@ -217,4 +250,68 @@ void ClusterManager::setFirmFrameLockSyncStatus(bool state) {
     _firmFrameLockSync = state;
 }
 
+bool ClusterManager::useNetworkReactor() const {
+    return _useNetworkReactor;
+}
+
+void ClusterManager::setUseNetworkReactor(bool state) {
+    _useNetworkReactor = state;
+}
+
+bool ClusterManager::useSharedMemory() const {
+    return _useSharedMemory;
+}
+
+void ClusterManager::setUseSharedMemory(bool state) {
+    _useSharedMemory = state;
+}
+
+bool ClusterManager::useSyncCompression() const {
+    return _useSyncCompression;
+}
+
+bool ClusterManager::useDataTransferCompression() const {
+    return _useDataTransferCompression;
+}
+
+int ClusterManager::compressionThreshold() const {
+    return _compressionThreshold;
+}
+
+bool ClusterManager::useDeltaEncoding() const {
+    return _useDeltaEncoding;
+}
+
+int ClusterManager::keyframeInterval() const {
+    return _keyframeInterval;
+}
+
+const std::string& ClusterManager::dataTransferCache() const {
+    return _dataTransferCache;
+}
+
+int ClusterManager::syncSpinTime() const {
+    return _syncSpinTime;
+}
+
+int ClusterManager::renderAhead() const {
+    return _renderAhead;
+}
+
+bool ClusterManager::useAsyncDecode() const {
+    return _useAsyncDecode;
+}
+
+const std::string& ClusterManager::multicastAddress() const {
+    return _multicastAddress;
+}
+
+int ClusterManager::multicastPort() const {
+    return _multicastPort;
+}
+
+const std::string& ClusterManager::multicastInterface() const {
+    return _multicastInterface;
+}
+
 } // namespace sgct
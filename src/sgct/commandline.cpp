@@ -53,6 +53,10 @@ Configuration parseArguments(std::vector<std::string>& arg) {
 
             arg.erase(arg.begin() + i, arg.begin() + i + 2);
         }
+        else if (arg[i] == "--log-file" && arg.size() > (i + 1)) {
+            config.logFilePath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
         else if (arg[i] == "--firm-sync") {
             config.firmSync = true;
             arg.erase(arg.begin() + i);
@@ -65,6 +69,10 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.ignoreSync = true;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "--network-reactor") {
+            config.useNetworkReactor = true;
+            arg.erase(arg.begin() + i);
+        }
         else if (arg[i] == "--capture-tga") {
             config.captureFormat = Settings::CaptureFormat::TGA;
             arg.erase(arg.begin() + i);
@@ -97,6 +105,64 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.omitWindowNameInScreenshot = true;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "--record" && arg.size() > (i + 1)) {
+            config.recordingPath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--replay" && arg.size() > (i + 1)) {
+            config.replayPath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--replay-max-rate") {
+            config.replayAtMaxRate = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--cluster-statistics" && arg.size() > (i + 1)) {
+            config.clusterStatisticsPath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--stage-timings" && arg.size() > (i + 1)) {
+            config.stageTimingsPath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--stage-timings-interval" && arg.size() > (i + 1)) {
+            config.stageTimingsInterval = std::stod(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--trace" && arg.size() > (i + 1)) {
+            config.tracePath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--trace-frames" && arg.size() > (i + 1)) {
+            config.traceFrames = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--gpu-timings") {
+            config.useGpuTimings = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--count-allocations") {
+            config.countAllocations = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--headless" && arg.size() > (i + 1)) {
+            using Backend = Configuration::HeadlessBackend;
+            const Backend backend = [](std::string_view b) {
+                if (b == "egl")         { return Backend::EGL; }
+                else if (b == "osmesa") { return Backend::OSMesa; }
+                else {
+                    std::cerr << "Unknown headless backend: " << std::string(b);
+                    return Backend::EGL;
+                }
+            } (arg[i + 1]);
+            config.headless = backend;
+
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--max-frames" && arg.size() > (i + 1)) {
+            config.maxFrames = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
         else if (arg[i] == "-config") {
             // @DEPRECATED
             Log::Warning("Using -config has been deprecated in favor of -c or --config");
@@ -138,8 +204,12 @@ Parameters:
     Disable firm frame sync
 --ignore-sync
     Disable frame sync
+--network-reactor
+    Serve all network connections from a single epoll thread (Linux only)
 --notify <"error", "warning", "info", or "debug">
     Set the notify level used in the Log
+--log-file <filename>
+    Write the log messages into this file in addition to the console
 --capture-jpg
     Use jpg images for screen capture
 --capture-tga
@@ -156,6 +226,38 @@ Parameters:
     If set, screenshots will not contain the name of the window if multiple windows exist
 --number-capture-threads <integer>
     Set the maximum amount of thread that should be used during framecapture
+--record <filename>
+    Record the shared data that the master sends into a file
+--replay <filename>
+    Run a single node that decodes the shared data from a recording instead of the
+    master's encode function, at the rate at which the frames were recorded
+--replay-max-rate
+    Replay the recording as fast as possible instead of at the recorded rate
+--cluster-statistics <filename>
+    Write the timings that all nodes report to the master into a CSV file, marking the
+    node with the longest draw and decode time of each frame
+--stage-timings <filename>
+    Periodically append the timing statistics of each stage of the render loop to a
+    file, which is written as JSON lines if the extension is .json and as CSV otherwise
+--stage-timings-interval <seconds>
+    The time between two exports of the stage timings, 10 seconds by default
+--trace <filename>
+    Record the profiling zones of all threads and write the latest ones as a Chrome
+    trace when F12 is pressed, on SIGUSR1, or after the number of frames given by
+    --trace-frames. The node id and a running number are added to the file name
+--trace-frames <integer>
+    Write the trace once after this number of frames
+--gpu-timings
+    Measure the GPU time of each render pass even if the statistics are not shown
+--count-allocations
+    Count the heap allocations of the render thread in each frame and in each stage of
+    the render loop. This requires SGCT to be built with the allocation counter
+--headless <"egl" or "osmesa">
+    Run without a display by creating the contexts through EGL or OSMesa. The windows
+    are hidden and everything is rendered into their offscreen framebuffers. The final
+    warping pass is only rendered if the context provides a default framebuffer
+--max-frames <integer>
+    Exit after rendering this number of frames
 )";
 }
 
@@ -59,6 +59,31 @@ void validateCapture(const Capture& c) {
     }
 }
 
+void validateCompression(const Compression& c) {
+    ZoneScoped
+
+    if (c.threshold && *c.threshold < 0) {
+        throw Error(1015, "Compression threshold must not be negative");
+    }
+    if (c.keyframeInterval && *c.keyframeInterval <= 0) {
+        throw Error(1016, "Compression keyframe interval must be positive");
+    }
+}
+
+void validateMulticast(const Multicast& m) {
+    ZoneScoped
+
+    if (m.address.empty()) {
+        throw Error(1017, "Multicast address must not be empty");
+    }
+    if (m.port <= 0) {
+        throw Error(1018, "Multicast port must be positive");
+    }
+    if (m.interfaceAddress && m.interfaceAddress->empty()) {
+        throw Error(1019, "Multicast interface address must not be empty");
+    }
+}
+
 void validateScene(const Scene&) {}
 
 void validateSettings(const Settings& s) {
@@ -339,12 +364,27 @@ void validateCluster(const Cluster& c) {
     if (c.externalControlPort && *c.externalControlPort <= 0) {
         throw Error(1121, "Cluster external control port must be non-negative");
     }
+    if (c.dataTransferCache && c.dataTransferCache->empty()) {
+        throw Error(1131, "Cluster data transfer cache must not be empty");
+    }
+    if (c.syncSpinTime && *c.syncSpinTime < 0) {
+        throw Error(1132, "Cluster sync spin time must be non-negative");
+    }
+    if (c.renderAhead && *c.renderAhead < 0) {
+        throw Error(1133, "Cluster render ahead must be non-negative");
+    }
     if (c.scene) {
         validateScene(*c.scene);
     }
     if (c.capture) {
         validateCapture(*c.capture);
     }
+    if (c.compression) {
+        validateCompression(*c.compression);
+    }
+    if (c.multicast) {
+        validateMulticast(*c.multicast);
+    }
     if (c.settings) {
         validateSettings(*c.settings);
     }
@@ -450,6 +490,26 @@ void validateCluster(const Cluster& c) {
     if (std::unique(ports.begin(), ports.end()) != ports.end()) {
         throw Error(1128, "Two or more nodes are using the same port");
     }
+
+    const int nNodes = static_cast<int>(c.nodes.size());
+    for (int i = 0; i < nNodes; ++i) {
+        const std::optional<int>& parent = c.nodes[i].parent;
+        if (parent && (*parent < 0 || *parent >= nNodes || *parent == i)) {
+            throw Error(
+                1129,
+                fmt::format("Node {} has an invalid parent node {}", i, *parent)
+            );
+        }
+
+        // Walking up the tree must reach a root before we have visited every node
+        std::optional<int> p = parent;
+        for (int depth = 0; p; ++depth) {
+            if (depth == nNodes) {
+                throw Error(1130, fmt::format("Parent of node {} forms a cycle", i));
+            }
+            p = c.nodes[*p].parent;
+        }
+    }
 }
 
 } // namespace sgct::config
@@ -37,7 +37,7 @@ namespace sgct::correction {
 Buffer generateOBJMesh(const std::string& path) {
     ZoneScoped
 
-    Log::Info(fmt::format("Reading Wavefront OBJ mesh data from '{}'", path));
+    Log::Info("Reading Wavefront OBJ mesh data from '{}'", path);
 
     std::ifstream file(path);
     if (!file.good()) {
@@ -75,9 +75,9 @@ Buffer generateOBJMesh(const std::string& path) {
             std::string_view v3 = rest;
             float z = std::stof(std::string(v3));
             if (z != 0.f) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Vertex in '{}' was using z coordinate which is not supported", path
-                ));
+                );
             }
 
             Position p;
@@ -121,71 +121,57 @@ Buffer generateOBJMesh(const std::string& path) {
         }
         else if (first == "vn") {
             if (std::find(reported.begin(), reported.end(), "vn") == reported.end()) {
-                Log::Warning(fmt::format("Ignoring normals in mesh '{}'", path));
+                Log::Warning("Ignoring normals in mesh '{}'", path);
                 reported.push_back("vn");
             }
         }
         else if (first == "vp") {
             if (std::find(reported.begin(), reported.end(), "vp") == reported.end()) {
-                Log::Warning(
-                    fmt::format("Ignoring parameter space values in mesh '{}'", path)
-                );
+                Log::Warning("Ignoring parameter space values in mesh '{}'", path);
                 reported.push_back("vp");
             }
         }
         else if (first == "l") {
             if (std::find(reported.begin(), reported.end(), "l") == reported.end()) {
-                Log::Warning(
-                    fmt::format("Ignoring line elements in mesh '{}'", path)
-                );
+                Log::Warning("Ignoring line elements in mesh '{}'", path);
                 reported.push_back("l");
             }
         }
         else if (first == "mtllib") {
             if (std::find(reported.begin(), reported.end(), "mtllib") == reported.end()) {
-                Log::Warning(
-                    fmt::format("Ignoring material library in mesh '{}'", path)
-                );
+                Log::Warning("Ignoring material library in mesh '{}'", path);
                 reported.push_back("mtllib");
             }
         }
         else if (first == "usemtl") {
             if (std::find(reported.begin(), reported.end(), "usemtl") == reported.end()) {
-                Log::Warning(
-                    fmt::format("Ignoring material specification in mesh '{}'", path)
-                );
+                Log::Warning("Ignoring material specification in mesh '{}'", path);
                 reported.push_back("usemtl");
             }
         }
         else if (first == "o") {
             if (std::find(reported.begin(), reported.end(), "o") == reported.end()) {
-                Log::Warning(
-                    fmt::format("Ignoring object specification in mesh '{}'", path)
-                );
+                Log::Warning("Ignoring object specification in mesh '{}'", path);
                 reported.push_back("o");
             }
         }
         else if (first == "g") {
             if (std::find(reported.begin(), reported.end(), "g") == reported.end()) {
-                Log::Warning(
-                    fmt::format("Ignoring object group specification in mesh '{}'", path)
-                );
+                Log::Warning("Ignoring object group specification in mesh '{}'", path);
                 reported.push_back("g");
             }
         }
         else if (first == "s") {
             if (std::find(reported.begin(), reported.end(), "s") == reported.end()) {
-                Log::Warning(
-                    fmt::format("Ignoring shading specification in mesh '{}'", path)
-                );
+                Log::Warning("Ignoring shading specification in mesh '{}'", path);
                 reported.push_back("s");
             }
         }
         else {
             if (std::find(reported.begin(), reported.end(), first) == reported.end()) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Encounted unsupported value type '{}' in mesh '{}'", first, path
-                ));
+                );
                 reported.push_back(std::string(first));
             }
         }
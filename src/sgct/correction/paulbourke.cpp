@@ -26,7 +26,7 @@ Buffer generatePaulBourkeMesh(const std::string& path, const vec2& pos, const ve
 
     Buffer buf;
 
-    Log::Info(fmt::format("Reading Paul Bourke spherical mirror mesh from '{}'", path));
+    Log::Info("Reading Paul Bourke spherical mirror mesh from '{}'", path);
 
     FILE* meshFile = fopen(path.c_str(), "r");
     if (meshFile == nullptr) {
@@ -24,7 +24,7 @@ Buffer generatePerEyeMeshFromPFMImage(const std::string& path, const vec2& pos,
 
     Buffer buf;
 
-    Log::Info(fmt::format("Reading 3D/stereo mesh data (in PFM image) from '{}'", path));
+    Log::Info("Reading 3D/stereo mesh data (in PFM image) from '{}'", path);
 
     FILE* meshFile = fopen(path.c_str(), "rb");
     if (meshFile == nullptr) {
@@ -106,7 +106,7 @@ namespace sgct::correction {
 Buffer generateScalableMesh(const std::string& path, BaseViewport& parent) {
     ZoneScoped
 
-    Log::Info(fmt::format("Reading scalable mesh data from '{}'", path));
+    Log::Info("Reading scalable mesh data from '{}'", path);
 
     std::ifstream file(path);
     if (!file.good()) {
@@ -129,10 +129,10 @@ Buffer generateScalableMesh(const std::string& path, BaseViewport& parent) {
 
         if (first == "OPENMESH") {
             if (rest != "Version 1.1") {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Found {} in mesh '{}' but expected Version 1.1 so the loading might "
                     "misbehave", rest, path
-                ));
+                );
             }
         }
         else if (first == "VERTICES") {
@@ -145,26 +145,26 @@ Buffer generateScalableMesh(const std::string& path, BaseViewport& parent) {
         }
         else if (first == "MAPPING") {
             if (rest != "NORMALIZED") {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Found mapping '{}' in mesh '{}' but only 'NORMALIZED' is supported",
                     rest, path
-                ));
+                );
             }
         }
         else if (first == "SAMPLING") {
             if (rest != "LINEAR") {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Found sampling '{}' in mesh '{}' but only 'LINEAR' is supported",
                     rest, path
-                ));
+                );
             }
         }
         else if (first == "PROJECTION") {
             if (rest != "PERSPECTIVE") {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Found projection '{}' in mesh '{}' but only 'PERSPECTIVE' is "
                     "supported", rest, path
-                ));
+                );
             }
         }
         else if (first == "ORTHO_LEFT") {
@@ -225,20 +225,20 @@ Buffer generateScalableMesh(const std::string& path, BaseViewport& parent) {
         else if (first == "SUBVERSION") {
             int version = std::stoi(std::string(rest));
             if (version != 5) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Found subversion {} in mesh '{}' but only version 5 is tested",
                     version, path
-                ));
+                );
             }
         }
         else if (first == "GAMMA") {
             float gamma = std::stof(std::string(rest));
             if (gamma != data.gamma) {
                 data.gamma = gamma;
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Found GAMMA value of {} in mesh '{}' we don't not support "
                     "per-viewport gamma values", data.gamma, path
-                ));
+                );
             }
         }
         else if (first == "DO_NO_WARP") {
@@ -247,19 +247,19 @@ Buffer generateScalableMesh(const std::string& path, BaseViewport& parent) {
         else if (first == "USE_SPHERE_SAMPLE_COORDINATE_SYSTEM") {
             bool useSphereSampling = std::stoi(std::string(rest)) != 0;
             if (useSphereSampling) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Found request to use Sphere Sample Coordinate System in mesh '{}' "
                     "but we don't support this", path
-                ));
+                );
             }
         }
         else if (first == "FRUSTUM_EULER_ANGLES") {
             data.frustumEulerAngles.useAngles = std::stoi(std::string(rest)) != 0;
             if (data.frustumEulerAngles.useAngles) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Enabled frustum euler angles in mesh '{}' but we don't know how "
                     "these work, yet", path
-                ));
+                );
             }
         }
         else if (first == "FRUSTUM_EULER_YAW") {
@@ -277,31 +277,31 @@ Buffer generateScalableMesh(const std::string& path, BaseViewport& parent) {
         else if (first == "APPLY_MASK") {
             data.applyMask = std::stoi(std::string(rest));
             if (data.applyMask) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Mesh '{}' requested to apply a mask. Currently this is handled "
                     "outside the mesh by specifying a 'mask' attribute on the 'Viewport' "
                     "instead", path
-                ));
+                );
             }
         }
         else if (first == "APPLY_BLACK_LEVEL") {
             data.applyBlackLevel = std::stoi(std::string(rest));
             if (data.applyBlackLevel) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Mesh '{}' requested to apply a blacklevel image. Currently this is "
                     "handled outside the mesh by specifying a 'BlackLevelMask' attribute "
                     "on the 'Viewport' instead", path
-                ));
+                );
             }
         }
         else if (first == "APPLY_COLOR") {
             data.applyColor = std::stoi(std::string(rest));
             if (data.applyBlackLevel) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Mesh '{}' requested to apply an overlay image. Currently this is "
                     "handled outside the mesh by specifying an 'overlay' attribute on "
                     "the 'Viewport' instead", path
-                ));
+                );
             }
         }
         else if (first == "[") {
@@ -331,11 +331,11 @@ Buffer generateScalableMesh(const std::string& path, BaseViewport& parent) {
                 [[ maybe_unused ]] float dummy = std::stof(std::string(first));
             }
             catch (const std::invalid_argument&) {
-                Log::Warning(fmt::format(
+                Log::Warning(
                     "Unknown key {} found in scalable mesh '{}'. Please report usage of "
                     "this key, preferably with an example, to the SGCT developers",
                     first, path
-                ));
+                );
                 continue;
             }
 
@@ -57,7 +57,7 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
 
     Buffer buf;
 
-    Log::Info(fmt::format("Reading SCISS mesh data from '{}'", path));
+    Log::Info("Reading SCISS mesh data from '{}'", path);
 
     FILE* file = fopen(path.c_str(), "rb");
     if (file == nullptr) {
@@ -81,7 +81,7 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
         throw Error(2072, fmt::format("Error parsing file version from file '{}'", path));
     }
 
-    Log::Debug(fmt::format("SCISS file version {}", fileVersion));
+    Log::Debug("SCISS file version {}", fileVersion);
 
     // read mapping type
     unsigned int type;
@@ -91,9 +91,7 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
         throw Error(2073, fmt::format("Error parsing type from file '{}'", path));
     }
 
-    Log::Debug(fmt::format(
-        "Mapping type: {} ({})", type == 0 ? "planar" : "cube", type)
-    );
+    Log::Debug("Mapping type: {} ({})", type == 0 ? "planar" : "cube", type);
 
     // read viewdata
     SCISSViewData viewData;
@@ -115,17 +113,17 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
     double pitch = angles.y;
     double roll = -angles.z;
 
-    Log::Debug(fmt::format(
+    Log::Debug(
         "Rotation quat = [{} {} {} {}]. yaw = {}, pitch = {}, roll = {}",
-        viewData.qx, viewData.qy, viewData.qz, viewData.qw, yaw, pitch, roll)
+        viewData.qx, viewData.qy, viewData.qz, viewData.qw, yaw, pitch, roll
     );
 
-    Log::Debug(fmt::format("Position: {} {} {}", viewData.x, viewData.y, viewData.z));
+    Log::Debug("Position: {} {} {}", viewData.x, viewData.y, viewData.z);
 
-    Log::Debug(fmt::format(
+    Log::Debug(
         "FOV: (up {}) (down {}) (left {}) (right {})",
         viewData.fovUp, viewData.fovDown, viewData.fovLeft, viewData.fovRight
-    ));
+    );
 
     // read number of vertices
     unsigned int size[2];
@@ -138,13 +136,11 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
     unsigned int nVertices = 0;
     if (fileVersion == 2) {
         nVertices = size[1];
-        Log::Debug(fmt::format("Number of vertices: {}", nVertices));
+        Log::Debug("Number of vertices: {}", nVertices);
     }
     else {
         nVertices = size[0] * size[1];
-        Log::Debug(fmt::format(
-            "Number of vertices: {} ({}x{})", nVertices, size[0], size[1]
-        ));
+        Log::Debug("Number of vertices: {} ({}x{})", nVertices, size[0], size[1]);
     }
     // read vertices
     std::vector<SCISSTexturedVertex> texturedVertexList(nVertices);
@@ -166,7 +162,7 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
         fclose(file);
         throw Error(2077, fmt::format("Error parsing indices from file '{}'", path));
     }
-    Log::Debug(fmt::format("Number of indices: {}", nIndices));
+    Log::Debug("Number of indices: {}", nIndices);
 
     // read faces
     if (nIndices > 0) {
@@ -43,7 +43,7 @@ Buffer generateSimCADMesh(const std::string& path, const vec2& pos, const vec2&
 
     Buffer buf;
 
-    Log::Info(fmt::format("Reading simcad warp data from '{}'", path));
+    Log::Info("Reading simcad warp data from '{}'", path);
 
     tinyxml2::XMLDocument xmlDoc;
     if (xmlDoc.LoadFile(path.c_str()) != tinyxml2::XML_SUCCESS) {
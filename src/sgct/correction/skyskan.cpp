@@ -39,7 +39,7 @@ Buffer generateSkySkanMesh(const std::string& path, BaseViewport& parent) {
 
     Buffer buf;
 
-    Log::Info(fmt::format("Reading SkySkan mesh data from '{}'", path));
+    Log::Info("Reading SkySkan mesh data from '{}'", path);
 
     FILE* meshFile = fopen(path.c_str(), "r");
     if (meshFile == nullptr) {
@@ -125,7 +125,7 @@ Buffer generateSkySkanMesh(const std::string& path, BaseViewport& parent) {
         const float hh = (1200.f / 2048.f) * hw;
         vFov = 2.f * glm::degrees<float>(atan(hh));
 
-        Log::Info(fmt::format("HFOV: {} VFOV: {}", *hFov, *vFov));
+        Log::Info("HFOV: {} VFOV: {}", *hFov, *vFov);
     }
 
     if (fovTweaks.x > 0.f) {
@@ -153,7 +153,7 @@ void exportMesh(GLenum type, const std::string& path, const correction::Buffer&
         }
     }
 
-    Log::Info(fmt::format("Mesh '{}' exported successfully", path));
+    Log::Info("Mesh '{}' exported successfully", path);
 }
 
 } // namespace
@@ -259,10 +259,10 @@ void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
 
     createMesh(_warpGeometry, buf);
 
-    Log::Debug(fmt::format(
+    Log::Debug(
         "CorrectionMesh read successfully. Vertices={}, Indices={}",
         buf.vertices.size(), buf.indices.size()
-    ));
+    );
 
     if (Settings::instance().exportWarpingMeshes()) {
         const size_t found = path.find_last_of('.');
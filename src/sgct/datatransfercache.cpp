@@ -0,0 +1,165 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/datatransfercache.h>
+
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <zlib.h>
+#include <fstream>
+#include <system_error>
+
+#ifdef WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define VC_EXTRALEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    constexpr const uint64_t FnvOffsetBasis = 14695981039346656037ull;
+    constexpr const uint64_t FnvPrime = 1099511628211ull;
+} // namespace
+
+namespace sgct {
+
+bool DataTransferCache::Key::operator==(const Key& rhs) const {
+    return hash == rhs.hash && checksum == rhs.checksum && size == rhs.size;
+}
+
+DataTransferCache::Key DataTransferCache::key(const char* data, uint32_t size) {
+    ZoneScoped
+
+    Key res;
+    res.hash = FnvOffsetBasis;
+    for (uint32_t i = 0; i < size; i++) {
+        res.hash ^= static_cast<uint8_t>(data[i]);
+        res.hash *= FnvPrime;
+    }
+    res.checksum = crc32(0, reinterpret_cast<const Bytef*>(data), size);
+    res.size = size;
+    return res;
+}
+
+DataTransferCache::DataTransferCache(std::filesystem::path directory)
+    : _directory(std::move(directory))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(_directory, ec);
+    if (ec) {
+        Log::Warning(
+            "Failed to create data transfer cache {}: {}", _directory.string(),
+            ec.message()
+        );
+    }
+    else {
+        Log::Info("Using data transfer cache {}", _directory.string());
+    }
+}
+
+bool DataTransferCache::load(const Key& key,
+                             const std::function<void(char*, uint32_t)>& function) const
+{
+    ZoneScoped
+
+    const std::filesystem::path p = path(key);
+    std::error_code ec;
+    if (std::filesystem::file_size(p, ec) != key.size || ec) {
+        return false;
+    }
+
+    if (key.size == 0) {
+        char empty = 0;
+        function(&empty, 0);
+        return true;
+    }
+
+#ifdef WIN32
+    HANDLE file = CreateFileW(
+        p.wstring().c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, key.size);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    function(reinterpret_cast<char*>(data), key.size);
+
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    CloseHandle(file);
+#else // WIN32
+    const int fd = open(p.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    void* data = mmap(nullptr, key.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    function(reinterpret_cast<char*>(data), key.size);
+
+    munmap(data, key.size);
+#endif // WIN32
+    return true;
+}
+
+void DataTransferCache::store(const Key& key, const char* data, uint32_t size) const {
+    ZoneScoped
+
+    // Write to a temporary file first so that an interrupted write never leaves a
+    // truncated package behind under the final name
+    const std::filesystem::path p = path(key);
+    std::filesystem::path tmp = p;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        file.write(data, size);
+        if (!file) {
+            Log::Warning("Failed to write cache file {}", tmp.string());
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, p, ec);
+    if (ec) {
+        Log::Warning("Failed to store cache file {}: {}", p.string(), ec.message());
+        std::filesystem::remove(tmp, ec);
+    }
+}
+
+std::filesystem::path DataTransferCache::path(const Key& key) const {
+    return _directory / fmt::format("{:016x}{:08x}-{}", key.hash, key.checksum, key.size);
+}
+
+} // namespace sgct
@@ -0,0 +1,73 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/datatransferdecoder.h>
+
+#include <sgct/profiling.h>
+
+namespace sgct {
+
+DataTransferDecoder::DataTransferDecoder(std::function<void(void*, int, int, int)> decode)
+    : _decodeFn(std::move(decode))
+{
+    _thread = std::thread([this]() { run(); });
+}
+
+DataTransferDecoder::~DataTransferDecoder() {
+    {
+        std::unique_lock lock(_mutex);
+        _shouldTerminate = true;
+    }
+    _cond.notify_all();
+    _thread.join();
+}
+
+void DataTransferDecoder::push(std::vector<char> data, int packageId, int connectionId) {
+    {
+        std::unique_lock lock(_mutex);
+        _queue.push_back({ std::move(data), packageId, connectionId });
+    }
+    _cond.notify_one();
+}
+
+void DataTransferDecoder::clear() {
+    std::unique_lock decodeLock(_decodeMutex);
+    std::unique_lock lock(_mutex);
+    _queue.clear();
+    _decodeFn = nullptr;
+}
+
+void DataTransferDecoder::run() {
+    std::unique_lock lock(_mutex);
+    while (!_shouldTerminate) {
+        if (_queue.empty()) {
+            _cond.wait(lock);
+            continue;
+        }
+
+        Package package = std::move(_queue.front());
+        _queue.pop_front();
+        lock.unlock();
+        {
+            ZoneScopedN("Decode data transfer package")
+
+            std::unique_lock decodeLock(_decodeMutex);
+            if (_decodeFn) {
+                _decodeFn(
+                    package.data.data(),
+                    static_cast<int>(package.data.size()),
+                    package.id,
+                    package.connectionId
+                );
+            }
+        }
+        lock.lock();
+    }
+}
+
+} // namespace sgct
@@ -0,0 +1,368 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/datatransferqueue.h>
+
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/network.h>
+#include <sgct/profiling.h>
+#include <zlib.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+    // Large enough to keep the per-chunk overhead negligible and small enough that the
+    // chunks of several packages interleave finely
+    constexpr const uint32_t ChunkSize = 256 * 1024;
+
+    // The maximum number of unacknowledged chunks per connection. With the chunk size
+    // above this allows for 4 MB in flight, enough to saturate a 10 Gbit link at a
+    // round-trip time of 3 ms
+    constexpr const uint32_t MaxChunksInFlight = 16;
+
+    // Offset of the chunk, size of the package, uncompressed size of the package
+    constexpr const uint32_t ChunkHeaderSize = 3 * sizeof(uint32_t);
+
+    // Hash, checksum, and size of the package
+    constexpr const uint32_t OfferSize = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+    // Transfers to connections that were lost are never acknowledged, so the sending
+    // thread wakes up regularly to remove them
+    constexpr const std::chrono::milliseconds CleanupInterval(100);
+} // namespace
+
+namespace sgct {
+
+DataTransferQueue::DataTransferQueue(std::function<void(int, int)> acknowledge,
+                                     std::function<void(int, int, float)> progress,
+                                     bool useCompression, int compressionThreshold,
+                                     bool useCache)
+    : _acknowledgeFn(std::move(acknowledge))
+    , _progressFn(std::move(progress))
+    , _useCompression(useCompression)
+    , _compressionThreshold(compressionThreshold)
+    , _useCache(useCache)
+{
+    _thread = std::thread([this]() { run(); });
+}
+
+DataTransferQueue::~DataTransferQueue() {
+    {
+        std::unique_lock lock(_mutex);
+        _shouldTerminate = true;
+    }
+    _cond.notify_all();
+    _thread.join();
+}
+
+void DataTransferQueue::push(std::vector<char> data, int packageId,
+                             std::vector<Network*> connections)
+{
+    ZoneScoped
+
+    if (connections.empty()) {
+        return;
+    }
+
+    auto package = std::make_shared<Package>();
+    package->id = packageId;
+    package->data = std::move(data);
+    {
+        std::unique_lock lock(_mutex);
+        _queue.push_back({ std::move(package), std::move(connections) });
+    }
+    _cond.notify_one();
+}
+
+void DataTransferQueue::acknowledge(int packageId, const Network& connection) {
+    std::unique_lock lock(_mutex);
+    const auto it = std::find_if(
+        _transfers.begin(),
+        _transfers.end(),
+        [&](const std::shared_ptr<Transfer>& t) {
+            return t->package->id == packageId && t->connection == &connection &&
+                   t->state == Transfer::State::Send && t->nAcknowledged < t->nSent;
+        }
+    );
+    if (it == _transfers.end()) {
+        // The transfer was dropped because the connection was lost in the meantime
+        return;
+    }
+
+    Transfer& transfer = **it;
+    transfer.nAcknowledged++;
+    const uint32_t nChunks = transfer.package->nChunks;
+    const float progress = static_cast<float>(transfer.nAcknowledged) / nChunks;
+    const bool isComplete = transfer.nAcknowledged == nChunks;
+    if (isComplete) {
+        _transfers.erase(it);
+    }
+    lock.unlock();
+    _cond.notify_one();
+
+    // The callbacks are called without the lock so that they can queue new packages
+    if (_progressFn) {
+        _progressFn(packageId, connection.id(), progress);
+    }
+    if (isComplete && _acknowledgeFn) {
+        _acknowledgeFn(packageId, connection.id());
+    }
+}
+
+void DataTransferQueue::offerReply(int packageId, const Network& connection,
+                                   bool isCached)
+{
+    std::unique_lock lock(_mutex);
+    const auto it = std::find_if(
+        _transfers.begin(),
+        _transfers.end(),
+        [&](const std::shared_ptr<Transfer>& t) {
+            return t->package->id == packageId && t->connection == &connection &&
+                   t->state == Transfer::State::WaitingForReply;
+        }
+    );
+    if (it == _transfers.end()) {
+        return;
+    }
+
+    if (!isCached) {
+        (*it)->state = Transfer::State::Send;
+        lock.unlock();
+        _cond.notify_one();
+        return;
+    }
+
+    // The receiver has already decoded the package from its cache
+    _transfers.erase(it);
+    lock.unlock();
+    if (_progressFn) {
+        _progressFn(packageId, connection.id(), 1.f);
+    }
+    if (_acknowledgeFn) {
+        _acknowledgeFn(packageId, connection.id());
+    }
+}
+
+void DataTransferQueue::run() {
+    std::unique_lock lock(_mutex);
+    while (!_shouldTerminate) {
+        if (!_queue.empty()) {
+            QueuedPackage queued = std::move(_queue.front());
+            _queue.erase(_queue.begin());
+
+            lock.unlock();
+            prepare(*queued.package);
+            lock.lock();
+
+            for (Network* connection : queued.connections) {
+                auto transfer = std::make_shared<Transfer>();
+                transfer->package = queued.package;
+                transfer->connection = connection;
+                transfer->state =
+                    _useCache ? Transfer::State::Offer : Transfer::State::Send;
+                _transfers.push_back(std::move(transfer));
+            }
+            continue;
+        }
+
+        std::shared_ptr<Transfer> transfer = nextTransfer();
+        if (!transfer) {
+            _cond.wait_for(lock, CleanupInterval);
+            continue;
+        }
+
+        const bool isOffer = transfer->state == Transfer::State::Offer;
+        const uint32_t index = transfer->nSent;
+        if (isOffer) {
+            transfer->state = Transfer::State::WaitingForReply;
+        }
+        else {
+            transfer->nSent++;
+        }
+        lock.unlock();
+        try {
+            if (isOffer) {
+                sendOffer(*transfer);
+            }
+            else {
+                sendChunk(*transfer, index);
+            }
+        }
+        catch (const std::runtime_error& e) {
+            // The chunk or offer was not sent, so the transfer could never complete
+            Log::Error(
+                "Dropping data transfer package {} for connection {}: {}",
+                transfer->package->id, transfer->connection->id(), e.what()
+            );
+            lock.lock();
+            _transfers.erase(
+                std::remove(_transfers.begin(), _transfers.end(), transfer),
+                _transfers.end()
+            );
+            continue;
+        }
+        lock.lock();
+    }
+}
+
+void DataTransferQueue::prepare(Package& package) const {
+    ZoneScoped
+
+    const uLong size = static_cast<uLong>(package.data.size());
+    if (_useCache) {
+        package.key = DataTransferCache::key(package.data.data(), size);
+    }
+
+    if (_useCompression && size >= static_cast<uLong>(_compressionThreshold)) {
+        ZoneScopedN("Compress")
+
+        // Bulk transfers are not latency-critical, so use zlib's default ratio
+        uLongf compressedSize = compressBound(size);
+        std::vector<char> compressed(compressedSize);
+        const int err = compress2(
+            reinterpret_cast<Bytef*>(compressed.data()),
+            &compressedSize,
+            reinterpret_cast<const Bytef*>(package.data.data()),
+            size,
+            Z_DEFAULT_COMPRESSION
+        );
+        if (err != Z_OK) {
+            Log::Error(
+                "Failed to compress data transfer package {}: {}", package.id, err
+            );
+        }
+        // Only use the compressed data if it actually saves bandwidth
+        else if (compressedSize < size) {
+            compressed.resize(compressedSize);
+            package.data = std::move(compressed);
+            package.uncompressedSize = static_cast<uint32_t>(size);
+        }
+    }
+
+    // Even an empty package is sent as a single chunk so that it is acknowledged
+    const uint32_t dataSize = static_cast<uint32_t>(package.data.size());
+    package.nChunks = std::max(1u, (dataSize + ChunkSize - 1) / ChunkSize);
+}
+
+std::shared_ptr<DataTransferQueue::Transfer> DataTransferQueue::nextTransfer() {
+    _transfers.erase(
+        std::remove_if(
+            _transfers.begin(),
+            _transfers.end(),
+            [](const std::shared_ptr<Transfer>& t) {
+                if (t->connection->isConnected()) {
+                    return false;
+                }
+                Log::Warning(
+                    "Dropping data transfer package {} as connection {} was lost",
+                    t->package->id, t->connection->id()
+                );
+                return true;
+            }
+        ),
+        _transfers.end()
+    );
+
+    auto inFlight = [this](const Network* connection) {
+        uint32_t n = 0;
+        for (const std::shared_ptr<Transfer>& t : _transfers) {
+            if (t->connection == connection) {
+                n += t->nSent - t->nAcknowledged;
+            }
+        }
+        return n;
+    };
+
+    // The receiver assembles the chunks of a package by its id, so packages with the
+    // same id are sent to a connection one after the other. The transfers are kept in
+    // the order in which they were queued, so an earlier one has to complete first
+    auto isWaitingForEarlierTransfer = [this](size_t idx) {
+        const Transfer& t = *_transfers[idx];
+        for (size_t i = 0; i < idx; i++) {
+            const Transfer& earlier = *_transfers[i];
+            if (earlier.connection == t.connection &&
+                earlier.package->id == t.package->id)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Continue after the transfer that sent the last chunk to interleave the packages
+    for (size_t i = 0; i < _transfers.size(); i++) {
+        const size_t idx = (_nextTransfer + i) % _transfers.size();
+        const std::shared_ptr<Transfer>& t = _transfers[idx];
+        if (isWaitingForEarlierTransfer(idx)) {
+            continue;
+        }
+        const bool canSend = t->state == Transfer::State::Send &&
+                             t->nSent < t->package->nChunks &&
+                             inFlight(t->connection) < MaxChunksInFlight;
+        if (t->state == Transfer::State::Offer || canSend) {
+            _nextTransfer = idx + 1;
+            return t;
+        }
+    }
+    return nullptr;
+}
+
+void DataTransferQueue::sendOffer(const Transfer& transfer) {
+    ZoneScoped
+
+    const DataTransferCache::Key& key = transfer.package->key;
+    const uint32_t messageSize = OfferSize;
+    const uint32_t unused = 0;
+
+    std::array<char, Network::HeaderSize + OfferSize> buffer;
+    char* p = buffer.data();
+    p[0] = Network::DataOfferId;
+    std::memcpy(p + 1, &transfer.package->id, sizeof(int32_t));
+    std::memcpy(p + 5, &messageSize, sizeof(uint32_t));
+    std::memcpy(p + 9, &unused, sizeof(uint32_t));
+    p += Network::HeaderSize;
+    std::memcpy(p, &key.hash, sizeof(key.hash));
+    std::memcpy(p + 8, &key.checksum, sizeof(key.checksum));
+    std::memcpy(p + 12, &key.size, sizeof(key.size));
+
+    transfer.connection->sendData(buffer.data(), static_cast<int>(buffer.size()));
+}
+
+void DataTransferQueue::sendChunk(const Transfer& transfer, uint32_t index) {
+    ZoneScoped
+
+    const Package& package = *transfer.package;
+    const uint32_t totalSize = static_cast<uint32_t>(package.data.size());
+    const uint32_t offset = index * ChunkSize;
+    const uint32_t length = std::min(totalSize - offset, ChunkSize);
+    const uint32_t messageSize = ChunkHeaderSize + length;
+    const uint32_t unused = 0;
+
+    // Only the headers are written here, the chunk is sent directly from the package
+    std::array<char, Network::HeaderSize + ChunkHeaderSize> header;
+    char* p = header.data();
+    p[0] = Network::DataChunkId;
+    std::memcpy(p + 1, &package.id, sizeof(int32_t));
+    std::memcpy(p + 5, &messageSize, sizeof(uint32_t));
+    std::memcpy(p + 9, &unused, sizeof(uint32_t));
+    p += Network::HeaderSize;
+    std::memcpy(p, &offset, sizeof(uint32_t));
+    std::memcpy(p + 4, &totalSize, sizeof(uint32_t));
+    std::memcpy(p + 8, &package.uncompressedSize, sizeof(uint32_t));
+
+    transfer.connection->sendData(
+        header.data(),
+        static_cast<int>(header.size()),
+        package.data.data() + offset,
+        static_cast<int>(length)
+    );
+}
+
+} // namespace sgct
@@ -7,6 +7,8 @@
  ****************************************************************************************/
 
 #include <sgct/engine.h>
+#include <sgct/allocationcounter.h>
+#include <sgct/clusterclock.h>
 #include <sgct/clustermanager.h>
 #include <sgct/commandline.h>
 #include <sgct/error.h>
@@ -15,6 +17,7 @@
 #include <sgct/fontmanager.h>
 #include <sgct/freetype.h>
 #include <sgct/internalshaders.h>
+#include <sgct/mutexes.h>
 #include <sgct/networkmanager.h>
 #include <sgct/node.h>
 #include <sgct/offscreenbuffer.h>
@@ -23,8 +26,11 @@
 #include <sgct/screencapture.h>
 #include <sgct/shadermanager.h>
 #include <sgct/shareddata.h>
+#include <sgct/stagetimings.h>
 #include <sgct/statisticsrenderer.h>
+#include <sgct/syncrecording.h>
 #include <sgct/texturemanager.h>
+#include <sgct/tracerecorder.h>
 #ifdef SGCT_HAS_VRPN
 #include <sgct/trackingmanager.h>
 #endif
@@ -32,6 +38,9 @@
 #include <sgct/version.h>
 #include <sgct/projection/nonlinearprojection.h>
 #include <cassert>
+#include <chrono>
+#include <csignal>
+#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <cmath>
@@ -50,17 +59,14 @@
 namespace sgct {
 
 namespace {
-    constexpr const bool RunFrameLockCheckThread = true;
-    constexpr const std::chrono::milliseconds FrameLockTimeout(100);
+    // Interval in which the waiting for sync messages is reported
+    constexpr const std::chrono::seconds SyncMessageInterval(1);
 
     constexpr const float FxaaSubPixTrim = 1.f / 4.f;
     constexpr const float FxaaSubPixOffset = 1.f / 2.f;
 
     enum class BufferMode { BackBufferBlack, RenderToTexture };
 
-    bool sRunUpdateFrameLockLoop = true;
-    std::mutex FrameSync;
-
     // Callback wrappers for GLFW
     std::function<void(Key, Modifier, Action, int)> gKeyboardCallback = nullptr;
     std::function<void(unsigned int, int)> gCharCallback = nullptr;
@@ -69,25 +75,30 @@ namespace {
     std::function<void(double, double)> gMouseScrollCallback = nullptr;
     std::function<void(int, const char**)> gDropCallback = nullptr;
 
-    // For feedback: breaks a frame lock wait condition every time interval
-    // (FrameLockTimeout) in order to print waiting message.
-    void updateFrameLockLoop(void*) {
-        bool run = true;
-
-        while (run) {
-            FrameSync.lock();
-            run = sRunUpdateFrameLockLoop;
-            FrameSync.unlock();
-            NetworkManager::cond.notify_all();
-            std::this_thread::sleep_for(FrameLockTimeout);
-        }
-    }
-
-    void addValue(std::array<double, Engine::Statistics::HistoryLength>& a, double v) {
+    // The value does not take part in the deduction so that it is converted to the type
+    // of the history
+    template <typename T>
+    void addValue(std::array<T, Engine::Statistics::HistoryLength>& a,
+                  std::common_type_t<T> v)
+    {
         std::rotate(std::rbegin(a), std::rbegin(a) + 1, std::rend(a));
         a[0] = v;
     }
 
+    double percentile(const std::array<double, Engine::Statistics::HistoryLength>& a,
+                      unsigned int nValues, double p)
+    {
+        // The history might not be filled yet
+        const size_t n = std::min<size_t>(nValues, a.size());
+        if (n == 0) {
+            return 0.0;
+        }
+        std::array<double, Engine::Statistics::HistoryLength> sorted = a;
+        std::sort(sorted.begin(), sorted.begin() + n);
+        const size_t rank = static_cast<size_t>(std::ceil(p * n));
+        return sorted[std::clamp<size_t>(rank, 1, n) - 1];
+    }
+
     void setAndClearBuffer(Window& window, BufferMode buffer, Frustum::Mode frustum) {
         ZoneScoped
 
@@ -213,6 +224,14 @@ double Engine::Statistics::Statistics::maxDt() const {
     return *std::max_element(frametimes.begin(), frametimes.end());
 }
 
+double Engine::Statistics::swapSkewP50() const {
+    return percentile(swapSkews, nSwapSkews, 0.5);
+}
+
+double Engine::Statistics::swapSkewP99() const {
+    return percentile(swapSkews, nSwapSkews, 0.99);
+}
+
 Engine* Engine::_instance = nullptr;
 
 Engine& Engine::instance() {
@@ -316,6 +335,8 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
 
     SharedData::instance().setEncodeFunction(std::move(callbacks.encode));
     SharedData::instance().setDecodeFunction(std::move(callbacks.decode));
+    SharedData::instance().setEncodeInPlaceFunction(std::move(callbacks.encodeInPlace));
+    SharedData::instance().setDecodeInPlaceFunction(std::move(callbacks.decodeInPlace));
 
     gKeyboardCallback = std::move(callbacks.keyboard);
     gCharCallback = std::move(callbacks.character);
@@ -333,6 +354,9 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
     if (config.logLevel) {
         Log::instance().setNotifyLevel(*config.logLevel);
     }
+    if (config.logFilePath) {
+        Log::instance().setLogFile(*config.logFilePath);
+    }
     if (config.showHelpText) {
         std::cout << helpMessage() << std::endl;
         std::exit(0);
@@ -381,24 +405,53 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
         glfwSetErrorCallback([](int error, const char* desc) {
             throw Err(3010, fmt::format("GLFW error ({}): {}", error, desc));
         });
+        if (config.headless) {
+            // Without a display, the windows are created on GLFW's null platform
+#ifdef GLFW_PLATFORM_NULL
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+            _isHeadless = true;
+#else // GLFW_PLATFORM_NULL
+            throw Err(
+                3011,
+                "Headless mode requires GLFW 3.4 or later with the null platform"
+            );
+#endif // GLFW_PLATFORM_NULL
+        }
         const int res = glfwInit();
         if (res == GLFW_FALSE) {
             throw Err(3000, "Failed to initialize GLFW");
         }
     }
+    _maxFrames = config.maxFrames;
 
-    Log::Info(fmt::format("SGCT version: {}", Version));
+    Log::Info("SGCT version: {}", Version);
 
     Log::Debug("Validating cluster configuration");
     config::validateCluster(cluster);
 
+    if (config.replayPath) {
+        // The recording takes the place of the master, so there must not be any clients
+        if (cluster.nodes.size() != 1) {
+            throw Err(
+                3007,
+                "Replaying a recording requires a cluster with a single node"
+            );
+        }
+        _replay = std::make_unique<SyncPlayer>(*config.replayPath);
+        _replayAtMaxRate = config.replayAtMaxRate.value_or(false);
+    }
+    if (config.recordingPath) {
+        SharedData::instance().startRecording(*config.recordingPath);
+    }
+
     NetworkManager::create(
         netMode,
         std::move(callbacks.externalDecode),
         std::move(callbacks.externalStatus),
         std::move(callbacks.dataTransferDecode),
         std::move(callbacks.dataTransferStatus),
-        std::move(callbacks.dataTransferAcknowledge)
+        std::move(callbacks.dataTransferAcknowledge),
+        std::move(callbacks.dataTransferProgress)
     );
 #ifdef SGCT_HAS_VRPN
     for (const config::Tracker& tracker : cluster.trackers) {
@@ -413,7 +466,7 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
         for (size_t i = 0; i < cluster.nodes.size(); ++i) {
             if (NetworkManager::instance().matchesAddress(cluster.nodes[i].address)) {
                 clusterId = static_cast<int>(i);
-                Log::Debug(fmt::format("Running in cluster mode as node {}", i));
+                Log::Debug("Running in cluster mode as node {}", i);
                 break;
             }
         }
@@ -427,7 +480,7 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
                 );
             }
             clusterId = *config.nodeId;
-            Log::Debug(fmt::format("Running locally as node {}", clusterId));
+            Log::Debug("Running locally as node {}", clusterId);
         }
         else {
             throw Err(3002, "When running locally, a node ID needs to be specified");
@@ -440,7 +493,96 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
     }
 
     ClusterManager::create(cluster, clusterId);
+    if (_isHeadless) {
+        using Backend = Configuration::HeadlessBackend;
+        const bool isEGL = *config.headless == Backend::EGL;
+        glfwWindowHint(
+            GLFW_CONTEXT_CREATION_API,
+            isEGL ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API
+        );
+        Log::Info("Running headless with {} contexts", isEGL ? "EGL" : "OSMesa");
+
+        // The windows only provide the contexts, so the frames are rendered into their
+        // offscreen framebuffers
+        Node& node = ClusterManager::instance().thisNode();
+        for (const std::unique_ptr<Window>& window : node.windows()) {
+            window->setFullscreen(false);
+            window->setVisible(false);
+            window->setRenderWhileHidden(true);
+        }
+    }
+    if (config.useNetworkReactor) {
+        ClusterManager::instance().setUseNetworkReactor(*config.useNetworkReactor);
+    }
     NetworkManager::instance().initialize();
+
+    _statistics.slowestNodes.fill(-1);
+    if (isMaster()) {
+        _statistics.nodeTimes.resize(cluster.nodes.size());
+    }
+    if (config.clusterStatisticsPath && isMaster()) {
+        _clusterStatisticsFile = std::make_unique<std::ofstream>(
+            *config.clusterStatisticsPath
+        );
+        if (!_clusterStatisticsFile->good()) {
+            NetworkManager::destroy();
+            throw Err(
+                3008,
+                fmt::format(
+                    "Failed to open cluster statistics file {}",
+                    *config.clusterStatisticsPath
+                )
+            );
+        }
+        *_clusterStatisticsFile <<
+            "frame,node,frameTime,drawTime,decodeTime,syncTime,swapTime,isSlowest\n";
+    }
+
+    if (config.countAllocations) {
+        if (AllocationCounter::isAvailable()) {
+            AllocationCounter::setEnabled(true);
+        }
+        else {
+            Log::Warning(
+                "SGCT was built without the allocation counter, so no allocations will "
+                "be counted"
+            );
+        }
+    }
+
+    _useGpuTimings = config.useGpuTimings.value_or(false);
+    _gpuTimings.setEnabled(_useGpuTimings);
+
+    _stageTimings = std::make_unique<StageTimings>(
+        static_cast<int>(ClusterManager::instance().thisNode().windows().size())
+    );
+    if (config.stageTimingsPath) {
+        try {
+            _stageTimings->exportTo(
+                *config.stageTimingsPath,
+                config.stageTimingsInterval.value_or(10.0)
+            );
+        }
+        catch (const Error&) {
+            NetworkManager::destroy();
+            throw;
+        }
+    }
+
+    if (config.tracePath) {
+#if !defined(SGCT_HAS_TRACE_RECORDER) || defined(TRACY_ENABLE)
+        Log::Warning(
+            "The profiling zones are not passed to the trace recorder in this build, so "
+            "the traces will be empty"
+        );
+#endif
+        _tracePath = *config.tracePath;
+        _traceFrames = config.traceFrames;
+        TraceRecorder::setEnabled(true);
+#ifndef WIN32
+        std::signal(SIGUSR1, [](int) { TraceRecorder::requestDump(); });
+#endif // WIN32
+    }
 }
 
 void Engine::initialize() {
@@ -470,10 +612,22 @@ void Engine::initialize() {
         glfwDestroyWindow(offscreen);
         glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
     }
-    Log::Info(fmt::format("Detected OpenGL version: {}.{}", major, minor));
+    Log::Info("Detected OpenGL version: {}.{}", major, minor);
 
     initWindows(major, minor);
 
+    if (_isHeadless) {
+        // OSMesa renders into a buffer in memory, but a surfaceless EGL context has no
+        // default framebuffer that the warping could be rendered into
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        _hasHeadlessFramebuffer = status == GL_FRAMEBUFFER_COMPLETE;
+        Log::Info(
+            "The headless context {} a default framebuffer for the warping",
+            _hasHeadlessFramebuffer ? "has" : "does not have"
+        );
+    }
+
     // Window resolution may have been set by the config. However, it only sets a pending
     // resolution, so it needs to apply it using the same routine as in the end of a frame
     const Node& thisNode = ClusterManager::instance().thisNode();
@@ -487,11 +641,18 @@ void Engine::initialize() {
 
     for (const std::unique_ptr<Window>& window : wins) {
         GLFWwindow* win = window->windowHandle();
-        if (gKeyboardCallback) {
+        if (gKeyboardCallback || _tracePath) {
             glfwSetKeyCallback(
                 win,
                 [](GLFWwindow*, int key, int scancode, int a, int m) {
-                    gKeyboardCallback(Key(key), Modifier(m), Action(a), scancode);
+                    if (TraceRecorder::isEnabled() && Key(key) == Key::F12 &&
+                        Action(a) == Action::Press)
+                    {
+                        TraceRecorder::requestDump();
+                    }
+                    if (gKeyboardCallback) {
+                        gKeyboardCallback(Key(key), Modifier(m), Action(a), scancode);
+                    }
                 }
             );
         }
@@ -544,10 +705,10 @@ void Engine::initialize() {
         glfwGetWindowAttrib(winHandle, GLFW_CONTEXT_VERSION_MINOR),
         glfwGetWindowAttrib(winHandle, GLFW_CONTEXT_REVISION)
     };
-    Log::Info(fmt::format("OpenGL version {}.{}.{} core profile", v[0], v[1], v[2]));
+    Log::Info("OpenGL version {}.{}.{} core profile", v[0], v[1], v[2]);
 
-    Log::Info(fmt::format("Vendor: {}", glGetString(GL_VENDOR)));
-    Log::Info(fmt::format("Renderer: {}", glGetString(GL_RENDERER)));
+    Log::Info("Vendor: {}", glGetString(GL_VENDOR));
+    Log::Info("Renderer: {}", glGetString(GL_RENDERER));
 
     Window::makeSharedContextCurrent();
 
@@ -670,19 +831,6 @@ Engine::~Engine() {
     gMouseScrollCallback = nullptr;
     gDropCallback = nullptr;
 
-    // kill thread
-    if (_thread) {
-        Log::Debug("Waiting for frameLock thread to finish");
-
-        FrameSync.lock();
-        sRunUpdateFrameLockLoop = false;
-        FrameSync.unlock();
-
-        _thread->join();
-        _thread = nullptr;
-        Log::Debug("Done");
-    }
-
     // de-init window and unbind swapgroups
     // There might not be any thisNode as its creation might have failed
     if (hasNode) {
@@ -730,6 +878,7 @@ Engine::~Engine() {
 
     Log::Debug("Destroying cluster manager");
     ClusterManager::destroy();
+    ClusterClock::destroy();
 
     Log::Debug("Destroying settings");
     Settings::destroy();
@@ -748,7 +897,7 @@ void Engine::initWindows(int majorVersion, int minorVersion) {
 
     int ver[3];
     glfwGetVersion(&ver[0], &ver[1], &ver[2]);
-    Log::Info(fmt::format("Using GLFW version {}.{}.{}", ver[0], ver[1], ver[2]));
+    Log::Info("Using GLFW version {}.{}.{}", ver[0], ver[1], ver[2]);
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, majorVersion);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minorVersion);
@@ -781,12 +930,6 @@ void Engine::initWindows(int majorVersion, int minorVersion) {
     // clear directly otherwise junk will be displayed on some OSs (OS X Yosemite)
     glClearColor(0.f, 0.f, 0.f, 0.f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    if (RunFrameLockCheckThread) {
-        if (ClusterManager::instance().numberOfNodes() > 1) {
-            _thread = std::make_unique<std::thread>(updateFrameLockLoop, nullptr);
-        }
-    }
 }
 
 void Engine::terminate() {
@@ -817,25 +960,20 @@ void Engine::frameLockPreStage() {
 
     // not server
     const double t0 = glfwGetTime();
-    while (nm.isRunning() && !nm.isSyncComplete()) {
-        std::unique_lock lk(FrameSync);
-        NetworkManager::cond.wait(lk);
-
-        if (glfwGetTime() - t0 <= 1.0) {
-            continue;
-        }
-
+    const std::chrono::microseconds spinTime(ClusterManager::instance().syncSpinTime());
+    auto isComplete = [&nm]() { return !nm.isRunning() || nm.isSyncComplete(); };
+    while (!NetworkManager::barrier.wait(isComplete, spinTime, SyncMessageInterval)) {
         // more than a second
         const Network& c = nm.syncConnection(0);
         if (_printSyncMessage && !c.isUpdated()) {
-            Log::Info(fmt::format(
+            Log::Info(
                 "Waiting for master. frame send {} != recv {}\n\tSwap groups: {}\n\t"
                 "Swap barrier: {}\n\tUniversal frame number: {}\n\tSGCT frame number: {}",
                 c.sendFrameCurrent(), c.recvFramePrevious(),
                 Window::isUsingSwapGroups() ? "enabled" : "disabled",
                 Window::isBarrierActive() ? "enabled" : "disabled",
                 Window::swapGroupFrameNumber(), _frameCounter
-            ));
+            );
         }
 
         if (glfwGetTime() - t0 > _syncTimeout) {
@@ -844,6 +982,14 @@ void Engine::frameLockPreStage() {
         }
     }
 
+    // When rendering ahead, the received frames are queued and decoded in order
+    if (std::optional<double> latency = nm.decodeQueuedFrame(); latency) {
+        addValue(_statistics.renderAheadLatencies, *latency);
+    }
+
+    // A frame that was decoded on the receiving thread becomes the current state now
+    SharedData::instance().applyStagedFrame();
+
     // A this point all data needed for rendering a frame is received.
     // Let's signal that back to the master/server.
     nm.sync(NetworkManager::SyncMode::Acknowledge);
@@ -852,6 +998,48 @@ void Engine::frameLockPreStage() {
     }
 }
 
+void Engine::dumpTrace() {
+    ZoneScoped
+
+    // Every node writes its own files, which are numbered in case of repeated dumps
+    const int node = ClusterManager::instance().thisNodeId();
+    const std::string& path = *_tracePath;
+    const size_t dot = path.find_last_of('.');
+    const bool hasExtension =
+        dot != std::string::npos && path.find_first_of("/\\", dot) == std::string::npos;
+    const std::string base = hasExtension ? path.substr(0, dot) : path;
+    const std::string ext = hasExtension ? path.substr(dot) : ".json";
+    const std::string file = fmt::format("{}-node{}-{}{}", base, node, _nTraceDumps, ext);
+    TraceRecorder::dump(file, node);
+    _nTraceDumps++;
+}
+
+bool Engine::replayFrame() {
+    ZoneScoped
+
+    const std::optional<SyncPlayer::Frame> frame = _replay->next();
+    if (!frame) {
+        Log::Info("Reached the end of the recording after {} frames", _nReplayedFrames);
+        return false;
+    }
+
+    if (!_replayAtMaxRate) {
+        if (!_replayTimeOffset) {
+            _replayTimeOffset = glfwGetTime() - frame->time;
+        }
+        const double wait = frame->time + *_replayTimeOffset - glfwGetTime();
+        if (wait > 0.0) {
+            ZoneScopedN("Wait for recorded frame")
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+
+    SharedData::instance().decode(frame->data, frame->size);
+    SharedData::instance().applyStagedFrame();
+    _nReplayedFrames++;
+    return true;
+}
+
 void Engine::frameLockPostStage() {
     ZoneScoped
 
@@ -862,17 +1050,15 @@ void Engine::frameLockPostStage() {
     }
 
     const double t0 = glfwGetTime();
-    while (nm.isRunning() && nm.activeConnectionsCount() > 0 && !nm.isSyncComplete()) {
-        std::unique_lock lk(FrameSync);
-        NetworkManager::cond.wait(lk);
-
-        if (glfwGetTime() - t0 <= 1.0) {
-            continue;
-        }
+    const std::chrono::microseconds spinTime(ClusterManager::instance().syncSpinTime());
+    auto isComplete = [&nm]() {
+        return !nm.isRunning() || nm.activeConnectionsCount() == 0 || nm.isSyncComplete();
+    };
+    while (!NetworkManager::barrier.wait(isComplete, spinTime, SyncMessageInterval)) {
         // more than a second
         for (int i = 0; i < nm.syncConnectionsCount(); ++i) {
             if (_printSyncMessage && !nm.connection(i).isUpdated()) {
-                Log::Info(fmt::format(
+                Log::Info(
                     "Waiting for IG{}: send frame {} != recv frame {}\n\tSwap groups: {}"
                     "\n\tSwap barrier: {}\n\tUniversal frame number: {}\n\t"
                     "SGCT frame number: {}", i, nm.connection(i).sendFrameCurrent(),
@@ -880,7 +1066,7 @@ void Engine::frameLockPostStage() {
                     Window::isUsingSwapGroups() ? "enabled" : "disabled",
                     Window::isBarrierActive() ? "enabled" : "disabled",
                     Window::swapGroupFrameNumber(), _frameCounter
-                ));
+                );
             }
         }
 
@@ -891,16 +1077,53 @@ void Engine::frameLockPostStage() {
     }
 
     addValue(_statistics.syncTimes, glfwGetTime() - t0);
+
+    if (ClusterManager::instance().renderAhead() > 0) {
+        const double latency = nm.framesInFlight() * _statistics.dt();
+        addValue(_statistics.renderAheadLatencies, latency);
+    }
+
+    // The acknowledgements carried the swap times of the previous frame
+    if (std::optional<double> skew = nm.swapSkew(); skew) {
+        addValue(_statistics.swapSkews, *skew);
+        _statistics.nSwapSkews++;
+    }
+
+    // They also carried the timings that the nodes measured for their previous frame
+    std::vector<NetworkManager::NodeTiming>& timings = _nodeTimingsScratch;
+    nm.nodeTimings(timings);
+    int slowest = -1;
+    float slowestTime = -1.f;
+    for (const NetworkManager::NodeTiming& t : timings) {
+        if (t.node >= static_cast<int>(_statistics.nodeTimes.size())) {
+            continue;
+        }
+        Statistics::NodeTimes& times = _statistics.nodeTimes[t.node];
+        addValue(times.frameTimes, t.frameTime);
+        addValue(times.drawTimes, t.drawTime);
+        addValue(times.decodeTimes, t.decodeTime);
+        addValue(times.syncTimes, t.syncTime);
+        addValue(times.swapTimes, t.swapTime);
+        if (t.drawTime + t.decodeTime > slowestTime) {
+            slowest = t.node;
+            slowestTime = t.drawTime + t.decodeTime;
+        }
+    }
+    addValue(_statistics.slowestNodes, slowest);
+
+    if (_clusterStatisticsFile) {
+        for (const NetworkManager::NodeTiming& t : timings) {
+            *_clusterStatisticsFile << fmt::format(
+                "{},{},{},{},{},{},{},{}\n", t.frame, t.node, t.frameTime, t.drawTime,
+                t.decodeTime, t.syncTime, t.swapTime, t.node == slowest ? 1 : 0
+            );
+        }
+    }
 }
 
 void Engine::render() {
     Window::makeSharedContextCurrent();
 
-    unsigned int timeQueryBegin = 0;
-    glGenQueries(1, &timeQueryBegin);
-    unsigned int timeQueryEnd = 0;
-    glGenQueries(1, &timeQueryEnd);
-
     Node& thisNode = ClusterManager::instance().thisNode();
     const std::vector<std::unique_ptr<Window>>& windows = thisNode.windows();
     while (!(_shouldTerminate || thisNode.closeAllWindows() ||
@@ -912,17 +1135,28 @@ void Engine::render() {
         }
 #endif
         
+        TraceRecorder::setFrameNumber(_frameCounter);
+
         {
             ZoneScopedN("GLFW Poll Events")
+            StageTimings::Scope stage(*_stageTimings, StageTimings::Stage::PollEvents);
             glfwPollEvents();
         }
 
-        if (_preSyncFn) {
+        // When replaying, the state of the application comes from the recording only
+        if (_preSyncFn && !_replay) {
             ZoneScopedN("[SGCT] PreSync");
+            StageTimings::Scope stage(*_stageTimings, StageTimings::Stage::PreSync);
             _preSyncFn();
         }
 
-        if (NetworkManager::instance().isComputerServer()) {
+        if (_replay) {
+            if (!replayFrame()) {
+                break;
+            }
+        }
+        else if (NetworkManager::instance().isComputerServer()) {
+            StageTimings::Scope stage(*_stageTimings, StageTimings::Stage::Encode);
             SharedData::instance().encode();
         }
         else if (!NetworkManager::instance().isRunning()) {
@@ -931,12 +1165,18 @@ void Engine::render() {
             break;
         }
 
-        frameLockPreStage();
+        {
+            using S = StageTimings::Stage;
+            StageTimings::Scope stage(*_stageTimings, S::FrameLockPreStage);
+            frameLockPreStage();
+        }
         std::for_each(windows.cbegin(), windows.cend(), std::mem_fn(&Window::update));
         Window::makeSharedContextCurrent();
 
         if (_postSyncPreDrawFn) {
             ZoneScopedN("[SGCT] PostSyncPreDraw");
+            using S = StageTimings::Stage;
+            StageTimings::Scope stage(*_stageTimings, S::PostSyncPreDraw);
             _postSyncPreDrawFn();
         }
 
@@ -946,15 +1186,29 @@ void Engine::render() {
             const double ft = static_cast<float>(startFrameTime - _statsPrevTimestamp);
             addValue(_statistics.frametimes, ft);
             _statsPrevTimestamp = startFrameTime;
-
-            if (_statisticsRenderer) {
-                glQueryCounter(timeQueryBegin, GL_TIMESTAMP);
+            addValue(_statistics.lockWaitTimes, TimedLock::takeWaitTime());
+            const uint64_t nAllocs = AllocationCounter::threadCounts().nAllocations;
+            addValue(_statistics.allocations, nAllocs - _statsPrevAllocations);
+            _statsPrevAllocations = nAllocs;
+
+            // The GPU times of a frame are only read back a few frames later so that
+            // measuring them never waits for the GPU
+            using P = std::array<double, GpuTimings::PassCount>;
+            if (std::optional<P> gpu = _gpuTimings.beginFrame(); gpu) {
+                for (int i = 0; i < GpuTimings::PassCount; ++i) {
+                    addValue(_statistics.gpuPassTimes[i], (*gpu)[i]);
+                }
+                addValue(_statistics.drawTimes, (*gpu)[0]);
             }
         }
+        std::optional<GpuTimings::Scope> gpuFrame;
+        gpuFrame.emplace(_gpuTimings, GpuTimings::Pass::Frame);
 
         // Render Viewports / Draw
-        for (const std::unique_ptr<Window>& win : windows) {
+        for (size_t i = 0; i < windows.size(); ++i) {
             ZoneScopedN("Render window")
+            const std::unique_ptr<Window>& win = windows[i];
+            const int winIdx = static_cast<int>(i);
 
             if (!(win->isVisible() || win->isRenderingWhileHidden())) {
                 continue;
@@ -970,6 +1224,8 @@ void Engine::render() {
                     continue;
                 }
 
+                using S = StageTimings::WindowStage;
+                StageTimings::Scope stage(*_stageTimings, winIdx, S::Cubemaps);
                 NonLinearProjection* nonLinearProj = vp->nonLinearProjection();
                 nonLinearProj->setAlpha(win->hasAlpha() ? 0.f : 1.f);
                 if (sm == Window::StereoMode::NoStereo) {
@@ -983,19 +1239,23 @@ void Engine::render() {
 
             // Render left/mono regular viewports to FBO
             // if any stereo type (except passive) then set frustum mode to left eye
-            if (sm == Window::StereoMode::NoStereo) {
-                renderViewports(
-                    *win,
-                    Frustum::Mode::MonoEye,
-                    Window::TextureIndex::LeftEye
-                );
-            }
-            else {
-                renderViewports(
-                    *win,
-                    Frustum::Mode::StereoLeftEye,
-                    Window::TextureIndex::LeftEye
-                );
+            {
+                using S = StageTimings::WindowStage;
+                StageTimings::Scope stage(*_stageTimings, winIdx, S::Viewports);
+                if (sm == Window::StereoMode::NoStereo) {
+                    renderViewports(
+                        *win,
+                        Frustum::Mode::MonoEye,
+                        Window::TextureIndex::LeftEye
+                    );
+                }
+                else {
+                    renderViewports(
+                        *win,
+                        Frustum::Mode::StereoLeftEye,
+                        Window::TextureIndex::LeftEye
+                    );
+                }
             }
 
             // if we are not rendering in stereo, we are done
@@ -1009,6 +1269,8 @@ void Engine::render() {
                 if (!vp->hasSubViewports()) {
                     continue;
                 }
+                using S = StageTimings::WindowStage;
+                StageTimings::Scope stage(*_stageTimings, winIdx, S::Cubemaps);
                 NonLinearProjection* p = vp->nonLinearProjection();
                 p->setAlpha(win->hasAlpha() ? 0.f : 1.f);
                 p->renderCubemap(*win, Frustum::Mode::StereoRightEye);
@@ -1016,6 +1278,8 @@ void Engine::render() {
 
             // Render right regular viewports to FBO
             // use a single texture for side-by-side and top-bottom stereo modes
+            using S = StageTimings::WindowStage;
+            StageTimings::Scope stage(*_stageTimings, winIdx, S::Viewports);
             if (sm >= Window::StereoMode::SideBySide) {
                 renderViewports(
                     *win,
@@ -1033,49 +1297,57 @@ void Engine::render() {
         }
 
         // Render to screen
-        for (const std::unique_ptr<Window>& window : windows) {
-            if (window->isVisible()) {
-                renderFBOTexture(*window);
+        for (size_t i = 0; i < windows.size(); ++i) {
+            if (windows[i]->isVisible() || _hasHeadlessFramebuffer) {
+                using S = StageTimings::WindowStage;
+                StageTimings::Scope stage(*_stageTimings, static_cast<int>(i), S::Warp);
+                renderFBOTexture(*windows[i]);
             }
         }
         Window::makeSharedContextCurrent();
-
-        if (_statisticsRenderer) {
-            ZoneScopedN("glQueryCounter")
-            glQueryCounter(timeQueryEnd, GL_TIMESTAMP);
-        }
+        gpuFrame.reset();
 
         if (_postDrawFn) {
             ZoneScopedN("[SGCT] PostDraw");
+            StageTimings::Scope stage(*_stageTimings, StageTimings::Stage::PostDraw);
             _postDrawFn();
         }
 
         if (_statisticsRenderer) {
             ZoneScopedN("Statistics Update")
-            // wait until the query results are available
-            GLint done = GL_FALSE;
-            while (!done) {
-                glGetQueryObjectiv(timeQueryEnd, GL_QUERY_RESULT_AVAILABLE, &done);
-            }
-
-            // get the query results
-            GLuint64 timerStart;
-            glGetQueryObjectui64v(timeQueryBegin, GL_QUERY_RESULT, &timerStart);
-            GLuint64 timerEnd;
-            glGetQueryObjectui64v(timeQueryEnd, GL_QUERY_RESULT, &timerEnd);
-
-            const double t = static_cast<double>(timerEnd - timerStart) / 1000000000.0;
-            addValue(_statistics.drawTimes, t);
-
             _statisticsRenderer->update();
         }
 
+        // The draw time covers everything from the start of the frame until it is ready
+        // to be swapped, independent of whether the statistics are rendered
+        const double drawTime = glfwGetTime() - _statsPrevTimestamp;
+
         // master will wait for nodes render before swapping
-        frameLockPostStage();
+        {
+            using S = StageTimings::Stage;
+            StageTimings::Scope stage(*_stageTimings, S::FrameLockPostStage);
+            frameLockPostStage();
+        }
         // Swap front and back rendering buffers
-        for (const std::unique_ptr<Window>& window : windows) {
-            window->swap(_takeScreenshot);
+        const double swapStartTime = glfwGetTime();
+        {
+            StageTimings::Scope stage(*_stageTimings, StageTimings::Stage::Swap);
+            for (const std::unique_ptr<Window>& window : windows) {
+                window->swap(_takeScreenshot);
+            }
         }
+        NetworkManager& nm = NetworkManager::instance();
+        nm.setSwapTime(ClusterClock::instance().time());
+
+        // The clients report the timings of this frame with their next acknowledgement
+        NetworkManager::NodeTiming timing;
+        timing.frameTime = static_cast<float>(_statistics.frametimes[0]);
+        timing.drawTime = static_cast<float>(drawTime);
+        timing.decodeTime = static_cast<float>(SharedData::instance().lastDecodeTime());
+        timing.syncTime = static_cast<float>(_statistics.syncTimes[0]);
+        timing.swapTime = static_cast<float>(glfwGetTime() - swapStartTime);
+        nm.setNodeTiming(timing);
+        _stageTimings->endFrame();
 
         TracyGpuCollect;
         FrameMark;
@@ -1091,11 +1363,23 @@ void Engine::render() {
             _shotCounter++;
         }
         _takeScreenshot = false;
+
+        if (_tracePath) {
+            const bool isFrameCountReached =
+                _traceFrames && static_cast<int>(_frameCounter) == *_traceFrames;
+            if (TraceRecorder::takeDumpRequest() || isFrameCountReached) {
+                dumpTrace();
+            }
+        }
+
+        if (_maxFrames && static_cast<int>(_frameCounter) >= *_maxFrames) {
+            Log::Info("Exiting after {} frames", _frameCounter);
+            _shouldTerminate = true;
+        }
     }
 
     Window::makeSharedContextCurrent();
-    glDeleteQueries(1, &timeQueryBegin);
-    glDeleteQueries(1, &timeQueryEnd);
+    _gpuTimings.deleteQueries();
 }
 
 void Engine::drawOverlays(const Window& window, Frustum::Mode frustum) {
@@ -1119,6 +1403,7 @@ void Engine::drawOverlays(const Window& window, Frustum::Mode frustum) {
 
 void Engine::renderFBOTexture(Window& window) {
     ZoneScoped
+    GpuTimings::Scope gpu(_gpuTimings, GpuTimings::Pass::Warp);
 
     OffScreenBuffer::unbind();
 
@@ -1227,6 +1512,7 @@ void Engine::renderFBOTexture(Window& window) {
 void Engine::renderViewports(Window& win, Frustum::Mode frustum, Window::TextureIndex ti)
 {
     ZoneScoped
+    GpuTimings::Scope gpu(_gpuTimings, GpuTimings::Pass::Viewports);
 
     prepareBuffer(win, ti);
 
@@ -1255,6 +1541,7 @@ void Engine::renderViewports(Window& win, Frustum::Mode frustum, Window::Texture
             }
 
             if (win.shouldCallDraw3DFunction()) {
+                GpuTimings::Scope resample(_gpuTimings, GpuTimings::Pass::Resample);
                 vp->nonLinearProjection()->render(win, *vp, frustum);
             }
         }
@@ -1352,6 +1639,7 @@ void Engine::renderViewports(Window& win, Frustum::Mode frustum, Window::Texture
 
 void Engine::render2D(const Window& win, Frustum::Mode frustum) {
     ZoneScoped
+    GpuTimings::Scope gpu(_gpuTimings, GpuTimings::Pass::Overlays);
 
     // draw viewport overlays if any
     drawOverlays(win, frustum);
@@ -1394,6 +1682,7 @@ void Engine::render2D(const Window& win, Frustum::Mode frustum) {
 
 void Engine::renderFXAA(Window& window, Window::TextureIndex targetIndex) {
     ZoneScoped
+    GpuTimings::Scope gpu(_gpuTimings, GpuTimings::Pass::FXAA);
 
     assert(_fxaa.has_value());
 
@@ -1639,6 +1928,14 @@ const Engine::Statistics& Engine::statistics() const {
     return _statistics;
 }
 
+const StageTimings& Engine::stageTimings() const {
+    return *_stageTimings;
+}
+
+GpuTimings& Engine::gpuTimings() {
+    return _gpuTimings;
+}
+
 vec4 Engine::clearColor() const {
     return _clearColor;
 }
@@ -1687,6 +1984,7 @@ void Engine::setStatsGraphVisibility(bool state) {
     if (!state && _statisticsRenderer) {
         _statisticsRenderer = nullptr;
     }
+    _gpuTimings.setEnabled(state || _useGpuTimings);
 }
 
 void Engine::takeScreenshot() {
@@ -1713,6 +2011,10 @@ double Engine::getTime() {
     return glfwGetTime();
 }
 
+double Engine::clusterTime() {
+    return ClusterClock::instance().time();
+}
+
 void Engine::setSyncParameters(bool printMessage, float timeout) {
     _printSyncMessage = printMessage;
     _syncTimeout = timeout;
@@ -290,7 +290,7 @@ void Font::createCharacter(char c) {
         _fontFaceData[c] = std::move(*ffd);
     }
     else {
-        Log::Error(fmt::format("Error creating character {}", c));
+        Log::Error("Error creating character {}", c);
     }
 }
 
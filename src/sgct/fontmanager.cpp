@@ -145,7 +145,7 @@ bool FontManager::addFont(std::string name, std::string file) {
 
     const bool inserted = _fontPaths.insert({ std::move(name), std::move(file) }).second;
     if (!inserted) {
-        Log::Warning(fmt::format("Font with name '{}' already exists", name));
+        Log::Warning("Font with name '{}' already exists", name);
     }
     return inserted;
 }
@@ -166,14 +166,12 @@ std::unique_ptr<Font> FontManager::createFont(const std::string& name, int heigh
     std::map<std::string, std::string>::const_iterator it = _fontPaths.find(name);
 
     if (it == _fontPaths.end()) {
-        Log::Error(fmt::format("No font file specified for font [{}]", name));
+        Log::Error("No font file specified for font [{}]", name);
         return nullptr;
     }
 
     if (_library == nullptr) {
-        Log::Error(fmt::format(
-            "Freetype library is not initialized, can't create font [{}]", name
-        ));
+        Log::Error("Freetype library is not initialized, can't create font [{}]", name);
         return nullptr;
     }
 
@@ -181,19 +179,17 @@ std::unique_ptr<Font> FontManager::createFont(const std::string& name, int heigh
     FT_Error error = FT_New_Face(_library, it->second.c_str(), 0, &face);
 
     if (error == FT_Err_Unknown_File_Format) {
-        Log::Error(fmt::format(
-            "Unsupperted file format [{}] for font [{}]", it->second, name
-        ));
+        Log::Error("Unsupperted file format [{}] for font [{}]", it->second, name);
         return nullptr;
     }
     else if (error != 0 || face == nullptr) {
-        Log::Error(fmt::format("Font '{}' not found", it->second));
+        Log::Error("Font '{}' not found", it->second);
         return nullptr;
     }
 
     FT_Error charSizeErr = FT_Set_Char_Size(face, height << 6, height << 6, 96, 96);
     if (charSizeErr != 0) {
-        Log::Error(fmt::format("Could not set pixel size for font [{}]", name));
+        Log::Error("Could not set pixel size for font [{}]", name);
         return nullptr;
     }
 
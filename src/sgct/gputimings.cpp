@@ -0,0 +1,125 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/gputimings.h>
+
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <stdexcept>
+
+namespace sgct {
+
+GpuTimings::Scope::Scope(GpuTimings& timings, Pass pass)
+    : _timings(timings)
+{
+    if (_timings._isEnabled) {
+        _index = _timings.begin(pass);
+    }
+}
+
+GpuTimings::Scope::~Scope() {
+    if (_index != -1) {
+        _timings.end(_index);
+    }
+}
+
+std::string_view GpuTimings::name(Pass pass) {
+    switch (pass) {
+        case Pass::Frame: return "Frame";
+        case Pass::CubemapRight: return "Cubemap right";
+        case Pass::CubemapLeft: return "Cubemap left";
+        case Pass::CubemapBottom: return "Cubemap bottom";
+        case Pass::CubemapTop: return "Cubemap top";
+        case Pass::CubemapFront: return "Cubemap front";
+        case Pass::CubemapBack: return "Cubemap back";
+        case Pass::Resample: return "Resample";
+        case Pass::Viewports: return "Viewports";
+        case Pass::FXAA: return "FXAA";
+        case Pass::Warp: return "Warp";
+        case Pass::Overlays: return "Overlays";
+        default: throw std::logic_error("Unhandled case label");
+    }
+}
+
+void GpuTimings::setEnabled(bool enabled) {
+    _isEnabled = enabled;
+}
+
+bool GpuTimings::isEnabled() const {
+    return _isEnabled;
+}
+
+std::optional<std::array<double, GpuTimings::PassCount>> GpuTimings::beginFrame() {
+    ZoneScoped
+
+    _current = (_current + 1) % FrameLatency;
+    Frame& frame = _frames[_current];
+    if (frame.nUsed == 0) {
+        return std::nullopt;
+    }
+
+    // The queries finish in order, so all results are there if the last one is
+    const int nUsed = frame.nUsed;
+    frame.nUsed = 0;
+    GLint isAvailable = GL_FALSE;
+    glGetQueryObjectiv(
+        frame.queries[2 * nUsed - 1],
+        GL_QUERY_RESULT_AVAILABLE,
+        &isAvailable
+    );
+    if (!isAvailable) {
+        _nDroppedFrames++;
+        return std::nullopt;
+    }
+
+    std::array<double, PassCount> res = {};
+    for (int i = 0; i < nUsed; ++i) {
+        GLuint64 t0 = 0;
+        glGetQueryObjectui64v(frame.queries[2 * i], GL_QUERY_RESULT, &t0);
+        GLuint64 t1 = 0;
+        glGetQueryObjectui64v(frame.queries[2 * i + 1], GL_QUERY_RESULT, &t1);
+        res[static_cast<int>(frame.passes[i])] += static_cast<double>(t1 - t0) / 1e9;
+    }
+    return res;
+}
+
+int GpuTimings::nDroppedFrames() const {
+    return _nDroppedFrames;
+}
+
+void GpuTimings::deleteQueries() {
+    for (Frame& frame : _frames) {
+        if (!frame.queries.empty()) {
+            const GLsizei n = static_cast<GLsizei>(frame.queries.size());
+            glDeleteQueries(n, frame.queries.data());
+        }
+        frame.queries.clear();
+        frame.passes.clear();
+        frame.nUsed = 0;
+    }
+}
+
+int GpuTimings::begin(Pass pass) {
+    Frame& frame = _frames[_current];
+    const int index = frame.nUsed;
+    if (2 * index >= static_cast<int>(frame.queries.size())) {
+        frame.queries.resize(2 * index + 2);
+        frame.passes.resize(index + 1);
+        glGenQueries(2, &frame.queries[2 * index]);
+    }
+    frame.passes[index] = pass;
+    frame.nUsed++;
+    glQueryCounter(frame.queries[2 * index], GL_TIMESTAMP);
+    return index;
+}
+
+void GpuTimings::end(int index) {
+    glQueryCounter(_frames[_current].queries[2 * index + 1], GL_TIMESTAMP);
+}
+
+} // namespace sgct
@@ -263,7 +263,7 @@ void Image::savePNG(std::string filename, int compressionLevel) {
     fclose(fp);
 
     const double time = (Engine::getTime() - t0) * 1000.0;
-    Log::Debug(fmt::format("'{}' was saved successfully ({:.2f} ms)", filename, time));
+    Log::Debug("'{}' was saved successfully ({:.2f} ms)", filename, time);
 }
 
 unsigned char* Image::data() {
@@ -320,10 +320,10 @@ void Image::allocateOrResizeData() {
         _data = new unsigned char[dataSize];
         _dataSize = dataSize;
 
-        Log::Debug(fmt::format(
+        Log::Debug(
             "Allocated {} bytes for image data ({:.2f} ms)",
             _dataSize, (Engine::getTime() - t0) * 1000.0
-        ));
+        );
     }
 }
 
@@ -11,10 +11,11 @@
 #include <sgct/fmt.h>
 #include <sgct/networkmanager.h>
 #include <sgct/mutexes.h>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
-#include <cstdarg>
 
 #ifdef WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -22,9 +23,10 @@
 #include <Windows.h>
 #endif // WIN32
 
-#include <cstdarg> // va_copy
-
 namespace {
+    // The writer also checks the queue in this interval in case it missed a wake-up
+    constexpr const std::chrono::milliseconds WriterInterval(50);
+
     std::string_view levelToString(sgct::Log::Level level) {
         switch (level) {
             case sgct::Log::Level::Debug: return "Debug";
@@ -52,61 +54,186 @@ void Log::destroy() {
     _instance = nullptr;
 }
 
+bool Log::isEnabled(Level level) {
+    return instance()._level.load(std::memory_order_relaxed) <= level;
+}
+
 Log::Log() {
-    _parseBuffer.resize(128);
+    startWriter();
+
+    // The messages that are still queued when the application exits are written before
+    // the writer thread is stopped. Messages that are logged after this point are
+    // written synchronously
+    static std::once_flag isExitHandlerRegistered;
+    std::call_once(isExitHandlerRegistered, []() {
+        std::atexit([]() {
+            if (_instance) {
+                _instance->stopWriter();
+            }
+        });
+    });
+}
+
+Log::~Log() {
+    stopWriter();
 }
 
 void Log::printv(Level level, std::string message) {
+    if (!_isWriterRunning) {
+        std::unique_lock lock(_mutex);
+        write(Message{ level, time(nullptr), std::move(message) });
+        if (_logToConsole) {
+            std::cout.flush();
+        }
+        if (_file.is_open()) {
+            _file.flush();
+        }
+        return;
+    }
+
+    Message* m = new Message{ level, time(nullptr), std::move(message) };
+    _nQueued++;
+    Message* head = _queue.load(std::memory_order_relaxed);
+    do {
+        m->next = head;
+    } while (!_queue.compare_exchange_weak(
+        head,
+        m,
+        std::memory_order_release,
+        std::memory_order_relaxed
+    ));
+
+    // Only the first message of a batch has to wake up the writer
+    if (!head) {
+        _writerCondition.notify_one();
+    }
+}
+
+void Log::write(const Message& message) {
+    std::string prefix;
+    if (_showLevel) {
+        prefix = fmt::format("({}) ", levelToString(message.level));
+    }
     if (_showTime) {
         constexpr int TimeBufferSize = 9;
         char TimeBuffer[TimeBufferSize];
-        time_t now = time(nullptr);
-        tm* timeInfoPtr;
-        timeInfoPtr = localtime(&now);
+        tm* timeInfoPtr = localtime(&message.time);
         strftime(TimeBuffer, TimeBufferSize, "%X", timeInfoPtr);
-
-        message = fmt::format("{} | {}", TimeBuffer, message);
-    }
-    if (_showLevel) {
-        message = fmt::format("({}) {}", levelToString(level), message);
+        prefix += fmt::format("{} | ", TimeBuffer);
     }
+    const std::string msg = prefix + message.text;
 
     if (_logToConsole) {
-        // We need an endl here to make sure that any application listening to our log
-        // messages (looking at you C-Troll) is actually getting the messages immediately.
-        // If the `flush` doesn't happen here, all of the messages stack up in the buffer
-        // and are only sent once the application is finished, which is no bueno
-        std::cout << message << std::endl;
+        std::cout << msg << '\n';
 #ifdef WIN32
-        OutputDebugStringA((message + '\n').c_str());
+        OutputDebugStringA((msg + '\n').c_str());
 #endif // WIN32
     }
 
+    if (_file.is_open()) {
+        _file << msg << '\n';
+    }
+
     if (_messageCallback) {
-        _messageCallback(level, message);
+        _messageCallback(message.level, msg);
+    }
+}
+
+void Log::writeBatch(Message* messages) {
+    if (!messages) {
+        return;
+    }
+
+    // The queue starts with the newest message, so it is reversed to restore the order
+    Message* m = nullptr;
+    while (messages) {
+        Message* next = messages->next;
+        messages->next = m;
+        m = messages;
+        messages = next;
+    }
+
+    std::unique_lock lock(_mutex);
+    uint64_t n = 0;
+    while (m) {
+        write(*m);
+        Message* next = m->next;
+        delete m;
+        m = next;
+        n++;
+    }
+
+    // The outputs are flushed after every batch to make sure that any application
+    // listening to our log messages (looking at you C-Troll) is getting the messages
+    // immediately instead of once the application is finished
+    if (_logToConsole) {
+        std::cout.flush();
+    }
+    if (_file.is_open()) {
+        _file.flush();
+    }
+    _nWritten += n;
+}
+
+void Log::startWriter() {
+    if (_isWriterRunning) {
+        return;
+    }
+    _isWriterRunning = true;
+    _writer = std::thread(&Log::writerLoop, this);
+}
+
+void Log::stopWriter() {
+    if (!_isWriterRunning) {
+        return;
+    }
+    _isWriterRunning = false;
+    _writerCondition.notify_one();
+    if (_writer.joinable()) {
+        _writer.join();
+    }
+    // Messages that were pushed while the writer was stopping
+    writeBatch(_queue.exchange(nullptr, std::memory_order_acquire));
+}
+
+void Log::writerLoop() {
+    while (true) {
+        {
+            std::unique_lock lock(_writerMutex);
+            _writerCondition.wait_for(lock, WriterInterval, [this]() {
+                return _queue.load(std::memory_order_relaxed) || !_isWriterRunning;
+            });
+        }
+
+        // All messages that were logged before the writer was stopped are written
+        const bool isRunning = _isWriterRunning;
+        writeBatch(_queue.exchange(nullptr, std::memory_order_acquire));
+        if (!isRunning) {
+            return;
+        }
     }
 }
 
 void Log::Debug(std::string_view message) {
-    if (instance()._level <= Level::Debug) {
+    if (isEnabled(Level::Debug)) {
         instance().printv(Level::Debug, std::string(message));
     }
 }
 
 void Log::Info(std::string_view message) {
-    if (instance()._level <= Level::Info) {
+    if (isEnabled(Level::Info)) {
         instance().printv(Level::Info, std::string(message));
     }
 }
 
 void Log::Warning(std::string_view message) {
-    if (instance()._level <= Level::Warning) {
+    if (isEnabled(Level::Warning)) {
         instance().printv(Level::Warning, std::string(message));
     }
 }
 
 void Log::Error(std::string_view message) {
-    if (instance()._level <= Level::Error) {
+    if (isEnabled(Level::Error)) {
         instance().printv(Level::Error, std::string(message));
     }
 }
@@ -116,19 +243,57 @@ void Log::setNotifyLevel(Level nl) {
 }
 
 void Log::setShowTime(bool state) {
+    std::unique_lock lock(_mutex);
     _showTime = state;
 }
 
 void Log::setShowLogLevel(bool state) {
+    std::unique_lock lock(_mutex);
     _showLevel = state;
 }
 
 void Log::setLogToConsole(bool state) {
+    std::unique_lock lock(_mutex);
     _logToConsole = state;
 }
 
+void Log::setLogFile(const std::string& path) {
+    std::unique_lock lock(_mutex);
+    if (_file.is_open()) {
+        _file.close();
+    }
+    if (path.empty()) {
+        return;
+    }
+
+    _file.open(path, std::ios::out | std::ios::trunc);
+    if (!_file.good()) {
+        _file.close();
+        lock.unlock();
+        Error("Failed to open log file {}", path);
+    }
+}
+
 void Log::setLogCallback(std::function<void(Level, std::string_view)> fn) {
+    std::unique_lock lock(_mutex);
     _messageCallback = std::move(fn);
 }
 
+void Log::setUseAsyncWriter(bool state) {
+    if (state) {
+        startWriter();
+    }
+    else {
+        stopWriter();
+    }
+}
+
+void Log::flush() {
+    const uint64_t nQueued = _nQueued;
+    while (_isWriterRunning && _nWritten < nQueued) {
+        _writerCondition.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
 } // namespace sgct
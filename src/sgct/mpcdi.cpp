@@ -259,7 +259,7 @@ namespace {
         // Check for unsupported features that we might want to warn about
         const tinyxml2::XMLElement* extSetElem = root.FirstChildElement("extensionSet");
         if (extSetElem) {
-            Log::Warning(fmt::format("Unsupported feature: {}", extSetElem->Value()));
+            Log::Warning("Unsupported feature: {}", extSetElem->Value());
         }
 
         return res;
@@ -318,9 +318,7 @@ ReturnValue parseMpcdiConfiguration(const std::string& filename) {
             else if (endsWith(fileName, "pfm")) {
                 // Uncompress the PFM file
                 if (!pfmComponent.buffer.empty()) {
-                    Log::Warning(
-                        fmt::format("Duplicate file {} found in MPCDI", fileName)
-                    );
+                    Log::Warning("Duplicate file {} found in MPCDI", fileName);
                 }
 
                 const int openCurrentFile = unzOpenCurrentFile(zip);
@@ -336,7 +334,7 @@ ReturnValue parseMpcdiConfiguration(const std::string& filename) {
                 pfmComponent.buffer = std::move(buffer);
             }
             else {
-                Log::Warning(fmt::format("Ignoring extension {}", fileName));
+                Log::Warning("Ignoring extension {}", fileName);
             }
 
             if (i < globalInfo.number_entry - 1) {
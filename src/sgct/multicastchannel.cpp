@@ -0,0 +1,338 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/multicastchannel.h>
+
+#ifdef WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define VC_EXTRALEAN
+    #define NOMINMAX
+    #include <Windows.h>
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #define SGCT_ERRNO WSAGetLastError()
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <errno.h>
+    #include <unistd.h>
+    #define SOCKET_ERROR (-1)
+    #define INVALID_SOCKET (~0)
+    #define SGCT_ERRNO errno
+#endif
+
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <random>
+
+#define Err(code, msg) Error(Error::Component::Network, code, msg)
+
+namespace {
+    // Stay below the Ethernet MTU of 1500 bytes minus the IP and UDP headers so that the
+    // datagrams are never fragmented by the IP layer
+    constexpr const int MaxDatagramSize = 1472;
+
+    // Large sync messages are split into hundreds of datagrams that have to be buffered
+    // by the operating system until the receiving thread picks them up
+    constexpr const int SocketBufferSize = 4 * 1024 * 1024;
+
+    // No sync message comes close to this size, but it keeps a stray datagram from
+    // making the receiver allocate gigabytes for a message that will never be complete
+    constexpr const uint32_t MaxMessageSize = 64 * 1024 * 1024;
+
+    struct FragmentHeader {
+        uint32_t session;
+        uint32_t sequence;
+        uint32_t size;
+        uint32_t index;
+        uint32_t count;
+    };
+    constexpr const uint32_t MaxFragmentSize = MaxDatagramSize - sizeof(FragmentHeader);
+
+    uint32_t fragmentCount(uint32_t size) {
+        return std::max(1u, (size + MaxFragmentSize - 1) / MaxFragmentSize);
+    }
+
+    void closeSocket(SGCT_SOCKET s) {
+#ifdef WIN32
+        closesocket(s);
+#else
+        close(s);
+#endif
+    }
+
+    template <typename T>
+    int setOption(SGCT_SOCKET s, int level, int option, const T& value) {
+        return setsockopt(
+            s,
+            level,
+            option,
+            reinterpret_cast<const char*>(&value),
+            sizeof(T)
+        );
+    }
+} // namespace
+
+namespace sgct {
+
+MulticastChannel::MulticastChannel(const std::string& group, int port,
+                                   const std::string& interfaceAddress, bool isSender)
+    : _socket(INVALID_SOCKET)
+    , _isSender(isSender)
+{
+    ZoneScoped
+
+    in_addr groupAddr;
+    if (inet_pton(AF_INET, group.c_str(), &groupAddr) != 1) {
+        throw Err(5030, fmt::format("Invalid multicast group address {}", group));
+    }
+    _group = groupAddr.s_addr;
+    _port = htons(static_cast<uint16_t>(port));
+
+    in_addr interfaceAddr;
+    interfaceAddr.s_addr = htonl(INADDR_ANY);
+    if (!interfaceAddress.empty() &&
+        inet_pton(AF_INET, interfaceAddress.c_str(), &interfaceAddr) != 1)
+    {
+        throw Err(
+            5030,
+            fmt::format("Invalid multicast interface address {}", interfaceAddress)
+        );
+    }
+
+    _socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (_socket == INVALID_SOCKET) {
+        throw Err(
+            5031,
+            fmt::format("Failed to create multicast socket: {}", SGCT_ERRNO)
+        );
+    }
+
+    if (_isSender) {
+        // Other clusters might use the same group and port, so every master picks a
+        // session that its clients learn through their sync connections
+        std::random_device rd;
+        do {
+            _session = rd();
+        } while (_session == 0);
+
+        setOption(_socket, SOL_SOCKET, SO_SNDBUF, SocketBufferSize);
+
+        // Clients running on the same computer as the master, for example when testing
+        // on a single computer, have to receive the messages through the loopback
+        const unsigned char loop = 1;
+        setOption(_socket, IPPROTO_IP, IP_MULTICAST_LOOP, loop);
+        const unsigned char ttl = 1;
+        setOption(_socket, IPPROTO_IP, IP_MULTICAST_TTL, ttl);
+        if (!interfaceAddress.empty()) {
+            setOption(_socket, IPPROTO_IP, IP_MULTICAST_IF, interfaceAddr);
+        }
+        _sendBuffer.resize(MaxDatagramSize);
+        Log::Info("Sending sync data to multicast group {}:{}", group, port);
+        return;
+    }
+
+    // Multiple clients on the same computer have to be able to share the port
+    const int reuse = 1;
+    setOption(_socket, SOL_SOCKET, SO_REUSEADDR, reuse);
+#ifdef SO_REUSEPORT
+    setOption(_socket, SOL_SOCKET, SO_REUSEPORT, reuse);
+#endif // SO_REUSEPORT
+    setOption(_socket, SOL_SOCKET, SO_RCVBUF, SocketBufferSize);
+
+    // Wake up regularly so that the receiving thread can check for termination
+#ifdef WIN32
+    const DWORD timeout = 100;
+#else // WIN32
+    timeval timeout = { 0, 100000 };
+#endif // WIN32
+    setOption(_socket, SOL_SOCKET, SO_RCVTIMEO, timeout);
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = _port;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        const int err = SGCT_ERRNO;
+        closeSocket(_socket);
+        throw Err(5032, fmt::format("Failed to bind multicast socket: {}", err));
+    }
+
+    ip_mreq request = {};
+    request.imr_multiaddr = groupAddr;
+    request.imr_interface = interfaceAddr;
+    if (setOption(_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, request) != 0) {
+        const int err = SGCT_ERRNO;
+        closeSocket(_socket);
+        throw Err(
+            5033,
+            fmt::format("Failed to join multicast group {}: {}", group, err)
+        );
+    }
+
+    _thread = std::make_unique<std::thread>([this]() { receiveLoop(); });
+    Log::Info("Joined multicast group {}:{}", group, port);
+}
+
+MulticastChannel::~MulticastChannel() {
+    _shouldTerminate = true;
+    if (_thread) {
+        _thread->join();
+    }
+    closeSocket(_socket);
+}
+
+void MulticastChannel::send(uint32_t sequence, const void* data, uint32_t size) {
+    ZoneScoped
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = _port;
+    addr.sin_addr.s_addr = _group;
+
+    if (size > MaxMessageSize) {
+        // The clients request the message over their sync connections instead
+        Log::Warning("Multicast message {} is too large with {} bytes", sequence, size);
+        return;
+    }
+
+    FragmentHeader header;
+    header.session = _session;
+    header.sequence = sequence;
+    header.size = size;
+    header.count = fragmentCount(size);
+
+    const char* bytes = reinterpret_cast<const char*>(data);
+    for (header.index = 0; header.index < header.count; header.index++) {
+        const uint32_t offset = header.index * MaxFragmentSize;
+        const uint32_t length = std::min<uint32_t>(size - offset, MaxFragmentSize);
+        std::memcpy(_sendBuffer.data(), &header, sizeof(FragmentHeader));
+        std::memcpy(_sendBuffer.data() + sizeof(FragmentHeader), bytes + offset, length);
+
+        const int res = sendto(
+            _socket,
+            _sendBuffer.data(),
+            static_cast<int>(sizeof(FragmentHeader) + length),
+            0,
+            reinterpret_cast<const sockaddr*>(&addr),
+            sizeof(addr)
+        );
+        if (res == SOCKET_ERROR) {
+            // A lost datagram is requested again by the clients, so there is no need to
+            // stop sending the remaining fragments
+            Log::Warning("Failed to send multicast message {}: {}", sequence, SGCT_ERRNO);
+        }
+    }
+}
+
+uint32_t MulticastChannel::session() const {
+    return _session;
+}
+
+bool MulticastChannel::receive(uint32_t session, uint32_t sequence,
+                               std::vector<char>& data, std::chrono::milliseconds timeout)
+{
+    ZoneScoped
+
+    // Datagrams of other sessions are dropped from now on
+    _session = session;
+
+    std::unique_lock lock(_mutex);
+    const Message& msg = _messages[sequence % _messages.size()];
+    auto isComplete = [&]() {
+        return msg.session == session && msg.sequence == sequence &&
+               !msg.hasFragment.empty() && msg.nMissingFragments == 0;
+    };
+    // If the master is far ahead, a newer message has already taken the slot and there
+    // is no point in waiting for the requested one
+    auto isReplaced = [&]() { return msg.session == session && msg.sequence > sequence; };
+    _cond.wait_for(lock, timeout, [&]() { return isComplete() || isReplaced(); });
+    if (isComplete()) {
+        data.assign(msg.data.begin(), msg.data.end());
+        return true;
+    }
+    return false;
+}
+
+void MulticastChannel::receiveLoop() {
+    std::vector<char> buffer(MaxDatagramSize);
+    while (!_shouldTerminate) {
+        const int res = recvfrom(_socket, buffer.data(), MaxDatagramSize, 0, 0, 0);
+        if (res <= 0) {
+            continue;
+        }
+        try {
+            addFragment(buffer.data(), res);
+        }
+        catch (const std::bad_alloc&) {
+            // The message is dropped and requested again over the sync connection
+            Log::Warning("Not enough memory for a multicast message");
+        }
+    }
+}
+
+void MulticastChannel::addFragment(const char* datagram, int size) {
+    if (size < static_cast<int>(sizeof(FragmentHeader))) {
+        return;
+    }
+    FragmentHeader header;
+    std::memcpy(&header, datagram, sizeof(FragmentHeader));
+    const uint32_t session = _session;
+    if (header.session == 0 || (session != 0 && header.session != session)) {
+        // Sent by another cluster. Until the first announcement, all messages are kept
+        // with their session, which receive compares against the announced one
+        return;
+    }
+
+    // Every fragment but the last one is full, so the fragment has to end exactly where
+    // the next one starts. Otherwise a message could be complete with bytes missing
+    const uint32_t length = static_cast<uint32_t>(size) - sizeof(FragmentHeader);
+    if (header.size > MaxMessageSize || header.count != fragmentCount(header.size) ||
+        header.index >= header.count)
+    {
+        return;
+    }
+    const uint32_t offset = header.index * MaxFragmentSize;
+    if (length != std::min(header.size - offset, MaxFragmentSize)) {
+        return;
+    }
+
+    std::unique_lock lock(_mutex);
+    Message& msg = _messages[header.sequence % _messages.size()];
+    if (msg.session != header.session || msg.sequence != header.sequence ||
+        msg.hasFragment.size() != header.count || msg.data.size() != header.size)
+    {
+        // The first fragment of a new message replaces the oldest message
+        msg.session = header.session;
+        msg.sequence = header.sequence;
+        msg.nMissingFragments = header.count;
+        msg.hasFragment.assign(header.count, false);
+        msg.data.resize(header.size);
+    }
+    if (msg.hasFragment[header.index]) {
+        return;
+    }
+    std::memcpy(msg.data.data() + offset, datagram + sizeof(FragmentHeader), length);
+    msg.hasFragment[header.index] = true;
+    msg.nMissingFragments--;
+
+    if (msg.nMissingFragments == 0) {
+        lock.unlock();
+        _cond.notify_all();
+    }
+}
+
+} // namespace sgct
@@ -19,10 +19,12 @@
 #else
     #include <sys/types.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include <netinet/in.h>
     #include <netinet/tcp.h>
     #include <arpa/inet.h>
     #include <errno.h>
+    #include <fcntl.h>
     #include <netdb.h>
     #include <unistd.h>
     #define SOCKET_ERROR (-1)
@@ -31,15 +33,18 @@
     #define SGCT_ERRNO errno
 #endif
 
+#include <sgct/clusterclock.h>
 #include <sgct/clustermanager.h>
-#include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/log.h>
 #include <sgct/mutexes.h>
 #include <sgct/networkmanager.h>
+#include <sgct/networkreactor.h>
 #include <sgct/profiling.h>
 #include <sgct/shareddata.h>
+#include <sgct/sharedmemorychannel.h>
+#include <zlib.h>
 #include <algorithm>
 #include <cstring>
 
@@ -52,6 +57,20 @@ namespace {
 
     constexpr const int MaxNetworkSyncFrameNumber = 10000;
 
+    // The messages are limited by the sync and the data transfer protocol, so a send
+    // queue of this size means that the receiver has stopped reading altogether
+    constexpr const size_t MaxPendingDataSize = 256 * 1024 * 1024;
+
+#ifdef MSG_NOSIGNAL
+    // A peer that has closed the connection results in an error instead of SIGPIPE
+    constexpr const int SendFlags = MSG_NOSIGNAL;
+#else // MSG_NOSIGNAL
+    constexpr const int SendFlags = 0;
+#endif // MSG_NOSIGNAL
+
+    // The number of system calls that were made on the sockets of all connections
+    std::atomic<uint64_t> nSyscalls = 0;
+
     std::string getTypeStr(sgct::Network::ConnectionType ct) {
         using N = sgct::Network;
         switch (ct) {
@@ -68,11 +87,38 @@ namespace {
         };
         return std::string_view(header, 8) == std::string_view(rhs, 8);
     }
+
+    bool wouldBlock() {
+#ifdef WIN32
+        return SGCT_ERRNO == WSAEWOULDBLOCK;
+#else
+        return SGCT_ERRNO == EAGAIN || SGCT_ERRNO == EWOULDBLOCK;
+#endif
+    }
+
+    bool isInterrupted() {
+#ifdef WIN32
+        return SGCT_ERRNO == WSAEINTR;
+#else
+        return SGCT_ERRNO == EINTR;
+#endif
+    }
+
+    void setNonBlocking(SGCT_SOCKET socket) {
+#ifdef WIN32
+        u_long mode = 1;
+        ioctlsocket(socket, FIONBIO, &mode);
+#else
+        const int flags = fcntl(socket, F_GETFL, 0);
+        fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+#endif
+    }
 } // namespace
 
 namespace sgct {
 
-Network::Network(int port, std::string address, bool isServer, ConnectionType t)
+Network::Network(int port, std::string address, bool isServer, ConnectionType t,
+                 bool useSharedMemory)
     : _socket(INVALID_SOCKET)
     , _listenSocket(INVALID_SOCKET)
     , _connectionType(t)
@@ -88,6 +134,18 @@ Network::Network(int port, std::string address, bool isServer, ConnectionType t)
         _uncompressedBufferSize = _bufferSize;
     }
 
+    if (useSharedMemory) {
+        _sharedMemory = std::make_unique<SharedMemoryChannel>(_port, _isServer);
+        while (!_isServer && !_shouldTerminate && !_sharedMemory->connect()) {
+            Log::Info(
+                "Attempting to connect to server (id: {}, shared memory, type: {})",
+                _id, getTypeStr(type())
+            );
+            std::this_thread::sleep_for(std::chrono::seconds(1)); // wait for next attempt
+        }
+        return;
+    }
+
     addrinfo* res = nullptr;
     addrinfo hints;
     std::memset(&hints, 0, sizeof(hints));
@@ -141,10 +199,10 @@ Network::Network(int port, std::string address, bool isServer, ConnectionType t)
     else {
         // Client socket: Connect to server
         while (!_shouldTerminate) {
-            Log::Info(fmt::format(
+            Log::Info(
                 "Attempting to connect to server (id: {}, ip: {}, type: {})",
                 _id, address.c_str(), getTypeStr(type()).c_str()
-            ));
+            );
 
             _socket = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
             if (_socket == INVALID_SOCKET) {
@@ -163,7 +221,7 @@ Network::Network(int port, std::string address, bool isServer, ConnectionType t)
                 Log::Debug("Waiting for connection...");
             }
             else {
-                Log::Debug(fmt::format("Connect error code: {}", SGCT_ERRNO));
+                Log::Debug("Connect error code: {}", SGCT_ERRNO);
             }
             std::this_thread::sleep_for(std::chrono::seconds(1)); // wait for next attempt
         }
@@ -176,8 +234,27 @@ Network::~Network() {
     closeNetwork(false);
 }
 
-void Network::initialize() {
-    _mainThread = std::make_unique<std::thread>([this]() { connectionHandler(); });
+void Network::initialize(NetworkReactor* reactor) {
+    if (_sharedMemory) {
+        _commThread = std::make_unique<std::thread>([this]() { sharedMemoryHandler(); });
+        return;
+    }
+
+    if (!reactor) {
+        _mainThread = std::make_unique<std::thread>([this]() { connectionHandler(); });
+        return;
+    }
+
+    _reactor = reactor;
+    if (_isServer) {
+        Log::Info("Waiting for client {} to connect on port {}", _id, port());
+        setNonBlocking(_listenSocket);
+        _reactor->add(_listenSocket, *this);
+    }
+    else {
+        setNonBlocking(_socket);
+        acceptReactorConnection();
+    }
 }
 
 void Network::connectionHandler() {
@@ -218,7 +295,24 @@ void Network::connectionHandler() {
         });
     }
 
-    Log::Info(fmt::format("Exiting connection handler for connection {}", _id));
+    Log::Info("Exiting connection handler for connection {}", _id);
+}
+
+void Network::sharedMemoryHandler() {
+    // There is no listening socket, so the server accepts the next client on the same
+    // thread once the previous one has disconnected
+    do {
+        try {
+            communicationHandler();
+        }
+        catch (const std::runtime_error& e) {
+            Log::Error(e.what());
+            setConnectedStatus(false);
+        }
+        if (_isServer) {
+            _sharedMemory->reset();
+        }
+    } while (_isServer && !_shouldTerminate);
 }
 
 int Network::port() const {
@@ -344,23 +438,36 @@ int Network::iterateFrameCounter() {
 
     {
         std::unique_lock lock(_connectionMutex);
-        _timeStampSend = Engine::getTime();
+        _timeStampSend = ClusterClock::instance().localTime();
     }
 
     return _currentSendFrame;
 }
 
-void Network::pushClientMessage() {
+void Network::pushClientMessage(const char* data, uint32_t size) {
     // The servers' render function is locked until an ack message is received
     const int currentFrame = iterateFrameCounter();
-    uint32_t localSyncHeaderSize = 0;
 
-    char data[HeaderSize];
-    data[0] = Network::DataId;
-    std::memcpy(data + 1, &currentFrame, sizeof(currentFrame));
-    std::memcpy(data + 5, &localSyncHeaderSize, sizeof(localSyncHeaderSize));
+    char header[HeaderSize];
+    header[0] = Network::DataId;
+    std::memcpy(header + 1, &currentFrame, sizeof(currentFrame));
+    std::memcpy(header + 5, &size, sizeof(size));
+    std::memset(header + 9, DefaultId, 4);
+    sendData(header, HeaderSize, data, static_cast<int>(size));
+}
+
+void Network::sendTimeRequest() {
+    const int32_t unused = 0;
+    const uint32_t size = sizeof(double);
+    const double t0 = ClusterClock::instance().localTime();
+
+    char data[HeaderSize + sizeof(double)];
+    data[0] = TimeSyncId;
+    std::memcpy(data + 1, &unused, sizeof(unused));
+    std::memcpy(data + 5, &size, sizeof(size));
     std::memset(data + 9, DefaultId, 4);
-    sendData(data, HeaderSize);
+    std::memcpy(data + HeaderSize, &t0, sizeof(t0));
+    queueData(data, sizeof(data));
 }
 
 int Network::sendFrameCurrent() const {
@@ -383,9 +490,20 @@ double Network::loopTime() const {
     return _timeStampTotal;
 }
 
+int Network::framesInFlight() const {
+    // The frame numbers wrap around after MaxNetworkSyncFrameNumber
+    const int diff = _currentSendFrame - _currentRecvFrame;
+    return diff >= 0 ? diff : diff + MaxNetworkSyncFrameNumber + 1;
+}
+
 bool Network::isUpdated() const {
     bool state = false;
-    if (_isServer) {
+    const int renderAhead = ClusterManager::instance().renderAhead();
+    if (_isServer && renderAhead > 0) {
+        // The master may send frames until the client lags behind by too many of them
+        state = framesInFlight() <= renderAhead;
+    }
+    else if (_isServer) {
         state = ClusterManager::instance().firmFrameLockSyncStatus() ?
             // master sends first -> so on reply they should be equal
             (_currentRecvFrame == _currentSendFrame) :
@@ -419,6 +537,30 @@ void Network::setConnectedFunction(std::function<void(void)> fn) {
     _connectedCallback = std::move(fn);
 }
 
+void Network::setForwardFunction(
+                           std::function<void(const char*, const char*, uint32_t)> fn)
+{
+    _forwardCallback = std::move(fn);
+}
+
+void Network::setMulticastFunction(
+                           std::function<bool(uint32_t, uint32_t, std::vector<char>&)> fn)
+{
+    _multicastCallback = std::move(fn);
+}
+
+void Network::setNackFunction(std::function<void(int32_t, uint32_t)> fn) {
+    _nackCallback = std::move(fn);
+}
+
+void Network::setOfferReplyFunction(std::function<void(int, bool)> fn) {
+    _offerReplyCallback = std::move(fn);
+}
+
+void Network::setDataTransferCache(const DataTransferCache* cache) {
+    _dataTransferCache = cache;
+}
+
 void Network::setAcknowledgeFunction(std::function<void(int, int)> fn) {
     _acknowledgeCallback = std::move(fn);
 }
@@ -433,7 +575,6 @@ bool Network::isConnected() const {
 }
 
 Network::ConnectionType Network::type() const {
-    std::unique_lock lock(_connectionMutex);
     return _connectionType;
 }
 
@@ -450,19 +591,24 @@ void Network::setRecvFrame(int i) {
     _currentRecvFrame = i;
     _isUpdated = true;
 
-    _timeStampTotal = Engine::getTime() - _timeStampSend;
+    _timeStampTotal = ClusterClock::instance().localTime() - _timeStampSend;
 }
 
 int Network::lastError() {
     return SGCT_ERRNO;
 }
 
+uint64_t Network::syscallCount() {
+    return nSyscalls + SharedMemoryChannel::syscallCount();
+}
+
 int Network::receiveData(SGCT_SOCKET& lsocket, char* buffer, int length, int flags) {
     long iResult = 0;
     int attempts = 1;
 
     while (iResult < length) {
         long tmpRes = recv(lsocket, buffer + iResult, length - iResult, flags);
+        nSyscalls++;
         if (tmpRes > 0) {
             iResult += tmpRes;
         }
@@ -471,9 +617,9 @@ int Network::receiveData(SGCT_SOCKET& lsocket, char* buffer, int length, int fla
 #else
         else if (SGCT_ERRNO == EINTR && attempts <= MaxNumberOfAttempts) {
 #endif
-            Log::Warning(fmt::format(
+            Log::Warning(
                 "Receiving data after interrupted system error (attempt {})", attempts
-            ));
+            );
             attempts++;
         }
         else {
@@ -499,41 +645,112 @@ void Network::updateBuffer(std::vector<char>& buf, uint32_t reqSize, uint32_t& c
     curSize = reqSize;
 }
 
-int Network::readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize,
-                             uint32_t& uncompressedDataSize)
+void Network::parseHeader(const char* header, int32_t& id, uint32_t& dataSize,
+                          uint32_t& uncompressedDataSize)
 {
-    int iResult = receiveData(_socket, header, static_cast<int>(HeaderSize), 0);
-
-    if (iResult == static_cast<int>(HeaderSize)) {
-        _headerId = header[0];
-        if (_headerId == DataId) {
-            std::memcpy(&syncFrame, header + 1, sizeof(syncFrame));
-            std::memcpy(&dataSize, header + 5, sizeof(dataSize));
-            std::memcpy(&uncompressedDataSize, header + 9, sizeof(uncompressedDataSize));
-
-            setRecvFrame(syncFrame);
-            if (syncFrame < 0) {
-                const std::string s = std::to_string(syncFrame);
+    _headerId = header[0];
+    const bool isData = _headerId == DataId || _headerId == CompressedDataId;
+    if (isData || _headerId == DataChunkId || _headerId == DataOfferId ||
+        _headerId == TimeSyncId)
+    {
+        // parse the sync frame number or the package id
+        std::memcpy(&id, header + 1, sizeof(id));
+        std::memcpy(&dataSize, header + 5, sizeof(dataSize));
+        std::memcpy(&uncompressedDataSize, header + 9, sizeof(uncompressedDataSize));
+
+        if (_connectionType == ConnectionType::SyncConnection && isData) {
+            if (id < 0) {
+                const std::string s = std::to_string(id);
                 const std::string i = std::to_string(_id);
                 throw Err(
                     5010,
                     fmt::format("Error in sync frame {} for connection {}", s, i)
                 );
             }
+            // An acknowledgement with data only counts as received once the data was
+            // decoded, which happens in handleSyncData
+            if (!_isServer || dataSize == 0) {
+                setRecvFrame(id);
+            }
+        }
 
-            // resize buffer if needed
-            updateBuffer(_recvBuffer, dataSize, _bufferSize);
+        // resize buffer if needed; the uncompressed size is only set for compressed data
+        updateBuffer(_recvBuffer, dataSize, _bufferSize);
+        if (_headerId == CompressedDataId) {
             updateBuffer(
                 _uncompressBuffer,
                 uncompressedDataSize,
                 _uncompressedBufferSize
             );
         }
+        else {
+            uncompressedDataSize = 0;
+        }
+    }
+    else if (_headerId == MulticastDataId || _headerId == Nack) {
+        // These messages have no payload; instead, the last four bytes of the header
+        // contain the sequence number of the multicast message. The announcement of a
+        // multicast message carries the master's session in place of the size
+        std::memcpy(&id, header + 1, sizeof(id));
+        std::memcpy(&uncompressedDataSize, header + 9, sizeof(uncompressedDataSize));
+    }
+    else if (_headerId == Ack && _connectionType == ConnectionType::DataTransfer &&
+             _acknowledgeCallback != nullptr)
+    {
+        std::memcpy(&id, header + 1, sizeof(id));
+        _acknowledgeCallback(id, _id);
+    }
+}
+
+int Network::receive(char* buffer, int length) {
+    if (_sharedMemory) {
+        if (_hasQueuedData) {
+            std::unique_lock lock(_sendMutex);
+            flushQueuedData();
+        }
+        const uint32_t size = static_cast<uint32_t>(length);
+        return _sharedMemory->receive(buffer, size) ? length : 0;
+    }
+
+    int nReceived = 0;
+#ifndef WIN32
+    // The queued replies are only sent once there is nothing left to read, so that the
+    // replies to several messages that arrived together are sent at once
+    if (_hasQueuedData) {
+        const long res = recv(_socket, buffer, length, MSG_DONTWAIT);
+        nSyscalls++;
+        if (res == length || res == 0) {
+            return static_cast<int>(res);
+        }
+        if (res > 0) {
+            nReceived = static_cast<int>(res);
+        }
+        else if (!wouldBlock() && !isInterrupted()) {
+            return static_cast<int>(res);
+        }
+    }
+#endif // WIN32
+
+    if (_hasQueuedData) {
+        std::unique_lock lock(_sendMutex);
+        flushQueuedData();
+    }
+    const int res = receiveData(_socket, buffer + nReceived, length - nReceived, 0);
+    return res > 0 ? res + nReceived : res;
+}
+
+int Network::readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize,
+                             uint32_t& uncompressedDataSize)
+{
+    int iResult = receive(header, static_cast<int>(HeaderSize));
+
+    if (iResult == static_cast<int>(HeaderSize)) {
+        parseHeader(header, syncFrame, dataSize, uncompressedDataSize);
     }
 
     // Get the data/message
     if (dataSize > 0) {
-        iResult = receiveData(_socket, _recvBuffer.data(), dataSize, 0);
+        iResult = receive(_recvBuffer.data(), dataSize);
     }
 
     return iResult;
@@ -542,33 +759,15 @@ int Network::readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSiz
 int Network::readDataTransferMessage(char* header, int32_t& packageId, uint32_t& dataSize,
                                      uint32_t& uncompressedDataSize)
 {
-    int iResult = receiveData(_socket, header, static_cast<int>(HeaderSize), 0);
+    int iResult = receive(header, static_cast<int>(HeaderSize));
 
     if (iResult == static_cast<int>(HeaderSize)) {
-        _headerId = header[0];
-        if (_headerId == DataId) {
-            // parse the package _id
-            std::memcpy(&packageId, header + 1, sizeof(packageId));
-            std::memcpy(&dataSize, header + 5, sizeof(dataSize));
-            std::memcpy(&uncompressedDataSize, header + 9, sizeof(uncompressedDataSize));
-
-            // resize buffer if needed
-            updateBuffer(_recvBuffer, dataSize, _bufferSize);
-            updateBuffer(
-                _uncompressBuffer,
-                uncompressedDataSize,
-                _uncompressedBufferSize
-            );
-        }
-        else if (_headerId == Ack && _acknowledgeCallback != nullptr) {
-            std::memcpy(&packageId, header + 1, sizeof(packageId));
-            _acknowledgeCallback(packageId, _id);
-        }
+        parseHeader(header, packageId, dataSize, uncompressedDataSize);
     }
 
     // Get the data/message
     if (dataSize > 0 && packageId > -1) {
-        iResult = receiveData(_socket, _recvBuffer.data(), dataSize, 0);
+        iResult = receive(_recvBuffer.data(), dataSize);
     }
 
     return iResult;
@@ -576,52 +775,420 @@ int Network::readDataTransferMessage(char* header, int32_t& packageId, uint32_t&
 
 int Network::readExternalMessage() {
     long iResult = recv(_socket, _recvBuffer.data(), _bufferSize, 0);
+    nSyscalls++;
 
     // if read fails try for x attempts
     int attempts = 1;
-#ifdef WIN32
-    while (iResult <= 0 && SGCT_ERRNO == WSAEINTR && attempts <= MaxNumberOfAttempts) {
-#else
-    while (iResult <= 0 && SGCT_ERRNO == EINTR && attempts <= MaxNumberOfAttempts) {
-#endif
+    while (iResult <= 0 && isInterrupted() && attempts <= MaxNumberOfAttempts) {
         iResult = recv(_socket, _recvBuffer.data(), _bufferSize, 0);
-        Log::Info(fmt::format(
-            "Receiving data after interrupted system error (attempt {})", attempts
-        ));
+        nSyscalls++;
+        Log::Info("Receiving data after interrupted system error (attempt {})", attempts);
         attempts++;
     }
 
     return static_cast<int>(iResult);
 }
 
+char* Network::messagePayload(uint32_t& dataSize, uint32_t uncompressedDataSize) {
+    if (_headerId != CompressedDataId) {
+        return _recvBuffer.data();
+    }
+
+    uLongf size = static_cast<uLongf>(uncompressedDataSize);
+    const int err = uncompress(
+        reinterpret_cast<Bytef*>(_uncompressBuffer.data()),
+        &size,
+        reinterpret_cast<const Bytef*>(_recvBuffer.data()),
+        static_cast<uLong>(dataSize)
+    );
+    if (err != Z_OK) {
+        const bool isSync = _connectionType == ConnectionType::SyncConnection;
+        throw Err(
+            isSync ? 5011 : 5012,
+            fmt::format("Failed to uncompress data for connection {}: {}", _id, err)
+        );
+    }
+    dataSize = static_cast<uint32_t>(size);
+    return _uncompressBuffer.data();
+}
+
+void Network::handleSyncData(const char* header, uint32_t dataSize,
+                             uint32_t uncompressedDataSize)
+{
+    if (_forwardCallback) {
+        _forwardCallback(header, _recvBuffer.data(), dataSize);
+    }
+    if (decoderCallback && dataSize > 0) {
+        char* data = messagePayload(dataSize, uncompressedDataSize);
+        decoderCallback(data, dataSize);
+    }
+    if (_isServer && dataSize > 0) {
+        int32_t frame = 0;
+        std::memcpy(&frame, header + 1, sizeof(frame));
+        setRecvFrame(frame);
+    }
+
+    NetworkManager::barrier.notify();
+}
+
+void Network::handleTimeSync(uint32_t dataSize) {
+    ClusterClock& clock = ClusterClock::instance();
+    if (_isServer) {
+        if (dataSize != sizeof(double)) {
+            throw Err(
+                5037,
+                fmt::format("Received malformed time sync message on connection {}", _id)
+            );
+        }
+        const double t1 = clock.time();
+        const int32_t unused = 0;
+        const uint32_t size = 3 * sizeof(double);
+
+        // The reply contains the client's send time and the server's receive time
+        // followed by the server's send time
+        char data[HeaderSize + 3 * sizeof(double)];
+        data[0] = TimeSyncId;
+        std::memcpy(data + 1, &unused, sizeof(unused));
+        std::memcpy(data + 5, &size, sizeof(size));
+        std::memset(data + 9, DefaultId, 4);
+        std::memcpy(data + HeaderSize, _recvBuffer.data(), sizeof(double));
+        std::memcpy(data + HeaderSize + sizeof(double), &t1, sizeof(t1));
+        const double t2 = clock.time();
+        std::memcpy(data + HeaderSize + 2 * sizeof(double), &t2, sizeof(t2));
+        sendData(data, sizeof(data));
+    }
+    else {
+        const double t3 = clock.localTime();
+        if (dataSize != 3 * sizeof(double)) {
+            throw Err(
+                5037,
+                fmt::format("Received malformed time sync message on connection {}", _id)
+            );
+        }
+        double t[3];
+        std::memcpy(t, _recvBuffer.data(), sizeof(t));
+        clock.addSample(t[0], t[1], t[2], t3);
+    }
+}
+
+void Network::handleDataChunk(int32_t packageId, uint32_t dataSize) {
+    ZoneScoped
+
+    constexpr const uint32_t ChunkHeaderSize = 3 * sizeof(uint32_t);
+    if (dataSize < ChunkHeaderSize) {
+        throw Err(
+            5035,
+            fmt::format("Received malformed data chunk for package {}", packageId)
+        );
+    }
+    uint32_t offset = 0;
+    uint32_t totalSize = 0;
+    uint32_t uncompressedSize = 0;
+    std::memcpy(&offset, _recvBuffer.data(), sizeof(uint32_t));
+    std::memcpy(&totalSize, _recvBuffer.data() + 4, sizeof(uint32_t));
+    std::memcpy(&uncompressedSize, _recvBuffer.data() + 8, sizeof(uint32_t));
+    const uint32_t length = dataSize - ChunkHeaderSize;
+
+    IncomingPackage& package = _incomingPackages[packageId];
+    if (offset == 0) {
+        // The first chunk of a package that might reuse the id of an earlier package
+        package.data.resize(totalSize);
+        package.nReceived = 0;
+    }
+    if (package.data.size() != totalSize || offset + length > totalSize) {
+        _incomingPackages.erase(packageId);
+        throw Err(
+            5035,
+            fmt::format("Received malformed data chunk for package {}", packageId)
+        );
+    }
+    if (length > 0) {
+        const char* chunk = _recvBuffer.data() + ChunkHeaderSize;
+        std::memcpy(package.data.data() + offset, chunk, length);
+    }
+    package.nReceived += length;
+
+    if (package.nReceived == totalSize) {
+        char* data = package.data.data();
+        const std::optional<DataTransferCache::Key> key = package.key;
+        uint32_t size = totalSize;
+        std::vector<char> uncompressed;
+        if (uncompressedSize > 0) {
+            ZoneScopedN("Uncompress")
+
+            uncompressed.resize(uncompressedSize);
+            uLongf s = static_cast<uLongf>(uncompressedSize);
+            const int err = uncompress(
+                reinterpret_cast<Bytef*>(uncompressed.data()),
+                &s,
+                reinterpret_cast<const Bytef*>(package.data.data()),
+                static_cast<uLong>(totalSize)
+            );
+            if (err != Z_OK) {
+                _incomingPackages.erase(packageId);
+                throw Err(
+                    5012,
+                    fmt::format(
+                        "Failed to uncompress data for connection {}: {}", _id, err
+                    )
+                );
+            }
+            data = uncompressed.data();
+            size = static_cast<uint32_t>(s);
+        }
+
+        // The package has to be stored before it is decoded as the decode function is
+        // allowed to modify the data
+        if (key && _dataTransferCache) {
+            if (DataTransferCache::key(data, size) == *key) {
+                _dataTransferCache->store(*key, data, size);
+            }
+            else {
+                Log::Warning(
+                    "Data transfer package {} does not match its offer", packageId
+                );
+            }
+        }
+
+        if (_packageDecoderCallback) {
+            _packageDecoderCallback(data, size, packageId, _id);
+        }
+        _incomingPackages.erase(packageId);
+    }
+
+    // The sender only sends the next chunk once a slot in its window is free again
+    const uint32_t pLength = 0;
+    char sendBuff[HeaderSize];
+    std::memset(sendBuff, DefaultId, HeaderSize);
+    sendBuff[0] = Ack;
+    std::memcpy(sendBuff + 1, &packageId, sizeof(packageId));
+    std::memcpy(sendBuff + 5, &pLength, sizeof(pLength));
+    queueData(sendBuff, HeaderSize);
+}
+
+void Network::handleDataOffer(int32_t packageId, uint32_t dataSize) {
+    ZoneScoped
+
+    DataTransferCache::Key key;
+    if (dataSize < sizeof(key.hash) + sizeof(key.checksum) + sizeof(key.size)) {
+        throw Err(
+            5036,
+            fmt::format("Received malformed data offer for package {}", packageId)
+        );
+    }
+    std::memcpy(&key.hash, _recvBuffer.data(), sizeof(key.hash));
+    std::memcpy(&key.checksum, _recvBuffer.data() + 8, sizeof(key.checksum));
+    std::memcpy(&key.size, _recvBuffer.data() + 12, sizeof(key.size));
+
+    bool isCached = false;
+    if (_dataTransferCache) {
+        isCached = _dataTransferCache->load(
+            key,
+            [this, packageId](char* data, uint32_t size) {
+                Log::Debug("Loading data transfer package {} from the cache", packageId);
+                if (_packageDecoderCallback) {
+                    _packageDecoderCallback(data, size, packageId, _id);
+                }
+            }
+        );
+        if (!isCached) {
+            _incomingPackages[packageId].key = key;
+        }
+    }
+
+    const uint32_t pLength = 0;
+    const uint32_t reply = isCached ? 1 : 0;
+    char sendBuff[HeaderSize];
+    sendBuff[0] = DataOfferId;
+    std::memcpy(sendBuff + 1, &packageId, sizeof(packageId));
+    std::memcpy(sendBuff + 5, &pLength, sizeof(pLength));
+    std::memcpy(sendBuff + 9, &reply, sizeof(reply));
+    queueData(sendBuff, HeaderSize);
+}
+
+void Network::receiveMulticastMessage(int32_t frame, uint32_t session, uint32_t sequence)
+{
+    ZoneScoped
+
+    const bool hasMessage = _multicastCallback(session, sequence, _multicastBuffer);
+    if (!hasMessage || _multicastBuffer.size() < HeaderSize) {
+        // The server answers with the complete message over this connection
+        Log::Debug("Requesting multicast message {} again", sequence);
+        const uint32_t size = 0;
+        char data[HeaderSize];
+        data[0] = Nack;
+        std::memcpy(data + 1, &frame, sizeof(frame));
+        std::memcpy(data + 5, &size, sizeof(size));
+        std::memcpy(data + 9, &sequence, sizeof(sequence));
+        sendData(data, HeaderSize);
+        return;
+    }
+
+    // The multicast message is the message that would otherwise have been sent over
+    // this connection, except for the frame number that is different for each client
+    std::memcpy(_multicastBuffer.data() + 1, &frame, sizeof(frame));
+    int32_t id = -1;
+    uint32_t dataSize = 0;
+    uint32_t uncompressedDataSize = 0;
+    parseHeader(_multicastBuffer.data(), id, dataSize, uncompressedDataSize);
+    if (dataSize > _multicastBuffer.size() - HeaderSize) {
+        throw Err(
+            5034,
+            fmt::format("Received malformed multicast message {}", sequence)
+        );
+    }
+
+    std::memcpy(_recvBuffer.data(), _multicastBuffer.data() + HeaderSize, dataSize);
+    handleSyncData(_multicastBuffer.data(), dataSize, uncompressedDataSize);
+}
+
+bool Network::processMessage(const char* header, int32_t packageId, uint32_t dataSize,
+                             uint32_t uncompressedDataSize)
+{
+    const bool isData = _headerId == DataId || _headerId == CompressedDataId;
+    if (_connectionType == ConnectionType::SyncConnection) {
+        // handle sync disconnect
+        if (isDisconnectPackage(header)) {
+            setConnectedStatus(false);
+
+            // Terminate client only. The server only resets the connection, allowing
+            // clients to connect.
+            if (!_isServer) {
+                _shouldTerminate = true;
+            }
+
+            Log::Info("Client {} terminated connection", _id);
+            return false;
+        }
+        // handle sync communication
+        if (isData) {
+            handleSyncData(header, dataSize, uncompressedDataSize);
+        }
+        else if (_headerId == MulticastDataId && _multicastCallback) {
+            uint32_t session = 0;
+            std::memcpy(&session, header + 5, sizeof(session));
+            receiveMulticastMessage(packageId, session, uncompressedDataSize);
+        }
+        else if (_headerId == Nack && _nackCallback) {
+            _nackCallback(packageId, uncompressedDataSize);
+        }
+        else if (_headerId == TimeSyncId) {
+            handleTimeSync(dataSize);
+        }
+        else if (_headerId == ConnectedId && _connectedCallback) {
+            _connectedCallback();
+            NetworkManager::barrier.notify();
+        }
+    }
+    // handle data transfer communication
+    else if (_connectionType == ConnectionType::DataTransfer) {
+        // Disconnect if requested
+        if (isDisconnectPackage(header)) {
+            setConnectedStatus(false);
+            Log::Info("File connection {} terminated", _id);
+            return false;
+        }
+
+        //  Handle communication
+        if (_headerId == DataChunkId && dataSize > 0) {
+            handleDataChunk(packageId, dataSize);
+        }
+        else if (_headerId == DataOfferId && dataSize > 0) {
+            handleDataOffer(packageId, dataSize);
+        }
+        else if (_headerId == DataOfferId && _offerReplyCallback) {
+            uint32_t isCached = 0;
+            std::memcpy(&isCached, header + 9, sizeof(isCached));
+            _offerReplyCallback(packageId, isCached != 0);
+        }
+        else if (isData && _packageDecoderCallback && dataSize > 0) {
+            char* data = messagePayload(dataSize, uncompressedDataSize);
+            _packageDecoderCallback(data, dataSize, packageId, _id);
+
+            // send acknowledge
+            uint32_t pLength = 0;
+            char sendBuff[HeaderSize];
+            sendBuff[0] = Ack;
+            std::memcpy(sendBuff + 1, &packageId, sizeof(packageId));
+            std::memcpy(sendBuff + 5, &pLength, sizeof(pLength));
+            queueData(sendBuff, HeaderSize);
+
+            {
+                // Clear the buffers
+                std::unique_lock lk(_connectionMutex);
+
+                _recvBuffer.clear();
+                _uncompressBuffer.clear();
+
+                _bufferSize = 0;
+                _uncompressedBufferSize = 0;
+            }
+        }
+        else if (_headerId == ConnectedId && _connectedCallback) {
+            _connectedCallback();
+            NetworkManager::barrier.notify();
+        }
+    }
+    return true;
+}
+
+bool Network::processExternalMessage(int length) {
+    _extBuffer.append(_recvBuffer.data(), length);
+
+    if (_extBuffer.find(24) != std::string::npos ||
+        _extBuffer.find(27) != std::string::npos ||
+        _extBuffer.find("quit") != std::string::npos)
+    {
+        setConnectedStatus(false);
+        return false;
+    }
+
+    // separate messages by <CR><NL>
+    size_t found = _extBuffer.find("\r\n");
+    while (found != std::string::npos) {
+        std::string extMessage = _extBuffer.substr(0, found);
+        _extBuffer = _extBuffer.substr(found + 2); // jump over \r\n
+
+        if (decoderCallback) {
+            const int size = static_cast<int>(extMessage.size());
+            decoderCallback(extMessage.c_str(), size);
+        }
+
+        // reply
+        std::string msg = "OK\r\n";
+        sendData(msg.c_str(), static_cast<int>(msg.size()));
+        found = _extBuffer.find("\r\n");
+    }
+    return true;
+}
+
 void Network::communicationHandler() {
     if (_shouldTerminate) {
         return;
     }
 
     // listen for client if server
-    if (_isServer) {
+    if (_isServer && _sharedMemory) {
         Log::Info(
-            fmt::format("Waiting for client {} to connect on port {}", _id, port())
+            "Waiting for client {} to connect through shared memory on port {}",
+            _id, port()
         );
+        if (!_sharedMemory->accept()) {
+            return;
+        }
+    }
+    else if (_isServer) {
+        Log::Info("Waiting for client {} to connect on port {}", _id, port());
 
         _socket = accept(_listenSocket, nullptr, nullptr);
 
-#ifdef WIN32
-        while (!_shouldTerminate && _socket == INVALID_SOCKET && SGCT_ERRNO == WSAEINTR) {
-#else
-        while (!_shouldTerminate && _socket == INVALID_SOCKET && SGCT_ERRNO == EINTR) {
-#endif
-            Log::Info(
-                fmt::format("Re-accept after interrupted system on connection {}", _id)
-            );
+        while (!_shouldTerminate && _socket == INVALID_SOCKET && isInterrupted()) {
+            Log::Info("Re-accept after interrupted system on connection {}", _id);
             _socket = accept(_listenSocket, nullptr, nullptr);
         }
 
         if (_socket == INVALID_SOCKET) {
-            Log::Error(
-                fmt::format("Accept connection {} failed. Error: {}", _id, SGCT_ERRNO)
-            );
+            Log::Error("Accept connection {} failed. Error: {}", _id, SGCT_ERRNO);
 
             if (_updateCallback) {
                 _updateCallback(this);
@@ -631,7 +1198,9 @@ void Network::communicationHandler() {
     }
 
     setConnectedStatus(true);
-    Log::Info(fmt::format("Connection {} established", _id));
+    Log::Info(
+        "Connection {} established{}", _id, _sharedMemory ? " through shared memory" : ""
+    );
 
     if (_updateCallback) {
         _updateCallback(this);
@@ -646,16 +1215,14 @@ void Network::communicationHandler() {
         _recvBuffer.resize(_bufferSize);
         _uncompressBuffer.resize(_uncompressedBufferSize);
     }
-    std::string extBuffer; // for external communication
+    _extBuffer.clear();
 
     // Receive data until the server closes the connection
     int iResult = 0;
     do {
         // resize buffer request
         if (type() != ConnectionType::DataTransfer && _requestedSize > _bufferSize) {
-            Log::Info(fmt::format(
-                "Re-sizing buffer {} -> {}", _bufferSize, _requestedSize.load()
-            ));
+            Log::Info("Re-sizing buffer {} -> {}", _bufferSize, _requestedSize.load());
             updateBuffer(_recvBuffer, _requestedSize, _bufferSize);
         }
         int32_t packageId = -1;
@@ -665,10 +1232,9 @@ void Network::communicationHandler() {
         _headerId = DefaultId;
 
         if (type() == ConnectionType::SyncConnection) {
-            int32_t syncFrameNumber = -1;
             iResult = readSyncMessage(
                 RecvHeader,
-                syncFrameNumber,
+                packageId,
                 dataSize,
                 uncompressedDataSize
             );
@@ -688,7 +1254,9 @@ void Network::communicationHandler() {
         // handle failed receive
         if (iResult == 0) {
             setConnectedStatus(false);
-            Log::Info(fmt::format("TCP connection {} closed", _id));
+            Log::Info(
+                "{} connection {} closed", _sharedMemory ? "Shared memory" : "TCP", _id
+            );
         }
         else if (iResult < 0) {
             setConnectedStatus(false);
@@ -697,133 +1265,406 @@ void Network::communicationHandler() {
                 fmt::format("TCP connection {} receive failed: {}", _id, SGCT_ERRNO)
             );
         }
-
-        if (type() == ConnectionType::SyncConnection) {
-            // handle sync disconnect
-            if (isDisconnectPackage(RecvHeader)) {
-                setConnectedStatus(false);
-
-                // Terminate client only. The server only resets the connection,
-                // allowing clients to connect.
-                if (!_isServer) {
-                    _shouldTerminate = true;
-                }
-
-                Log::Info(fmt::format("Client {} terminated connection", _id));
+        else if (type() == ConnectionType::ExternalConnection) {
+            if (!processExternalMessage(iResult)) {
                 break;
             }
-            // handle sync communication
-            if (_headerId == DataId && decoderCallback) {
-                if (dataSize > 0) {
-                    decoderCallback(_recvBuffer.data(), dataSize);
-                }
-
-                NetworkManager::cond.notify_all();
-            }
-            else if (_headerId == ConnectedId && _connectedCallback) {
-                _connectedCallback();
-                NetworkManager::cond.notify_all();
+        }
+        else {
+            const bool keepConnection = processMessage(
+                RecvHeader,
+                packageId,
+                dataSize,
+                uncompressedDataSize
+            );
+            if (!keepConnection) {
+                break;
             }
         }
-        // handle external ascii communication
-        else if (type() == ConnectionType::ExternalConnection) {
-            extBuffer += std::string(_recvBuffer.data()).substr(0, iResult);
+    } while (iResult > 0 || _isConnected);
 
-            if (extBuffer.find(24) != std::string::npos ||
-                extBuffer.find(27) != std::string::npos ||
-                extBuffer.find("quit") != std::string::npos)
-            {
-                setConnectedStatus(false);
-                break;
+    _recvBuffer.clear();
+    _uncompressBuffer.clear();
+    _incomingPackages.clear();
+
+    // Close socket; contains mutex
+    closeSocket(_socket);
+
+    if (_updateCallback) {
+        _updateCallback(this);
+    }
+
+    Log::Info("Node {} disconnected", _id);
+}
+
+void Network::handleReadable() {
+    // A readable listening socket means that there is a client waiting to be accepted
+    if (_isServer && !_isConnected) {
+        SGCT_SOCKET s = accept(_listenSocket, nullptr, nullptr);
+        if (s == INVALID_SOCKET) {
+            if (!wouldBlock() && !isInterrupted()) {
+                Log::Error("Accept connection {} failed. Error: {}", _id, SGCT_ERRNO);
             }
+            return;
+        }
 
-            // separate messages by <CR><NL>
-            size_t found = extBuffer.find("\r\n");
-            while (found != std::string::npos) {
-                std::string extMessage = extBuffer.substr(0, found);
-                extBuffer = extBuffer.substr(found + 2); // jump over \r\n
+        _reactor->remove(_listenSocket);
+        setNonBlocking(s);
+        _socket = s;
+        acceptReactorConnection();
+        return;
+    }
 
-                if (decoderCallback) {
-                    const int size = static_cast<int>(extMessage.size());
-                    decoderCallback(extMessage.c_str(), size);
-                }
+    // Read as much as is available without blocking and dispatch every message that has
+    // been completed by the new data. Partial messages are continued on the next call
+    while (!_shouldTerminate) {
+        char* dst = nullptr;
+        uint32_t length = 0;
+        if (_connectionType == ConnectionType::ExternalConnection) {
+            dst = _recvBuffer.data();
+            length = _bufferSize;
+        }
+        else if (_reactorState.headerBytes < HeaderSize) {
+            dst = _reactorState.header.data() + _reactorState.headerBytes;
+            length = static_cast<uint32_t>(HeaderSize) - _reactorState.headerBytes;
+        }
+        else {
+            dst = _recvBuffer.data() + _reactorState.dataBytes;
+            length = _reactorState.dataSize - _reactorState.dataBytes;
+        }
 
-                // reply
-                std::string msg = "OK\r\n";
-                sendData(msg.c_str(), static_cast<int>(msg.size()));
-                found = extBuffer.find("\r\n");
+        const long res = recv(_socket, dst, length, 0);
+        nSyscalls++;
+        if (res < 0 && isInterrupted()) {
+            continue;
+        }
+        if (res < 0 && wouldBlock()) {
+            // Everything that has arrived is handled, so the queued replies can be sent
+            if (_hasQueuedData) {
+                std::unique_lock lock(_sendMutex);
+                flushQueuedData();
             }
+            return;
         }
-        // handle data transfer communication
-        else if (type() == ConnectionType::DataTransfer) {
-            // Disconnect if requested
-            if (isDisconnectPackage(RecvHeader)) {
-                setConnectedStatus(false);
-                Log::Info(fmt::format("File connection {} terminated", _id));
+        if (res <= 0) {
+            if (res == 0) {
+                Log::Info("TCP connection {} closed", _id);
             }
-            //  Handle communication
             else {
-                if (_headerId == DataId && _packageDecoderCallback && dataSize > 0) {
-                    _packageDecoderCallback(_recvBuffer.data(), dataSize, packageId, _id);
-
-                    // send acknowledge
-                    uint32_t pLength = 0;
-                    char sendBuff[HeaderSize];
-                    sendBuff[0] = Ack;
-                    std::memcpy(sendBuff + 1, &packageId, sizeof(packageId));
-                    std::memcpy(sendBuff + 5, &pLength, sizeof(pLength));
-                    sendData(sendBuff, HeaderSize);
-
-                    {
-                        // Clear the buffers
-                        std::unique_lock lk(_connectionMutex);
-
-                        _recvBuffer.clear();
-                        _uncompressBuffer.clear();
-
-                        _bufferSize = 0;
-                        _uncompressedBufferSize = 0;
-                    }
-                }
-                else if (_headerId == ConnectedId && _connectedCallback) {
-                    _connectedCallback();
-                    NetworkManager::cond.notify_all();
-                }
+                Log::Error("TCP connection {} receive failed: {}", _id, SGCT_ERRNO);
             }
+            closeReactorConnection();
+            return;
         }
-    } while (iResult > 0 || _isConnected);
 
-    _recvBuffer.clear();
-    _uncompressBuffer.clear();
+        if (_connectionType == ConnectionType::ExternalConnection) {
+            if (!processExternalMessage(static_cast<int>(res))) {
+                closeReactorConnection();
+                return;
+            }
+            continue;
+        }
 
-    // Close socket; contains mutex
+        if (_reactorState.headerBytes < HeaderSize) {
+            _reactorState.headerBytes += static_cast<uint32_t>(res);
+            if (_reactorState.headerBytes < HeaderSize) {
+                continue;
+            }
+
+            _headerId = DefaultId;
+            _reactorState.packageId = -1;
+            _reactorState.dataSize = 0;
+            _reactorState.uncompressedDataSize = 0;
+            parseHeader(
+                _reactorState.header.data(),
+                _reactorState.packageId,
+                _reactorState.dataSize,
+                _reactorState.uncompressedDataSize
+            );
+            if (_connectionType == ConnectionType::DataTransfer &&
+                _reactorState.packageId < 0)
+            {
+                _reactorState.dataSize = 0;
+            }
+        }
+        else {
+            _reactorState.dataBytes += static_cast<uint32_t>(res);
+        }
+
+        if (_reactorState.dataBytes < _reactorState.dataSize) {
+            continue;
+        }
+
+        // The message is complete
+        const bool keepConnection = processMessage(
+            _reactorState.header.data(),
+            _reactorState.packageId,
+            _reactorState.dataSize,
+            _reactorState.uncompressedDataSize
+        );
+        _reactorState.headerBytes = 0;
+        _reactorState.dataBytes = 0;
+        _reactorState.dataSize = 0;
+        if (!keepConnection) {
+            closeReactorConnection();
+            return;
+        }
+    }
+}
+
+void Network::acceptReactorConnection() {
+    {
+        std::unique_lock lk(_connectionMutex);
+        _recvBuffer.resize(_bufferSize);
+        _uncompressBuffer.resize(_uncompressedBufferSize);
+    }
+    _reactorState.headerBytes = 0;
+    _reactorState.dataBytes = 0;
+    _reactorState.dataSize = 0;
+    _extBuffer.clear();
+
+    setConnectedStatus(true);
+    Log::Info("Connection {} established", _id);
+
+    if (_updateCallback) {
+        _updateCallback(this);
+    }
+
+    _reactor->add(_socket, *this);
+}
+
+void Network::closeReactorConnection() {
+    setConnectedStatus(false);
+
+    // If we are shutting down, the sockets have already been closed by initShutdown. A
+    // client that was told to terminate by the server stops listening and reports it
+    if (_shouldTerminate) {
+        _reactor->remove(_socket);
+        if (_updateCallback) {
+            _updateCallback(this);
+        }
+        return;
+    }
+
+    _reactor->remove(_socket);
     closeSocket(_socket);
+    _socket = INVALID_SOCKET;
+
+    _recvBuffer.clear();
+    _uncompressBuffer.clear();
+    _incomingPackages.clear();
+    {
+        std::unique_lock lock(_sendMutex);
+        _pendingData.clear();
+        _pendingOffset = 0;
+    }
+    _pendingCond.notify_all();
 
     if (_updateCallback) {
         _updateCallback(this);
     }
 
-    Log::Info(fmt::format("Node {} disconnected", _id));
+    Log::Info("Node {} disconnected", _id);
+
+    // Enable the client to reconnect
+    if (_isServer) {
+        _reactor->add(_listenSocket, *this);
+    }
 }
 
 void Network::sendData(const void* data, int length) {
+    sendData(nullptr, 0, data, length);
+}
+
+void Network::sendData(const void* header, int headerLength, const void* data,
+                       int length)
+{
+    ZoneScoped
+
+    // Messages can be sent from the main thread and the receiving thread, for example
+    // when answering a request, and must not interleave
+    TimedLock lock(_sendMutex);
+
+    writeBuffers({
+        Buffer{ _queuedData.data(), _queuedData.size() },
+        Buffer{ static_cast<const char*>(header), static_cast<size_t>(headerLength) },
+        Buffer{ static_cast<const char*>(data), static_cast<size_t>(length) }
+    });
+    _queuedData.clear();
+    _hasQueuedData = false;
+}
+
+void Network::queueData(const void* data, int length) {
+    std::unique_lock lock(_sendMutex);
+
+    const char* p = static_cast<const char*>(data);
+    _queuedData.insert(_queuedData.end(), p, p + length);
+    _hasQueuedData = true;
+
+    // Don't hold back more than fits into a single packet
+    if (_queuedData.size() >= static_cast<size_t>(SocketBufferSize)) {
+        flushQueuedData();
+    }
+}
+
+void Network::flushQueuedData() {
+    writeBuffers({
+        Buffer{ _queuedData.data(), _queuedData.size() },
+        Buffer(),
+        Buffer()
+    });
+    _queuedData.clear();
+    _hasQueuedData = false;
+}
+
+void Network::writeBuffers(std::array<Buffer, 3> buffers) {
     ZoneScoped
 
-    long sendSize = length;
+    // Skip the empty buffers so that the remaining ones can be passed on directly
+    const auto end = std::remove_if(
+        buffers.begin(),
+        buffers.end(),
+        [](const Buffer& b) { return b.size == 0; }
+    );
+    Buffer* first = buffers.data();
+    size_t n = static_cast<size_t>(std::distance(buffers.begin(), end));
+
+    if (_sharedMemory) {
+        // The receiver is only woken up once the whole message is in the ring
+        for (size_t i = 0; i < n; i++) {
+            const uint32_t size = static_cast<uint32_t>(buffers[i].size);
+            if (!_sharedMemory->send(buffers[i].data, size, i == n - 1)) {
+                throw Err(
+                    5040,
+                    fmt::format("Send data failed on shared memory connection {}", _id)
+                );
+            }
+        }
+        return;
+    }
 
-    while (sendSize > 0) {
-        int offset = static_cast<int>(length - sendSize);
-        const long sentLen = send(
+    if (_reactor && !_reactor->isReactorThread()) {
+        // Only the reactor's thread must never wait. Any other thread waits for the
+        // reactor to send the pending data, so a slow receiver still holds back the
+        // sender instead of making the queue grow
+        _pendingCond.wait(_sendMutex, [this]() { return _pendingData.empty(); });
+    }
+    if (_reactor && !_pendingData.empty()) {
+        // The new message has to wait behind the data that the socket has not taken yet
+        queuePendingData(first, n);
+        return;
+    }
+
+    while (n > 0) {
+#ifdef WIN32
+        std::array<WSABUF, 3> wsaBuffers;
+        for (size_t i = 0; i < n; i++) {
+            wsaBuffers[i].buf = const_cast<char*>(first[i].data);
+            wsaBuffers[i].len = static_cast<ULONG>(first[i].size);
+        }
+        DWORD nSent = 0;
+        const int res = WSASend(
             _socket,
-            reinterpret_cast<const char*>(data) + offset,
-            sendSize,
-            0
+            wsaBuffers.data(),
+            static_cast<DWORD>(n),
+            &nSent,
+            0,
+            nullptr,
+            nullptr
         );
+        const long sentLen =
+            res == SOCKET_ERROR ? SOCKET_ERROR : static_cast<long>(nSent);
+#else
+        std::array<iovec, 3> iov;
+        for (size_t i = 0; i < n; i++) {
+            iov[i].iov_base = const_cast<char*>(first[i].data);
+            iov[i].iov_len = first[i].size;
+        }
+        msghdr msg = {};
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = n;
+        const long sentLen = sendmsg(_socket, &msg, SendFlags);
+#endif
+        nSyscalls++;
+
         if (sentLen == SOCKET_ERROR) {
+            if (isInterrupted()) {
+                continue;
+            }
+            if (_reactor && wouldBlock()) {
+                // Sockets of a reactor are non-blocking and the sending thread might be
+                // the reactor's thread, so the rest is sent once the socket is writable
+                queuePendingData(first, n);
+                _reactor->watchWritable(_socket, *this, true);
+                return;
+            }
+            throw Err(5014, fmt::format("Send data failed: {}", SGCT_ERRNO));
+        }
+
+        // Skip the buffers that were sent completely and continue in the partial one
+        size_t remaining = static_cast<size_t>(sentLen);
+        while (n > 0 && remaining >= first->size) {
+            remaining -= first->size;
+            first++;
+            n--;
+        }
+        if (n > 0) {
+            first->data += remaining;
+            first->size -= remaining;
+        }
+    }
+}
+
+void Network::queuePendingData(const Buffer* buffers, size_t n) {
+    size_t size = _pendingData.size() - _pendingOffset;
+    for (size_t i = 0; i < n; i++) {
+        size += buffers[i].size;
+    }
+    if (size > MaxPendingDataSize) {
+        throw Err(
+            5045,
+            fmt::format("Send queue of connection {} exceeds {} bytes", _id, size)
+        );
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        _pendingData.insert(
+            _pendingData.end(),
+            buffers[i].data,
+            buffers[i].data + buffers[i].size
+        );
+    }
+}
+
+void Network::handleWritable() {
+    ZoneScoped
+
+    TimedLock lock(_sendMutex);
+    while (_pendingOffset < _pendingData.size()) {
+        const long res = send(
+            _socket,
+            _pendingData.data() + _pendingOffset,
+            static_cast<int>(_pendingData.size() - _pendingOffset),
+            SendFlags
+        );
+        nSyscalls++;
+        if (res < 0 && isInterrupted()) {
+            continue;
+        }
+        if (res < 0 && wouldBlock()) {
+            return;
+        }
+        if (res < 0) {
             throw Err(5014, fmt::format("Send data failed: {}", SGCT_ERRNO));
         }
-        sendSize -= sentLen;
+        _pendingOffset += static_cast<size_t>(res);
     }
+
+    // Everything is sent, so the buffer can be reused for the next time the socket fills
+    _pendingData.clear();
+    _pendingOffset = 0;
+    _pendingCond.notify_all();
+    _reactor->watchWritable(_socket, *this, false);
 }
 
 void Network::closeNetwork(bool forced) {
@@ -836,7 +1677,7 @@ void Network::closeNetwork(bool forced) {
     _packageDecoderCallback = nullptr;
 
     // release conditions
-    NetworkManager::cond.notify_all();
+    NetworkManager::barrier.notify();
     _startConnectionCond.notify_all();
 
     // blocking sockets -> cannot wait for thread so just kill it brutally
@@ -851,7 +1692,7 @@ void Network::closeNetwork(bool forced) {
     }
     _mainThread = nullptr;
 
-    Log::Info(fmt::format("Connection {} successfully terminated", _id));
+    Log::Info("Connection {} successfully terminated", _id);
 }
 
 void Network::initShutdown() {
@@ -864,7 +1705,7 @@ void Network::initShutdown() {
         sendData(GameOver, HeaderSize);
     }
 
-    Log::Info(fmt::format("Closing connection {}", _id));
+    Log::Info("Closing connection {}", _id);
 
     {
         ZoneScopedN("Decoder callback lock")
@@ -882,6 +1723,9 @@ void Network::initShutdown() {
 
     closeSocket(_socket);
     closeSocket(_listenSocket);
+    if (_sharedMemory) {
+        _sharedMemory->close();
+    }
 }
 
 } // namespace sgct
@@ -15,18 +15,28 @@
 #include <windows.h>
 #endif
 
+#include <sgct/clusterclock.h>
 #include <sgct/clustermanager.h>
+#include <sgct/datatransfercache.h>
+#include <sgct/datatransferdecoder.h>
+#include <sgct/datatransferqueue.h>
 #include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/log.h>
+#include <sgct/multicastchannel.h>
 #include <sgct/mutexes.h>
+#include <sgct/networkreactor.h>
 #include <sgct/node.h>
 #include <sgct/profiling.h>
 #include <sgct/shareddata.h>
+#include <sgct/sharedmemorychannel.h>
 #include <algorithm>
 #include <cstring>
+#include <functional>
+#include <iterator>
 #include <numeric>
+#include <thread>
 
 #ifdef WIN32
     #include <ws2tcpip.h>
@@ -41,9 +51,31 @@
 
 #define Error(code, msg) Error(Error::Component::Network, code, msg)
 
+namespace {
+    // Time a client waits for a multicast message before requesting it from the server
+    constexpr const std::chrono::milliseconds MulticastTimeout(20);
+
+    // Number of multicast messages that are kept for retransmission in addition to the
+    // render-ahead frames, as the request only arrives after the timeout has passed
+    constexpr const int MulticastHistoryMargin = 8;
+
+    // Time in seconds between two requests of a client for the cluster time
+    constexpr const double TimeRequestInterval = 0.25;
+
+    // Frame number, earliest, and latest swap time of a frame
+    constexpr const size_t SwapReportSize = sizeof(int32_t) + 2 * sizeof(double);
+
+    // The acknowledgement contains the swap report followed by the number of node timings
+    constexpr const size_t AcknowledgeHeaderSize = SwapReportSize + sizeof(uint32_t);
+
+    // The node timings are sent as they are stored
+    constexpr const size_t NodeTimingSize = sizeof(sgct::NetworkManager::NodeTiming);
+    static_assert(NodeTimingSize == 2 * sizeof(int32_t) + 5 * sizeof(float));
+} // namespace
+
 namespace sgct {
 
-std::condition_variable NetworkManager::cond;
+SyncBarrier NetworkManager::barrier;
 
 NetworkManager* NetworkManager::_instance = nullptr;
 
@@ -56,7 +88,8 @@ void NetworkManager::create(NetworkMode nm,
                             std::function<void(bool)> externalStatus,
                             std::function<void(void*, int, int, int)> dataTransferDecode,
                             std::function<void(bool, int)> dataTransferStatus,
-                            std::function<void(int, int)> dataTransferAcknowledge)
+                            std::function<void(int, int)> dataTransferAcknowledge,
+                            std::function<void(int, int, float)> dataTransferProgress)
 {
     ZoneScoped
 
@@ -69,7 +102,8 @@ void NetworkManager::create(NetworkMode nm,
         std::move(externalStatus),
         std::move(dataTransferDecode),
         std::move(dataTransferStatus),
-        std::move(dataTransferAcknowledge)
+        std::move(dataTransferAcknowledge),
+        std::move(dataTransferProgress)
     );
 }
 
@@ -83,12 +117,14 @@ NetworkManager::NetworkManager(NetworkMode nm,
                                std::function<void(bool)> externalStatus,
                              std::function<void(void*, int, int, int)> dataTransferDecode,
                                         std::function<void(bool, int)> dataTransferStatus,
-                                    std::function<void(int, int)> dataTransferAcknowledge)
+                                    std::function<void(int, int)> dataTransferAcknowledge,
+                              std::function<void(int, int, float)> dataTransferProgress)
     : _externalDecodeFn(std::move(externalDecode))
     , _externalStatusFn(std::move(externalStatus))
     , _dataTransferDecodeFn(std::move(dataTransferDecode))
     , _dataTransferStatusFn(std::move(dataTransferStatus))
     , _dataTransferAcknowledgeFn(std::move(dataTransferAcknowledge))
+    , _dataTransferProgressFn(std::move(dataTransferProgress))
     , _mode(nm)
 {
     ZoneScoped
@@ -195,7 +231,13 @@ NetworkManager::~NetworkManager() {
     ZoneScoped
 
     _isRunning = false;
-    cond.notify_all();
+    barrier.notify();
+
+    // A receiving thread might wait for the render thread to take a staged frame
+    SharedData::instance().setAsyncDecode(false);
+
+    // The queue has to stop sending before the connections are shut down
+    _dataTransferQueue = nullptr;
 
     // signal to terminate
     for (std::unique_ptr<Network>& connection : _networkConnections) {
@@ -211,10 +253,17 @@ NetworkManager::~NetworkManager() {
         std::this_thread::sleep_for(std::chrono::milliseconds(250));
     }
 
+    // The reactor has to be stopped before the connections it is dispatching to go away
+    _reactor = nullptr;
+    _multicastChannel = nullptr;
+
     _networkConnections.clear();
     _syncConnections.clear();
     _dataTransferConnections.clear();
 
+    // Shared memory connections decode on their own threads, which are stopped by now
+    _dataTransferDecoder = nullptr;
+
 #ifdef WIN32
     WSACleanup();
 #endif
@@ -263,9 +312,72 @@ void NetworkManager::initialize() {
         _localAddresses.push_back(cm.thisNode().address());
     }
 
+    SharedData::instance().setCompression(
+        cm.useSyncCompression(),
+        cm.compressionThreshold()
+    );
+    SharedData::instance().setDeltaEncoding(cm.useDeltaEncoding(), cm.keyframeInterval());
+    SharedData::instance().setAsyncDecode(cm.useAsyncDecode());
+    _renderAhead = cm.renderAhead();
+    if (_renderAhead > 0) {
+        // A client has at most one frame more than the render-ahead frames queued, and
+        // the frame that is being decoded keeps its slot until it is done
+        _frameQueue.resize(_renderAhead + 2);
+    }
+    _nodeTimings.resize(cm.numberOfNodes());
+
+    if (cm.useNetworkReactor()) {
+        if (NetworkReactor::isSupported()) {
+            _reactor = std::make_unique<NetworkReactor>();
+        }
+        else {
+            Log::Warning(
+                "Network reactor is not supported on this operating system. Falling "
+                "back to one thread per connection"
+            );
+        }
+    }
+
+    // Clients behind a relay receive the sync data from their relay instead
+    const int parent = cm.thisNode().parent();
+    const bool isServedByMaster =
+        parent == -1 || cm.node(parent).address() == cm.masterAddress();
+    if (!cm.multicastAddress().empty() && cm.numberOfNodes() > 1 &&
+        (_isServer || isServedByMaster))
+    {
+        _multicastChannel = std::make_unique<MulticastChannel>(
+            cm.multicastAddress(),
+            cm.multicastPort(),
+            cm.multicastInterface(),
+            _isServer
+        );
+        if (_isServer) {
+            _multicastHistory.resize(_renderAhead + MulticastHistoryMargin);
+        }
+    }
+
     // Add Cluster Functionality
     if (ClusterManager::instance().numberOfNodes() > 1) {
         ZoneScopedN("Create cluster connections")
+
+        if (!cm.dataTransferCache().empty()) {
+            _dataTransferCache = std::make_unique<DataTransferCache>(
+                cm.dataTransferCache()
+            );
+        }
+        _dataTransferQueue = std::make_unique<DataTransferQueue>(
+            _dataTransferAcknowledgeFn,
+            _dataTransferProgressFn,
+            cm.useDataTransferCompression(),
+            cm.compressionThreshold(),
+            _dataTransferCache != nullptr
+        );
+        if (_reactor && _dataTransferDecodeFn) {
+            // The reactor's thread must not wait for the application to decode packages
+            _dataTransferDecoder = std::make_unique<DataTransferDecoder>(
+                _dataTransferDecodeFn
+            );
+        }
         // sanity check if port is used somewhere else
         for (size_t i = 0; i < _networkConnections.size(); i++) {
             const int port = _networkConnections[i]->port();
@@ -285,14 +397,59 @@ void NetworkManager::initialize() {
 
         // if client
         if (!_isServer) {
-            addConnection(cm.thisNode().syncPort(), remoteAddress);
+            // If this node is a relay, the connections to its children have to exist
+            // before the parent can start sending sync data that has to be forwarded
+            for (int i = 0; i < cm.numberOfNodes(); i++) {
+                const Node& n = cm.node(i);
+                if (n.parent() == cm.thisNodeId()) {
+                    addConnection(
+                        n.syncPort(),
+                        n.address(),
+                        Network::ConnectionType::SyncConnection,
+                        true
+                    );
+                    setupSwapReportConnection(*_networkConnections.back());
+                    _isRelay = true;
+                }
+            }
+
+            // The sync data is received from the parent node if there is one
+            const int parent = cm.thisNode().parent();
+            const std::string parentAddress =
+                (parent != -1 && _mode == NetworkMode::Remote) ?
+                cm.node(parent).address() :
+                remoteAddress;
+
+            addConnection(cm.thisNode().syncPort(), parentAddress);
             _networkConnections.back()->setDecodeFunction(
-                // @TODO (abock, 2019-12-06) This can be replaced with std::bind_front
-                // when switching to C++20
-                [](const char* data, int length) {
-                    SharedData::instance().decode(data, length);
+                [this](const char* data, int length) {
+                    if (_renderAhead > 0) {
+                        queueFrame(data, length);
+                    }
+                    else {
+                        SharedData::instance().decode(data, length);
+                    }
                 }
             );
+            if (_multicastChannel) {
+                _networkConnections.back()->setMulticastFunction(
+                    [this](uint32_t session, uint32_t sequence, std::vector<char>& data) {
+                        return _multicastChannel->receive(
+                            session,
+                            sequence,
+                            data,
+                            MulticastTimeout
+                        );
+                    }
+                );
+            }
+            if (_isRelay) {
+                _networkConnections.back()->setForwardFunction(
+                    [this](const char* header, const char* data, uint32_t dataSize) {
+                        forwardSyncMessage(header, data, dataSize);
+                    }
+                );
+            }
 
             // add data transfer connection
             if (cm.thisNode().dataTransferPort() > 0 && !remoteAddress.empty()) {
@@ -301,18 +458,7 @@ void NetworkManager::initialize() {
                     remoteAddress,
                     Network::ConnectionType::DataTransfer
                 );
-                if (_dataTransferDecodeFn) {
-                    _networkConnections.back()->setPackageDecodeFunction(
-                        _dataTransferDecodeFn
-                    );
-                }
-
-                // acknowledge callback
-                if (_dataTransferAcknowledgeFn) {
-                    _networkConnections.back()->setAcknowledgeFunction(
-                        _dataTransferAcknowledgeFn
-                    );
-                }
+                setupDataTransferConnection(*_networkConnections.back());
             }
         }
 
@@ -320,37 +466,31 @@ void NetworkManager::initialize() {
         for (int i = 0; i < cm.numberOfNodes(); i++) {
             const Node& n = cm.node(i);
 
+            // The master only connects to the nodes that are not served by a relay
+            const bool isDirectChild =
+                n.parent() == -1 || n.parent() == cm.thisNodeId();
+
             // don't add itself if server
-            if (_isServer && !matchesAddress(n.address())) {
-                addConnection(n.syncPort(), remoteAddress);
-
-                _networkConnections.back()->setDecodeFunction(
-                    [](const char* data, int length) {
-                        std::vector<char> d(data, data + length);
-                        d.push_back('\0');
-                        Log::Info(fmt::format("[client]: {} [end]", d.data()));
-                    }
-                );
+            if (_isServer && isDirectChild && !matchesAddress(n.address())) {
+                addConnection(n.syncPort(), n.address());
+                setupSwapReportConnection(*_networkConnections.back());
+                if (_multicastChannel) {
+                    Network* connection = _networkConnections.back().get();
+                    connection->setNackFunction(
+                        [this, connection](int32_t frame, uint32_t sequence) {
+                            retransmitMulticastMessage(*connection, frame, sequence);
+                        }
+                    );
+                }
 
                 // add data transfer connection
                 if (n.dataTransferPort() != 0 && !remoteAddress.empty()) {
                     addConnection(
                         n.dataTransferPort(),
-                        remoteAddress,
+                        n.address(),
                         Network::ConnectionType::DataTransfer
                     );
-                    if (_dataTransferDecodeFn) {
-                        _networkConnections.back()->setPackageDecodeFunction(
-                            _dataTransferDecodeFn
-                        );
-                    }
-
-                    // acknowledge callback
-                    if (_dataTransferAcknowledgeFn) {
-                        _networkConnections.back()->setAcknowledgeFunction(
-                            _dataTransferAcknowledgeFn
-                        );
-                    }
+                    setupDataTransferConnection(*_networkConnections.back());
                 }
             }
         }
@@ -370,17 +510,19 @@ void NetworkManager::initialize() {
         }
     }
 
-    Log::Debug(
-        fmt::format("Cluster sync: {}", cm.firmFrameLockSyncStatus() ? "firm" : "loose")
-    );
+    Log::Debug("Cluster sync: {}", cm.firmFrameLockSyncStatus() ? "firm" : "loose");
 }
 
 void NetworkManager::clearCallbacks() {
     _externalDecodeFn = nullptr;
     _externalStatusFn = nullptr;
     _dataTransferDecodeFn = nullptr;
+    if (_dataTransferDecoder) {
+        _dataTransferDecoder->clear();
+    }
     _dataTransferStatusFn = nullptr;
     _dataTransferAcknowledgeFn = nullptr;
+    _dataTransferProgressFn = nullptr;
 }
 
 std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
@@ -388,9 +530,18 @@ std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
         return std::nullopt;
     }
     if (sm == SyncMode::SendDataToClients) {
+        // Relays pass on the data as soon as it arrives from their parent instead
+        if (!_isServer) {
+            return std::nullopt;
+        }
+
         double maxTime = -std::numeric_limits<double>::max();
         double minTime = std::numeric_limits<double>::max();
 
+        // With multicast, the data is sent once for all clients and the sync connections
+        // only tell the clients which multicast message belongs to the frame
+        const uint32_t sequence = _multicastChannel ? sendMulticastMessage() : 0;
+
         bool hasFoundConnection = false;
         for (Network* connection : _syncConnections) {
             if (!connection->isServer() || !connection->isConnected()) {
@@ -409,6 +560,18 @@ std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
             // iterate counter
             const int currentFrame = connection->iterateFrameCounter();
 
+            if (_multicastChannel) {
+                // The message has no payload, so the size is replaced by the session
+                const uint32_t session = _multicastChannel->session();
+                char data[Network::HeaderSize];
+                data[0] = Network::MulticastDataId;
+                std::memcpy(data + 1, &currentFrame, sizeof(currentFrame));
+                std::memcpy(data + 5, &session, sizeof(session));
+                std::memcpy(data + 9, &sequence, sizeof(sequence));
+                connection->sendData(data, Network::HeaderSize);
+                continue;
+            }
+
             unsigned char* dataBlock = SharedData::instance().dataBlock();
             std::memcpy(dataBlock + 1, &currentFrame, sizeof(currentFrame));
             std::memcpy(dataBlock + 5, &currentSize, sizeof(currentSize));
@@ -424,86 +587,436 @@ std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
         }
     }
     else if (sm == SyncMode::Acknowledge) {
+        // The acknowledgement carries the swap times of the last frame that this node
+        // and, for a relay, its children swapped, followed by their latest timings. An
+        // invalid frame number marks a missing swap report
+        _acknowledgeData.resize(AcknowledgeHeaderSize);
+        {
+            TimedLock lock(_swapReportMutex);
+            const SwapTime& last = _swapTimes[(_nSwapTimes + _swapTimes.size() - 1) %
+                                              _swapTimes.size()];
+            std::optional<std::pair<double, double>> range;
+            if (_nSwapTimes > 0) {
+                range = swapRange(last.frame);
+            }
+            const int32_t frame = range ? last.frame : -1;
+            const std::pair<double, double> r = range.value_or(std::pair(0.0, 0.0));
+            char* report = _acknowledgeData.data();
+            std::memcpy(report, &frame, sizeof(int32_t));
+            std::memcpy(report + 4, &r.first, sizeof(double));
+            std::memcpy(report + 12, &r.second, sizeof(double));
+
+            uint32_t nTimings = 0;
+            for (NodeTiming& timing : _nodeTimings) {
+                if (timing.node == -1) {
+                    continue;
+                }
+                const char* t = reinterpret_cast<const char*>(&timing);
+                _acknowledgeData.insert(_acknowledgeData.end(), t, t + NodeTimingSize);
+                timing.node = -1;
+                nTimings++;
+            }
+            std::memcpy(
+                _acknowledgeData.data() + SwapReportSize,
+                &nTimings,
+                sizeof(uint32_t)
+            );
+        }
+
+        // The time request is queued first so that it is sent along with the ack
+        const double now = ClusterClock::instance().localTime();
+        if (_parentConnection && _parentConnection->isConnected() &&
+            now - _lastTimeRequest > TimeRequestInterval)
+        {
+            _parentConnection->sendTimeRequest();
+            _lastTimeRequest = now;
+        }
+
         for (Network* connection : _syncConnections) {
             if (!connection->isServer() && connection->isConnected()) {
                 // The servers's render function is locked until a message starting with
                 // the ack-byte is received.
-                connection->pushClientMessage();
+                connection->pushClientMessage(
+                    _acknowledgeData.data(),
+                    static_cast<uint32_t>(_acknowledgeData.size())
+                );
             }
         }
     }
     return std::nullopt;
 }
 
+void NetworkManager::setSwapTime(double time) {
+    // The frames are counted by the acknowledgements that a client sent to its parent or
+    // by the frames that the master sent, which is the same number on all nodes
+    int32_t frame = -1;
+    if (_parentConnection) {
+        frame = _parentConnection->sendFrameCurrent();
+    }
+    else if (!_syncConnections.empty()) {
+        frame = _syncConnections.front()->sendFrameCurrent();
+    }
+
+    TimedLock lock(_swapReportMutex);
+    _swapTimes[_nSwapTimes % _swapTimes.size()] = { frame, time };
+    _nSwapTimes++;
+}
+
+std::optional<double> NetworkManager::swapSkew() {
+    TimedLock lock(_swapReportMutex);
+
+    // When rendering ahead, the clients might report different frames, in which case the
+    // largest skew of these frames is used
+    std::optional<double> skew;
+    for (SwapReport& report : _swapReports) {
+        if (!report.isValid) {
+            continue;
+        }
+        const std::optional<std::pair<double, double>> range = swapRange(report.frame);
+        report.isValid = false;
+        if (range) {
+            skew = std::max(skew.value_or(0.0), range->second - range->first);
+        }
+    }
+    return skew;
+}
+
+void NetworkManager::setNodeTiming(NodeTiming timing) {
+    ClusterManager& cm = ClusterManager::instance();
+    timing.node = cm.thisNodeId();
+
+    TimedLock lock(_swapReportMutex);
+    if (_nSwapTimes > 0) {
+        timing.frame =
+            _swapTimes[(_nSwapTimes + _swapTimes.size() - 1) % _swapTimes.size()].frame;
+    }
+    if (timing.node >= 0 && timing.node < static_cast<int32_t>(_nodeTimings.size())) {
+        _nodeTimings[timing.node] = timing;
+    }
+}
+
+void NetworkManager::nodeTimings(std::vector<NodeTiming>& timings) {
+    timings.clear();
+
+    TimedLock lock(_swapReportMutex);
+    for (NodeTiming& timing : _nodeTimings) {
+        if (timing.node != -1) {
+            timings.push_back(timing);
+            timing.node = -1;
+        }
+    }
+}
+
+std::optional<std::pair<double, double>> NetworkManager::swapRange(int32_t frame) {
+    const auto it = std::find_if(
+        _swapTimes.cbegin(),
+        _swapTimes.cbegin() + std::min(_nSwapTimes, _swapTimes.size()),
+        [frame](const SwapTime& t) { return t.frame == frame; }
+    );
+    if (it == _swapTimes.cbegin() + std::min(_nSwapTimes, _swapTimes.size())) {
+        return std::nullopt;
+    }
+
+    std::pair<double, double> range = { it->time, it->time };
+    for (SwapReport& report : _swapReports) {
+        if (report.isValid && report.frame == frame) {
+            range.first = std::min(range.first, report.earliest);
+            range.second = std::max(range.second, report.latest);
+            report.isValid = false;
+        }
+    }
+    return range;
+}
+
 bool NetworkManager::isSyncComplete() const {
+    // A relay must not acknowledge a frame before it was passed on to its children
+    if (_isRelay && _parentConnection->recvFrameCurrent() != _forwardedFrame) {
+        return false;
+    }
+
     const unsigned int counter = static_cast<unsigned int>(std::count_if(
         _syncConnections.cbegin(),
         _syncConnections.cend(),
-        [](Network* n) { return n->isUpdated(); }
+        [this](Network* n) {
+            // When rendering ahead, a client can continue as long as it has a frame
+            if (_renderAhead > 0 && n == _parentConnection) {
+                return n->isConnected() && _frameQueueHead != _frameQueueTail;
+            }
+            // The frame number is updated before the data is decoded asynchronously
+            if (n == _parentConnection) {
+                return n->isUpdated() && SharedData::instance().isStagedFrameReady();
+            }
+            return n->isUpdated();
+        }
     ));
     return (counter == _nActiveSyncConnections);
 }
 
+std::optional<double> NetworkManager::decodeQueuedFrame() {
+    ZoneScoped
+
+    const uint32_t tail = _frameQueueTail.load(std::memory_order_relaxed);
+    if (_frameQueueHead.load(std::memory_order_acquire) == tail) {
+        return std::nullopt;
+    }
+
+    // The slot is not reused by the network thread before the tail has moved past it
+    const QueuedFrame& frame = _frameQueue[tail % _frameQueue.size()];
+    SharedData::instance().decode(frame.data.data(), static_cast<int>(frame.data.size()));
+    const double latency = ClusterClock::instance().localTime() - frame.arrivalTime;
+
+    _frameQueueTail.store(tail + 1, std::memory_order_release);
+    return latency;
+}
+
+void NetworkManager::queueFrame(const char* data, int length) {
+    ZoneScoped
+
+    const uint32_t head = _frameQueueHead.load(std::memory_order_relaxed);
+
+    // The master does not send more frames than fit into the queue, so this only waits
+    // for the render thread to finish decoding the oldest frame in rare cases
+    while (head - _frameQueueTail.load(std::memory_order_acquire) == _frameQueue.size()) {
+        if (!_isRunning) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    QueuedFrame& frame = _frameQueue[head % _frameQueue.size()];
+    frame.data.assign(data, data + length);
+    frame.arrivalTime = ClusterClock::instance().localTime();
+    _frameQueueHead.store(head + 1, std::memory_order_release);
+}
+
+int NetworkManager::framesInFlight() const {
+    int res = 0;
+    for (Network* connection : _syncConnections) {
+        if (connection->isServer() && connection->isConnected()) {
+            res = std::max(res, connection->framesInFlight());
+        }
+    }
+    return res;
+}
+
+void NetworkManager::forwardSyncMessage(const char* header, const char* data,
+                                        uint32_t dataSize)
+{
+    ZoneScoped
+
+    std::array<char, Network::HeaderSize> childHeader;
+    std::memcpy(childHeader.data(), header, Network::HeaderSize);
+
+    for (Network* connection : _syncConnections) {
+        if (!connection->isServer() || !connection->isConnected()) {
+            continue;
+        }
+
+        // Each connection keeps its own frame counter, so only the header differs and
+        // the data is sent directly from the receive buffer
+        const int currentFrame = connection->iterateFrameCounter();
+        std::memcpy(childHeader.data() + 1, &currentFrame, sizeof(currentFrame));
+        connection->sendData(
+            childHeader.data(),
+            static_cast<int>(childHeader.size()),
+            data,
+            static_cast<int>(dataSize)
+        );
+    }
+
+    int32_t parentFrame = 0;
+    std::memcpy(&parentFrame, header + 1, sizeof(parentFrame));
+    _forwardedFrame = parentFrame;
+    barrier.notify();
+}
+
+uint32_t NetworkManager::sendMulticastMessage() {
+    ZoneScoped
+
+    SharedData& sd = SharedData::instance();
+    const int currentSize = sd.dataSize() - static_cast<int>(Network::HeaderSize);
+    unsigned char* dataBlock = sd.dataBlock();
+    std::memcpy(dataBlock + 5, &currentSize, sizeof(currentSize));
+
+    _multicastSequence++;
+    _multicastChannel->send(_multicastSequence, dataBlock, sd.dataSize());
+
+    std::unique_lock lock(_multicastMutex);
+    const size_t index = _multicastSequence % _multicastHistory.size();
+    MulticastMessage& msg = _multicastHistory[index];
+    msg.sequence = _multicastSequence;
+    msg.data.assign(dataBlock, dataBlock + sd.dataSize());
+    return _multicastSequence;
+}
+
+void NetworkManager::retransmitMulticastMessage(Network& connection, int32_t frame,
+                                                uint32_t sequence)
+{
+    ZoneScoped
+
+    std::vector<char> data;
+    {
+        std::unique_lock lock(_multicastMutex);
+        const MulticastMessage& msg =
+            _multicastHistory[sequence % _multicastHistory.size()];
+        if (msg.sequence == sequence) {
+            data = msg.data;
+        }
+        else {
+            // The client would wait for this frame forever, so it gets the newest message
+            // instead. With delta encoding, that message is based on a frame the client
+            // does not have, so the client skips it and catches up with the next keyframe
+            Log::Warning(
+                "Multicast message {} requested by connection {} is no longer available",
+                sequence, connection.id()
+            );
+            SharedData::instance().requestKeyframe();
+            const auto newest = std::max_element(
+                _multicastHistory.cbegin(),
+                _multicastHistory.cend(),
+                [](const MulticastMessage& lhs, const MulticastMessage& rhs) {
+                    return lhs.sequence < rhs.sequence;
+                }
+            );
+            data = newest->data;
+        }
+    }
+    if (data.empty()) {
+        return;
+    }
+
+    std::memcpy(data.data() + 1, &frame, sizeof(frame));
+    connection.sendData(data.data(), static_cast<int>(data.size()));
+}
+
 Network* NetworkManager::externalControlConnection() {
     return _externalControlConnection;
 }
 
 void NetworkManager::transferData(const void* data, int length, int packageId) {
-    std::vector<char> buffer;
-    prepareTransferData(data, buffer, length, packageId);
-    for (Network* connection : _dataTransferConnections) {
-        if (connection->isConnected()) {
-            connection->sendData(buffer.data(), length);
-        }
-    }
+    const char* p = reinterpret_cast<const char*>(data);
+    transferData(std::vector<char>(p, p + length), packageId);
 }
 
 void NetworkManager::transferData(const void* data, int length, int packageId,
                                   Network& connection)
 {
-    if (connection.isConnected()) {
-        std::vector<char> buffer;
-        prepareTransferData(data, buffer, length, packageId);
-        connection.sendData(buffer.data(), length);
+    if (_dataTransferQueue && connection.isConnected()) {
+        const char* p = reinterpret_cast<const char*>(data);
+        _dataTransferQueue->push(
+            std::vector<char>(p, p + length),
+            packageId,
+            { &connection }
+        );
     }
 }
 
-void NetworkManager::prepareTransferData(const void* data, std::vector<char>& buffer,
-                                         int& length, int packageId)
-{
-    int messageLength = length;
-
-    length += static_cast<int>(Network::HeaderSize);
-    buffer.resize(length);
+void NetworkManager::transferData(std::vector<char> data, int packageId) {
+    if (!_dataTransferQueue) {
+        return;
+    }
 
-    buffer[0] = Network::DataId;
-    std::memcpy(buffer.data() + 1, &packageId, sizeof(packageId));
+    std::vector<Network*> connections;
+    std::copy_if(
+        _dataTransferConnections.cbegin(),
+        _dataTransferConnections.cend(),
+        std::back_inserter(connections),
+        std::mem_fn(&Network::isConnected)
+    );
+    _dataTransferQueue->push(std::move(data), packageId, std::move(connections));
+}
 
-    // set uncompressed size to DefaultId since compression is not used
-    std::memset(buffer.data() + 9, Network::DefaultId, sizeof(int));
+void NetworkManager::setupDataTransferConnection(Network& connection) {
+    if (_dataTransferDecoder) {
+        // The package is only valid during the call, so the decoder gets its own copy
+        connection.setPackageDecodeFunction(
+            [this](void* data, int size, int packageId, int connectionId) {
+                const char* p = reinterpret_cast<const char*>(data);
+                _dataTransferDecoder->push(
+                    std::vector<char>(p, p + size),
+                    packageId,
+                    connectionId
+                );
+            }
+        );
+    }
+    else if (_dataTransferDecodeFn) {
+        connection.setPackageDecodeFunction(_dataTransferDecodeFn);
+    }
 
-    // add data to buffer
-    std::memcpy(
-        buffer.data() + Network::HeaderSize,
-        data,
-        length - Network::HeaderSize
+    // Every chunk is acknowledged, the queue reports when a package is complete
+    connection.setAcknowledgeFunction(
+        [this, &connection](int packageId, int) {
+            _dataTransferQueue->acknowledge(packageId, connection);
+        }
+    );
+    connection.setOfferReplyFunction(
+        [this, &connection](int packageId, bool isCached) {
+            _dataTransferQueue->offerReply(packageId, connection, isCached);
+        }
     );
+    connection.setDataTransferCache(_dataTransferCache.get());
+}
 
-    std::memcpy(buffer.data() + 5, &messageLength, sizeof(messageLength));
+void NetworkManager::setupSwapReportConnection(Network& connection) {
+    size_t index = 0;
+    {
+        std::unique_lock lock(_swapReportMutex);
+        index = _swapReports.size();
+        _swapReports.emplace_back();
+    }
+
+    connection.setDecodeFunction(
+        [this, index](const char* data, int length) {
+            uint32_t nTimings = 0;
+            if (length >= static_cast<int>(AcknowledgeHeaderSize)) {
+                std::memcpy(&nTimings, data + SwapReportSize, sizeof(uint32_t));
+            }
+            if (length < static_cast<int>(AcknowledgeHeaderSize) ||
+                static_cast<size_t>(length) !=
+                    AcknowledgeHeaderSize + nTimings * NodeTimingSize)
+            {
+                Log::Warning("Received malformed swap report {}", index);
+                return;
+            }
+            SwapReport report;
+            std::memcpy(&report.frame, data, sizeof(int32_t));
+            std::memcpy(&report.earliest, data + 4, sizeof(double));
+            std::memcpy(&report.latest, data + 12, sizeof(double));
+            report.isValid = report.frame != -1;
+
+            std::unique_lock lock(_swapReportMutex);
+            if (report.isValid) {
+                _swapReports[index] = report;
+            }
+            for (uint32_t i = 0; i < nTimings; ++i) {
+                NodeTiming timing;
+                std::memcpy(
+                    &timing,
+                    data + AcknowledgeHeaderSize + i * NodeTimingSize,
+                    NodeTimingSize
+                );
+                if (timing.node >= 0 &&
+                    timing.node < static_cast<int32_t>(_nodeTimings.size()))
+                {
+                    _nodeTimings[timing.node] = timing;
+                }
+            }
+        }
+    );
 }
 
 unsigned int NetworkManager::activeConnectionsCount() const {
-    std::unique_lock lock(mutex::DataSync);
     return _nActiveConnections;
 }
 
 int NetworkManager::connectionsCount() const {
-    std::unique_lock lock(mutex::DataSync);
+    std::unique_lock lock(_connectionsMutex);
     return static_cast<int>(_networkConnections.size());
 }
 
 int NetworkManager::syncConnectionsCount() const {
-    std::unique_lock lock(mutex::DataSync);
+    std::unique_lock lock(_connectionsMutex);
     return static_cast<int>(_syncConnections.size());
 }
 
@@ -516,60 +1029,71 @@ const Network& NetworkManager::syncConnection(int index) const {
 }
 
 void NetworkManager::updateConnectionStatus(Network* connection) {
-    Log::Debug(fmt::format("Updating status for connection {}", connection->id()));
+    Log::Debug("Updating status for connection {}", connection->id());
 
     int nConnections = 0;
     int nConnectedSync = 0;
     int nConnectedDataTransfer = 0;
 
-    mutex::DataSync.lock();
-    int totalNConnections = static_cast<int>(_networkConnections.size());
-    int totalNSyncConnections = static_cast<int>(_syncConnections.size());
-    int totalNTransferConnections = static_cast<int>(_dataTransferConnections.size());
-    mutex::DataSync.unlock();
-
-    // count connections
-    for (const std::unique_ptr<Network>& conn : _networkConnections) {
-        if (conn->isConnected()) {
-            nConnections++;
-            if (conn->type() == Network::ConnectionType::SyncConnection) {
-                nConnectedSync++;
-            }
-            else if (conn->type() == Network::ConnectionType::DataTransfer) {
-                nConnectedDataTransfer++;
+    int totalNConnections = 0;
+    int totalNSyncConnections = 0;
+    int totalNTransferConnections = 0;
+    {
+        std::unique_lock lock(_connectionsMutex);
+        totalNConnections = static_cast<int>(_networkConnections.size());
+        totalNSyncConnections = static_cast<int>(_syncConnections.size());
+        totalNTransferConnections = static_cast<int>(_dataTransferConnections.size());
+
+        // count connections
+        for (const std::unique_ptr<Network>& conn : _networkConnections) {
+            if (conn->isConnected()) {
+                nConnections++;
+                if (conn->type() == Network::ConnectionType::SyncConnection) {
+                    nConnectedSync++;
+                }
+                else if (conn->type() == Network::ConnectionType::DataTransfer) {
+                    nConnectedDataTransfer++;
+                }
             }
         }
     }
 
-    Log::Info(fmt::format(
-        "Number of active connections {} of {}", nConnections, totalNConnections
-    ));
-    Log::Debug(fmt::format(
+    Log::Info("Number of active connections {} of {}", nConnections, totalNConnections);
+    Log::Debug(
         "Number of connected sync nodes {} of {}", nConnectedSync, totalNSyncConnections
-    ));
-    Log::Debug(fmt::format(
+    );
+    Log::Debug(
         "Number of connected data transfer nodes {} of {}",
         nConnectedDataTransfer, totalNTransferConnections
-    ));
+    );
 
-    mutex::DataSync.lock();
     _nActiveConnections = nConnections;
     _nActiveSyncConnections = nConnectedSync;
     _nActiveDataTransferConnections = nConnectedDataTransfer;
 
     // if client disconnects then it cannot run anymore
-    if (_nActiveSyncConnections == 0 && !_isServer) {
+    if (!_isServer && connection == _parentConnection && !connection->isConnected()) {
         _isRunning = false;
+        // A thread that waits for the next frame would otherwise only notice on timeout
+        barrier.notify();
+    }
+
+    if (_isRelay) {
+        updateClientConnectedStatus();
     }
-    mutex::DataSync.unlock();
 
     if (_isServer) {
-        mutex::DataSync.lock();
-        // local copy (thread safe)
-        bool allNodesConnected = (nConnectedSync == totalNSyncConnections) &&
-                                (nConnectedDataTransfer == totalNTransferConnections);
+        const bool allNodesConnected =
+            (nConnectedSync == totalNSyncConnections) &&
+            (nConnectedDataTransfer == totalNTransferConnections);
         _allNodesConnected = allNodesConnected;
-        mutex::DataSync.unlock();
+
+        // A new client has not received the frame that the next delta would be based on
+        if (connection->type() == Network::ConnectionType::SyncConnection &&
+            connection->isConnected())
+        {
+            SharedData::instance().requestKeyframe();
+        }
 
         // send cluster connected message to clients
         if (allNodesConnected) {
@@ -604,8 +1128,11 @@ void NetworkManager::updateConnectionStatus(Network* connection) {
                 _externalStatusFn(status);
             }
         }
+    }
 
-        // wake up the connection handler thread on server
+    // wake up the connection handler thread on server, which includes the connections
+    // that a relay uses to serve its children
+    if (connection->isServer()) {
         connection->startConnectionConditionVar().notify_all();
     }
 
@@ -616,21 +1143,54 @@ void NetworkManager::updateConnectionStatus(Network* connection) {
     }
 
     // signal done to caller
-    cond.notify_all();
+    barrier.notify();
 }
 
 void NetworkManager::setAllNodesConnected() {
-    std::unique_lock lock(mutex::DataSync);
-
     if (!_isServer) {
+        _isParentConnected = true;
+        updateClientConnectedStatus();
+    }
+}
+
+void NetworkManager::updateClientConnectedStatus() {
+    bool hasChanged = false;
+    {
+        // The lock makes the check and the update of the connected state atomic
+        std::unique_lock lock(_connectionsMutex);
+        const unsigned int nSync = static_cast<unsigned int>(_syncConnections.size());
         unsigned int nConn = static_cast<unsigned int>(_dataTransferConnections.size());
-        _allNodesConnected = (_nActiveSyncConnections == 1) &&
-                             (_nActiveDataTransferConnections == nConn);
+        const bool allNodesConnected = _isParentConnected &&
+                                       (_nActiveSyncConnections == nSync) &&
+                                       (_nActiveDataTransferConnections == nConn);
+        hasChanged = allNodesConnected && !_allNodesConnected;
+        _allNodesConnected = allNodesConnected;
+    }
+
+    if (!hasChanged || !_isRelay) {
+        return;
+    }
+
+    // The children of a relay only learn about the connected cluster through the relay
+    for (Network* syncConnection : _syncConnections) {
+        if (!syncConnection->isServer() || !syncConnection->isConnected()) {
+            continue;
+        }
+        char data[Network::HeaderSize];
+        std::fill(std::begin(data), std::end(data), Network::DefaultId);
+        data[0] = Network::ConnectedId;
+        syncConnection->sendData(&data, Network::HeaderSize);
     }
 }
 
 void NetworkManager::addConnection(int port, std::string address,
                                    Network::ConnectionType connectionType)
+{
+    addConnection(port, std::move(address), connectionType, _isServer);
+}
+
+void NetworkManager::addConnection(int port, std::string address,
+                                   Network::ConnectionType connectionType, bool isServer)
 {
     ZoneScoped
 
@@ -642,31 +1202,43 @@ void NetworkManager::addConnection(int port, std::string address,
         throw Error(5026, fmt::format("Empty address for connection to {}", port));
     }
 
+    // The address is the one of the server for client connections and the one of the
+    // client for server connections. In both cases, both nodes are on this computer if
+    // the address is one of ours, which is always the case when running locally
+    const bool useSharedMemory =
+        connectionType != Network::ConnectionType::ExternalConnection &&
+        ClusterManager::instance().useSharedMemory() &&
+        SharedMemoryChannel::isSupported() &&
+        (_mode != NetworkMode::Remote || matchesAddress(address));
+
     auto net = std::make_unique<Network>(
         port,
         std::move(address),
-        _isServer,
-        connectionType
+        isServer,
+        connectionType,
+        useSharedMemory
     );
-    Log::Debug(fmt::format(
-        "Initiating connection {} at port {}", _networkConnections.size(), port
-    ));
+    Log::Debug("Initiating connection {} at port {}", _networkConnections.size(), port);
     net->setUpdateFunction([this](Network* c) { updateConnectionStatus(c); });
     net->setConnectedFunction([this]() { setAllNodesConnected(); });
+    Network* newConnection = net.get();
 
-    // must be initialized after binding
-    net->initialize();
+    std::unique_lock lock(_connectionsMutex);
     _networkConnections.push_back(std::move(net));
 
     // Update the previously existing shortcuts (maybe remove them altogether?)
     _syncConnections.clear();
     _dataTransferConnections.clear();
     _externalControlConnection = nullptr;
+    _parentConnection = nullptr;
 
     for (const std::unique_ptr<Network>& connection : _networkConnections) {
         switch (connection->type()) {
             case Network::ConnectionType::SyncConnection:
                 _syncConnections.push_back(connection.get());
+                if (!connection->isServer()) {
+                    _parentConnection = connection.get();
+                }
                 break;
             case Network::ConnectionType::DataTransfer:
                 _dataTransferConnections.push_back(connection.get());
@@ -677,6 +1249,19 @@ void NetworkManager::addConnection(int port, std::string address,
             default: throw std::logic_error("Missing case label");
         }
     }
+
+    // Keep the connection to the parent first so that it is the first sync connection
+    // on every client, regardless of whether the client is also relaying data
+    std::stable_partition(
+        _syncConnections.begin(),
+        _syncConnections.end(),
+        [](Network* c) { return !c->isServer(); }
+    );
+
+    // must be initialized after binding. The connection has to be registered before it
+    // is initialized as a reactor might already report it as connected in this call
+    lock.unlock();
+    newConnection->initialize(_reactor.get());
 }
 
 bool NetworkManager::matchesAddress(std::string_view address) const {
@@ -691,12 +1276,10 @@ bool NetworkManager::isComputerServer() const {
 }
 
 bool NetworkManager::isRunning() const {
-    std::unique_lock lock(mutex::DataSync);
     return _isRunning;
 }
 
 bool NetworkManager::areAllNodesConnected() const {
-    std::unique_lock lock(mutex::DataSync);
     return _allNodesConnected;
 }
 
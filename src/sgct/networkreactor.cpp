@@ -0,0 +1,168 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/networkreactor.h>
+
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <array>
+
+#ifdef __linux__
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif // __linux__
+
+#define Err(code, msg) Error(Error::Component::Network, code, msg)
+
+namespace {
+    // Number of events that are handled per call to epoll_wait
+    constexpr const int MaxEvents = 64;
+} // namespace
+
+namespace sgct {
+
+bool NetworkReactor::isSupported() {
+#ifdef __linux__
+    return true;
+#else // __linux__
+    return false;
+#endif // __linux__
+}
+
+NetworkReactor::NetworkReactor() {
+    ZoneScoped
+
+#ifdef __linux__
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll == -1) {
+        throw Err(5015, fmt::format("Failed to create network reactor: {}", errno));
+    }
+
+    // The eventfd is used to wake up the reactor thread when it should terminate
+    _wakeup = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_wakeup == -1) {
+        close(_epoll);
+        throw Err(5015, fmt::format("Failed to create network reactor: {}", errno));
+    }
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeup, &ev);
+
+    _thread = std::make_unique<std::thread>([this]() { run(); });
+    Log::Info("Network reactor started");
+#else // __linux__
+    throw Err(5015, "Network reactor is not supported on this operating system");
+#endif // __linux__
+}
+
+NetworkReactor::~NetworkReactor() {
+#ifdef __linux__
+    _shouldTerminate = true;
+    const uint64_t v = 1;
+    [[maybe_unused]] const ssize_t res = write(_wakeup, &v, sizeof(v));
+    if (_thread) {
+        _thread->join();
+    }
+    close(_wakeup);
+    close(_epoll);
+#endif // __linux__
+}
+
+void NetworkReactor::add([[maybe_unused]] SGCT_SOCKET socket,
+                         [[maybe_unused]] Network& connection)
+{
+#ifdef __linux__
+    epoll_event ev = {};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.ptr = &connection;
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, socket, &ev) == -1) {
+        throw Err(
+            5016,
+            fmt::format("Failed to register socket with network reactor: {}", errno)
+        );
+    }
+#endif // __linux__
+}
+
+void NetworkReactor::remove([[maybe_unused]] SGCT_SOCKET socket) {
+#ifdef __linux__
+    // We don't care about errors here as the socket might have already been closed, in
+    // which case it was removed from the epoll set automatically
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, socket, nullptr);
+#endif // __linux__
+}
+
+void NetworkReactor::watchWritable([[maybe_unused]] SGCT_SOCKET socket,
+                                   [[maybe_unused]] Network& connection,
+                                   [[maybe_unused]] bool state)
+{
+#ifdef __linux__
+    epoll_event ev = {};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    if (state) {
+        ev.events |= EPOLLOUT;
+    }
+    ev.data.ptr = &connection;
+    if (epoll_ctl(_epoll, EPOLL_CTL_MOD, socket, &ev) == -1) {
+        throw Err(
+            5016,
+            fmt::format("Failed to register socket with network reactor: {}", errno)
+        );
+    }
+#endif // __linux__
+}
+
+bool NetworkReactor::isReactorThread() const {
+    return _thread && _thread->get_id() == std::this_thread::get_id();
+}
+
+void NetworkReactor::run() {
+#ifdef __linux__
+    std::array<epoll_event, MaxEvents> events;
+    while (!_shouldTerminate) {
+        const int n = epoll_wait(_epoll, events.data(), MaxEvents, -1);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Log::Error("Network reactor wait failed: {}", errno);
+            break;
+        }
+
+        for (int i = 0; i < n && !_shouldTerminate; ++i) {
+            Network* connection = static_cast<Network*>(events[i].data.ptr);
+            if (!connection) {
+                // wake up call
+                continue;
+            }
+
+            ZoneScopedN("Network reactor dispatch")
+            try {
+                if (events[i].events & EPOLLOUT) {
+                    connection->handleWritable();
+                }
+                if (events[i].events & ~EPOLLOUT) {
+                    connection->handleReadable();
+                }
+            }
+            catch (const std::runtime_error& e) {
+                Log::Error(e.what());
+                connection->closeReactorConnection();
+            }
+        }
+    }
+    Log::Info("Exiting network reactor");
+#endif // __linux__
+}
+
+} // namespace sgct
@@ -39,6 +39,9 @@ void Node::applyNode(const config::Node& node, bool initializeWindows) {
     if (node.swapLock) {
         _useSwapGroups = *node.swapLock;
     }
+    if (node.parent) {
+        _parent = *node.parent;
+    }
 
     if (initializeWindows) {
         for (const config::Window& window : node.windows) {
@@ -104,4 +107,8 @@ int Node::dataTransferPort() const {
     return _dataTransferPort;
 }
 
+int Node::parent() const {
+    return _parent;
+}
+
 } // namespace sgct
@@ -8,7 +8,11 @@
 
 #include <sgct/profiling.h>
 
-#ifdef TRACY_ENABLE
+#if defined(TRACY_ENABLE) || defined(SGCT_HAS_ALLOCATION_COUNTER)
+
+#include <sgct/allocationcounter.h>
+#include <cstdlib>
+#include <new>
 
 #ifdef WIN32
 #include <CodeAnalysis/warnings.h>
@@ -17,7 +21,14 @@
 #endif // WIN32
 
 void* operator new(size_t count) {
-    void* ptr = malloc(count);
+    // A zero-sized allocation still has to return a unique pointer
+    void* ptr = malloc(count > 0 ? count : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+#ifdef SGCT_HAS_ALLOCATION_COUNTER
+    sgct::AllocationCounter::recordAllocation(count);
+#endif // SGCT_HAS_ALLOCATION_COUNTER
     TracyAlloc(ptr, count);
     return ptr;
 }
@@ -31,4 +42,4 @@ void operator delete(void* ptr) noexcept {
 #pragma warning(pop)
 #endif // WIN32
 
-#endif // TRACY_ENABLE
+#endif // TRACY_ENABLE || SGCT_HAS_ALLOCATION_COUNTER
@@ -132,10 +132,10 @@ ivec4 NonLinearProjection::viewportCoords() {
 
 void NonLinearProjection::initTextures() {
     generateCubeMap(_textures.cubeMapColor, _texInternalFormat, _texFormat, _texType);
-    Log::Debug(fmt::format(
+    Log::Debug(
         "{0}x{0} color cube map texture (id: {1}) generated",
         _cubemapResolution, _textures.cubeMapColor
-    ));
+    );
 
     if (Settings::instance().useDepthTexture()) {
         generateCubeMap(
@@ -144,10 +144,10 @@ void NonLinearProjection::initTextures() {
             GL_DEPTH_COMPONENT,
             GL_FLOAT
         );
-        Log::Debug(fmt::format(
+        Log::Debug(
             "{0}x{0} depth cube map texture (id: {1}) generated",
             _cubemapResolution, _textures.cubeMapDepth
-        ));
+        );
 
         if (_useDepthTransformation) {
             // generate swap textures
@@ -157,16 +157,16 @@ void NonLinearProjection::initTextures() {
                 GL_DEPTH_COMPONENT,
                 GL_FLOAT
             );
-            Log::Debug(fmt::format(
+            Log::Debug(
                 "{0}x{0} depth swap map texture (id: {1}) generated",
                 _cubemapResolution, _textures.depthSwap
-            ));
+            );
 
             generateMap(_textures.colorSwap, _texInternalFormat, _texFormat, _texType);
-            Log::Debug(fmt::format(
+            Log::Debug(
                 "{0}x{0} color swap map texture (id: {1}) generated",
                 _cubemapResolution, _textures.colorSwap
-            ));
+            );
         }
     }
 
@@ -177,10 +177,10 @@ void NonLinearProjection::initTextures() {
             GL_RGB,
             GL_FLOAT
         );
-        Log::Debug(fmt::format(
+        Log::Debug(
             "{0}x{0} normal cube map texture (id: {1}) generated",
             _cubemapResolution, _textures.cubeMapNormals
-        ));
+        );
     }
 
     if (Settings::instance().usePositionTexture()) {
@@ -190,10 +190,10 @@ void NonLinearProjection::initTextures() {
             GL_RGB,
             GL_FLOAT
         );
-        Log::Debug(fmt::format(
+        Log::Debug(
             "{0}x{0} position cube map texture ({1}) generated",
             _cubemapResolution, _textures.cubeMapPositions
-        ));
+        );
     }
 }
 
@@ -225,9 +225,7 @@ void NonLinearProjection::generateMap(unsigned int& texture, unsigned int intern
     GLint maxMapRes;
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxMapRes);
     if (_cubemapResolution > maxMapRes) {
-        Log::Error(fmt::format(
-            "Requested size is too big ({} > {})", _cubemapResolution, maxMapRes
-        ));
+        Log::Error("Requested size is too big ({} > {})", _cubemapResolution, maxMapRes);
     }
 
     // set up texture target
@@ -268,7 +266,7 @@ void NonLinearProjection::generateCubeMap(unsigned int& texture,
     glGetIntegerv(GL_MAX_CUBE_MAP_TEXTURE_SIZE, &maxCubeMapRes);
     if (_cubemapResolution > maxCubeMapRes) {
         _cubemapResolution = maxCubeMapRes;
-        Log::Debug(fmt::format("Cubemap size set to max size: {}", maxCubeMapRes));
+        Log::Debug("Cubemap size set to max size: {}", maxCubeMapRes);
     }
 
     // set up texture target
@@ -399,6 +397,10 @@ void NonLinearProjection::renderCubeFace(const Window& win, BaseViewport& vp, in
         return;
     }
 
+    using Pass = GpuTimings::Pass;
+    const Pass pass = static_cast<Pass>(static_cast<int>(Pass::CubemapRight) + idx);
+    GpuTimings::Scope gpu(Engine::instance().gpuTimings(), pass);
+
     _cubeMapFbo->bind();
     if (!_cubeMapFbo->isMultiSampled()) {
         attachTextures(idx);
@@ -208,9 +208,9 @@ void SphericalMirrorProjection::initTextures() {
             return;
         }
         generateMap(texture, _texInternalFormat, _texFormat, _texType);
-        Log::Debug(fmt::format(
+        Log::Debug(
             "{0}x{0} cube face texture (id: {1}) generated", _cubemapResolution, texture
-        ));
+        );
     };
 
     generate(_subViewports.right, _textures.cubeFaceRight);
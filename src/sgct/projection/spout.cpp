@@ -230,9 +230,9 @@ void SpoutOutputProjection::render(const Window& window, const BaseViewport& vie
                 _mappingHeight
             );
             if (!s) {
-                Log::Error(fmt::format(
+                Log::Error(
                     "Error sending texture '{}' for face {}", _spout[i].texture, i
-                ));
+                );
             }
         }
 #endif
@@ -393,7 +393,7 @@ void SpoutOutputProjection::initTextures() {
 
         for (int i = 0; i < NFaces; ++i) {
 #ifdef SGCT_HAS_SPOUT
-            Log::Debug(fmt::format("SpoutOutputProjection initTextures {}", i));
+            Log::Debug("SpoutOutputProjection initTextures {}", i);
             if (!_spout[i].enabled) {
                 continue;
             }
@@ -406,9 +406,7 @@ void SpoutOutputProjection::initTextures() {
                     _mappingHeight
                 );
                 if (!success) {
-                    Log::Error(fmt::format(
-                        "Error creating SPOUT handle for {}", CubeMapFaceName[i]
-                    ));
+                    Log::Error("Error creating SPOUT handle for {}", CubeMapFaceName[i]);
                 }
             }
 #endif
@@ -449,9 +447,7 @@ void SpoutOutputProjection::initTextures() {
                 _mappingHeight
             );
             if (!success) {
-                Log::Error(fmt::format(
-                    "Error creating SPOUT sender for '{}'", _mappingName
-                ));
+                Log::Error("Error creating SPOUT sender for '{}'", _mappingName);
             }
         }
 #endif
@@ -491,9 +487,7 @@ void SpoutOutputProjection::initTextures() {
                 _mappingHeight
             );
             if (!success) {
-                Log::Error(fmt::format(
-                    "Error creating SPOUT handle for '{}'", _mappingName
-                ));
+                Log::Error("Error creating SPOUT handle for '{}'", _mappingName);
             }
         }
 #endif
@@ -253,7 +253,7 @@ namespace {
             return value;
         }
         else {
-            sgct::Log::Error(fmt::format("Error extracting value '{}'", name));
+            sgct::Log::Error("Error extracting value '{}'", name);
             return std::nullopt;
         }
     }
@@ -681,6 +681,7 @@ namespace {
         }
         node.dataTransferPort = parseValue<int>(elem, "dataTransferPort");
         node.swapLock = parseValue<bool>(elem, "swapLock");
+        node.parent = parseValue<int>(elem, "parent");
 
         tinyxml2::XMLElement* wnd = elem.FirstChildElement("Window");
         int count = 0;
@@ -794,6 +795,36 @@ namespace {
         return res;
     }
 
+    sgct::config::Compression parseCompression(tinyxml2::XMLElement& element) {
+        sgct::config::Compression res;
+        res.sync = parseValue<bool>(element, "sync");
+        res.dataTransfer = parseValue<bool>(element, "dataTransfer");
+        res.threshold = parseValue<int>(element, "threshold");
+        res.delta = parseValue<bool>(element, "delta");
+        res.keyframeInterval = parseValue<int>(element, "keyframeInterval");
+        return res;
+    }
+
+    sgct::config::Multicast parseMulticast(tinyxml2::XMLElement& element) {
+        sgct::config::Multicast res;
+        if (const char* a = element.Attribute("address"); a) {
+            res.address = a;
+        }
+        else {
+            throw Err(6065, "Missing field address in multicast");
+        }
+        if (element.Attribute("port")) {
+            res.port = *parseValue<int>(element, "port");
+        }
+        else {
+            throw Err(6066, "Missing field port in multicast");
+        }
+        if (const char* a = element.Attribute("interface"); a) {
+            res.interfaceAddress = a;
+        }
+        return res;
+    }
+
     sgct::config::Device parseDevice(tinyxml2::XMLElement& element) {
         sgct::config::Device device;
         device.name = element.Attribute("name");
@@ -930,6 +961,14 @@ namespace {
         cluster.debugLog = parseValue<bool>(root, "debugLog");
         cluster.externalControlPort = parseValue<int>(root, "externalControlPort");
         cluster.firmSync = parseValue<bool>(root, "firmSync");
+        cluster.useNetworkReactor = parseValue<bool>(root, "networkReactor");
+        cluster.useSharedMemory = parseValue<bool>(root, "sharedMemory");
+        if (const char* a = root.Attribute("dataTransferCache"); a) {
+            cluster.dataTransferCache = a;
+        }
+        cluster.syncSpinTime = parseValue<int>(root, "syncSpinTime");
+        cluster.renderAhead = parseValue<int>(root, "renderAhead");
+        cluster.asyncDecode = parseValue<bool>(root, "asyncDecode");
 
         if (tinyxml2::XMLElement* e = root.FirstChildElement("Scene"); e) {
             cluster.scene = parseScene(*e);
@@ -946,6 +985,12 @@ namespace {
         if (tinyxml2::XMLElement* e = root.FirstChildElement("Capture"); e) {
             cluster.capture = parseCapture(*e);
         }
+        if (tinyxml2::XMLElement* e = root.FirstChildElement("Compression"); e) {
+            cluster.compression = parseCompression(*e);
+        }
+        if (tinyxml2::XMLElement* e = root.FirstChildElement("Multicast"); e) {
+            cluster.multicast = parseMulticast(*e);
+        }
 
         tinyxml2::XMLElement* trackerElem = root.FirstChildElement("Tracker");
         while (trackerElem) {
@@ -969,7 +1014,7 @@ namespace {
 namespace sgct {
 
 config::Cluster readConfig(const std::string& filename) {
-    Log::Debug(fmt::format("Parsing XML config '{}'", filename));
+    Log::Debug("Parsing XML config '{}'", filename);
 
     std::string name = std::filesystem::absolute(filename).string();
 
@@ -986,14 +1031,12 @@ config::Cluster readConfig(const std::string& filename) {
     // and reset the current working directory to the old value
     std::filesystem::current_path(oldPwd);
 
-    Log::Debug(fmt::format("Config file '{}' read successfully", name));
-    Log::Info(fmt::format("Number of nodes in cluster: {}", cluster.nodes.size()));
+    Log::Debug("Config file '{}' read successfully", name);
+    Log::Info("Number of nodes in cluster: {}", cluster.nodes.size());
 
     for (size_t i = 0; i < cluster.nodes.size(); i++) {
         const config::Node& node = cluster.nodes[i];
-        Log::Info(fmt::format(
-            "\tNode ({}) address: {} [{}]", i, node.address, node.port
-        ));
+        Log::Info("\tNode ({}) address: {} [{}]", i, node.address, node.port);
     }
 
     return cluster;
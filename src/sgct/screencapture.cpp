@@ -108,9 +108,9 @@ void ScreenCapture::initOrResize(ivec2 resolution, int channels, int bytesPerCol
     }
 
     glGenBuffers(1, &_pbo);
-    Log::Debug(fmt::format(
+    Log::Debug(
         "Generating {}x{}x{} PBO: {}", _resolution.x, _resolution.y, _nChannels, _pbo
-    ));
+    );
 
     glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbo);
     glBufferData(GL_PIXEL_PACK_BUFFER, _dataSize, nullptr, GL_STATIC_READ);
@@ -136,9 +136,9 @@ void ScreenCapture::saveScreenCapture(unsigned int textureId, CaptureSource capS
         uint64_t end = Settings::instance().screenshotLimitEnd();
 
         if (number < begin || number >= end) {
-            Log::Debug(fmt::format(
+            Log::Debug(
                 "Skipping screenshot {} outside range [{}, {}]", number, begin, end
-            ));
+            );
             return;
         }
     }
@@ -202,7 +202,7 @@ void ScreenCapture::initialize(int windowIndex, ScreenCapture::EyeIndex ei) {
     }
     _windowIndex = windowIndex;
 
-    Log::Debug(fmt::format("Number of screencapture threads is set to {}", _nThreads));
+    Log::Debug("Number of screencapture threads is set to {}", _nThreads);
 }
 
 std::string ScreenCapture::createFilename(uint64_t frameNumber) {
@@ -297,7 +297,7 @@ void ScreenCapture::checkImageBuffer(CaptureSource captureSource) {
 }
 
 Image* ScreenCapture::prepareImage(int index, std::string file) {
-    Log::Debug(fmt::format("Starting thread for screenshot/capture [{}]", index));
+    Log::Debug("Starting thread for screenshot/capture [{}]", index);
 
     if (_captureInfos[index].frameBufferImage == nullptr) {
         _captureInfos[index].frameBufferImage = std::make_unique<Image>();
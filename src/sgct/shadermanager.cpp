@@ -65,9 +65,7 @@ bool ShaderManager::removeShaderProgram(std::string_view name) {
     );
 
     if (shaderIt == _shaderPrograms.end()) {
-        Log::Warning(
-            fmt::format("Unable to remove shader program [{}]: Not found", name)
-        );
+        Log::Warning("Unable to remove shader program [{}]: Not found", name);
         return false;
     }
 
@@ -27,9 +27,7 @@ namespace {
             std::vector<GLchar> log(logLength);
             glGetProgramInfoLog(programId, logLength, nullptr, log.data());
 
-            sgct::Log::Error(
-                fmt::format("Shader [{}] linking error: {}", name, log.data())
-            );
+            sgct::Log::Error("Shader [{}] linking error: {}", name, log.data());
         }
         return linkStatus != 0;
     }
@@ -52,16 +50,12 @@ namespace {
             glGetShaderiv(id, GL_INFO_LOG_LENGTH, &logLength);
 
             if (logLength == 0) {
-                sgct::Log::Error(fmt::format(
-                    "{} compile error: Unknown error", shaderTypeName(type)
-                ));
+                sgct::Log::Error("{} compile error: Unknown error", shaderTypeName(type));
             }
 
             std::vector<GLchar> log(logLength);
             glGetShaderInfoLog(id, logLength, nullptr, log.data());
-            sgct::Log::Error(fmt::format(
-                "{} compile error: {}", shaderTypeName(type), log.data()
-            ));
+            sgct::Log::Error("{} compile error: {}", shaderTypeName(type), log.data());
         }
     }
 } // namespace
@@ -8,14 +8,43 @@
 
 #include <sgct/shareddata.h>
 
+#include <sgct/clusterclock.h>
+#include <sgct/error.h>
+#include <sgct/fmt.h>
 #include <sgct/log.h>
+#include <sgct/mutexes.h>
 #include <sgct/profiling.h>
+#include <sgct/sharedvariable.h>
+#include <sgct/syncrecording.h>
 #include <zlib.h>
+#include <algorithm>
 #include <cstring>
 #include <string>
 
+#define Err(code, msg) Error(Error::Component::Network, code, msg)
+
 namespace sgct {
 
+namespace {
+    // Two changed regions that are separated by fewer unchanged bytes than the overhead
+    // of a segment (offset + length) are merged into a single segment
+    constexpr const size_t SegmentOverhead = 2 * sizeof(uint32_t);
+
+    template <typename T>
+    T read(const std::byte*& p, const std::byte* end, uint32_t frame) {
+        if (p + sizeof(T) > end) {
+            throw Err(
+                5017,
+                fmt::format("Received malformed shared data frame {}", frame)
+            );
+        }
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+} // namespace
+
 SharedData* SharedData::_instance = nullptr;
 
 SharedData& SharedData::instance() {
@@ -50,53 +79,442 @@ void SharedData::setDecodeFunction(
     _decodeFn = std::move(function);
 }
 
+void SharedData::setEncodeInPlaceFunction(
+                                   std::function<void(std::vector<std::byte>&)> function)
+{
+    _encodeInPlaceFn = std::move(function);
+}
+
+void SharedData::setDecodeInPlaceFunction(
+                                  std::function<void(const std::byte*, size_t)> function)
+{
+    _decodeInPlaceFn = std::move(function);
+}
+
+void SharedData::setStagedDecodeFunctions(
+                            std::function<void(const std::byte*, size_t)> decodeFunction,
+                            std::function<void()> swapFunction)
+{
+    _stagedDecodeFn = std::move(decodeFunction);
+    _swapFn = std::move(swapFunction);
+}
+
 void SharedData::decode(const char* receivedData, int receivedLength) {
     ZoneScoped
 
+    const bool isStaged = isDecodeStaged();
+    if (isStaged) {
+        // The render thread might not have taken the previous frame yet, which only
+        // happens if the master does not wait for the clients to acknowledge the frames
+        std::unique_lock lock(_stagingMutex);
+        _stagingCond.wait(
+            lock,
+            [this]() { return !_isStagedFrameReady || !_useAsyncDecode; }
+        );
+    }
+
+    const double t0 = ClusterClock::instance().localTime();
+    const bool needsSwap = decodeFrame(receivedData, receivedLength);
+    _lastDecodeTime = ClusterClock::instance().localTime() - t0;
+
+    if (isStaged) {
+        _needsSwap = needsSwap;
+        _isStagedFrameReady = true;
+    }
+}
+
+double SharedData::lastDecodeTime() const {
+    return _lastDecodeTime;
+}
+
+void SharedData::applyStagedFrame() {
+    ZoneScoped
+
+    if (!_isStagedFrameReady) {
+        return;
+    }
+
+    if (_needsSwap && _swapFn) {
+        _swapFn();
+    }
+
     {
-        std::unique_lock lk(mutex::DataSync);
+        TimedLock lock(_stagingMutex);
+        _isStagedFrameReady = false;
+    }
+    _stagingCond.notify_one();
+}
 
-        // reset
-        _dataBlock.clear();
+bool SharedData::isStagedFrameReady() const {
+    return !isDecodeStaged() || _isStagedFrameReady;
+}
 
-        if (receivedLength > static_cast<int>(_dataBlock.capacity())) {
-            _dataBlock.reserve(receivedLength);
+void SharedData::setAsyncDecode(bool state) {
+    {
+        std::unique_lock lock(_stagingMutex);
+        _useAsyncDecode = state;
+    }
+    _stagingCond.notify_one();
+}
+
+bool SharedData::isDecodeStaged() const {
+    return _useAsyncDecode && _stagedDecodeFn;
+}
+
+bool SharedData::decodeFrame(const char* receivedData, int receivedLength) {
+    const std::byte* p = reinterpret_cast<const std::byte*>(receivedData);
+    const std::byte* end = p + receivedLength;
+
+    const uint8_t flags = read<uint8_t>(p, end, 0);
+    const Encoding encoding = static_cast<Encoding>(flags & ~VariablesFlag);
+    const bool hasVariables = (flags & VariablesFlag) != 0;
+    const uint32_t frame = read<uint32_t>(p, end, 0);
+    if (encoding == Encoding::Full) {
+        if (!_useDeltaEncoding) {
+            // Without delta encoding, the data is not needed after this frame and can be
+            // decoded straight from the receive buffer
+            _frameNumber = frame;
+            _hasKeyframe = true;
+            const size_t size = static_cast<size_t>(end - p);
+            const size_t offset = hasVariables ? decodeVariables(p, size, frame) : 0;
+            if (isDecodeStaged()) {
+                _stagedDecodeFn(p + offset, size - offset);
+            }
+            else if (_decodeInPlaceFn) {
+                _decodeInPlaceFn(p + offset, size - offset);
+            }
+            else if (_decodeFn) {
+                _payload.assign(p, end);
+                _decodeFn(_payload, static_cast<unsigned int>(offset));
+            }
+            return true;
         }
-        _dataBlock.insert(
-            _dataBlock.end(),
-            reinterpret_cast<const std::byte*>(receivedData),
-            reinterpret_cast<const std::byte*>(receivedData) + receivedLength
-        );
+        _payload.assign(p, end);
+    }
+    else {
+        ZoneScopedN("Apply Delta")
+
+        const uint32_t reference = read<uint32_t>(p, end, frame);
+        if (!_hasKeyframe || reference != _frameNumber) {
+            // This happens if we connected after the master sent the last keyframe. The
+            // next keyframe was already requested when this connection was established
+            Log::Debug(
+                "Skipping shared data frame {} as its reference frame {} is missing",
+                frame, reference
+            );
+            return false;
+        }
+
+        const uint32_t size = read<uint32_t>(p, end, frame);
+        const uint32_t nSegments = read<uint32_t>(p, end, frame);
+        _payload.resize(size);
+        for (uint32_t i = 0; i < nSegments; i++) {
+            const uint32_t offset = read<uint32_t>(p, end, frame);
+            const uint32_t length = read<uint32_t>(p, end, frame);
+            if (p + length > end || offset + length > size) {
+                throw Err(
+                    5017,
+                    fmt::format("Received malformed shared data frame {}", frame)
+                );
+            }
+            std::memcpy(_payload.data() + offset, p, length);
+            p += length;
+        }
+    }
+    _frameNumber = frame;
+    _hasKeyframe = true;
+
+    const size_t offset =
+        hasVariables ? decodeVariables(_payload.data(), _payload.size(), frame) : 0;
+    if (isDecodeStaged()) {
+        _stagedDecodeFn(_payload.data() + offset, _payload.size() - offset);
     }
+    else if (_decodeInPlaceFn) {
+        _decodeInPlaceFn(_payload.data() + offset, _payload.size() - offset);
+    }
+    else if (_decodeFn) {
+        _decodeFn(_payload, static_cast<unsigned int>(offset));
+    }
+    return true;
+}
 
-    if (_decodeFn) {
-        std::vector<std::byte> data;
-        data.assign(
-            reinterpret_cast<const std::byte*>(receivedData),
-            reinterpret_cast<const std::byte*>(receivedData) + receivedLength
+size_t SharedData::decodeVariables(const std::byte* data, size_t size, uint32_t frame) {
+    ZoneScoped
+
+    const std::byte* p = data;
+    const std::byte* end = data + size;
+    const uint32_t nVariables = read<uint32_t>(p, end, frame);
+
+    TimedLock lock(_variablesMutex);
+    for (uint32_t i = 0; i < nVariables; i++) {
+        const uint32_t id = read<uint32_t>(p, end, frame);
+        const uint32_t length = read<uint32_t>(p, end, frame);
+        if (p + length > end) {
+            throw Err(
+                5017,
+                fmt::format("Received malformed shared data frame {}", frame)
+            );
+        }
+
+        const auto it = std::find_if(
+            _variables.cbegin(),
+            _variables.cend(),
+            [id](SharedVariableBase* v) { return v->id() == id; }
         );
-        _decodeFn(data, 0u);
+        // Variables that are not registered on this node are skipped
+        if (it != _variables.cend() && !(*it)->decode(p, length)) {
+            throw Err(
+                5019,
+                fmt::format(
+                    "Received {} bytes for shared variable {} in frame {}",
+                    length, id, frame
+                )
+            );
+        }
+        p += length;
     }
+    return static_cast<size_t>(p - data);
 }
 
 void SharedData::encode() {
     ZoneScoped
 
-    {
-        std::unique_lock lk(mutex::DataSync);
-        _dataBlock.clear();
+    // The data block is only accessed by the render thread, which encodes the frame and
+    // sends it afterwards, so it does not need to be locked
+    _dataBlock.clear();
+    _dataBlock.insert(
+        _dataBlock.begin(),
+        _headerSpace.cbegin(),
+        _headerSpace.cbegin() + Network::HeaderSize
+    );
 
-        _dataBlock.insert(
-            _dataBlock.begin(),
-            _headerSpace.cbegin(),
-            _headerSpace.cbegin() + Network::HeaderSize
+    _frameNumber++;
+    // Keyframes also carry all shared variables for clients that have just connected
+    const bool isIntervalKeyframe =
+        _useDeltaEncoding && _framesSinceKeyframe >= _keyframeInterval;
+    const bool isKeyframe = _forceKeyframe.exchange(false) || isIntervalKeyframe;
+    if (!_useDeltaEncoding) {
+        // Every frame is a full frame, so the data goes directly into the data block
+        const size_t encodingPos = _dataBlock.size();
+        serializeObject(_dataBlock, Encoding::Full);
+        serializeObject(_dataBlock, _frameNumber);
+        if (encodeData(_dataBlock, isKeyframe)) {
+            _dataBlock[encodingPos] |= std::byte { VariablesFlag };
+        }
+    }
+    else {
+        _encodeBuffer.clear();
+        const bool hasVariables = encodeData(_encodeBuffer, isKeyframe);
+
+        if (!isKeyframe && encodeDelta(_encodeBuffer, hasVariables)) {
+            _framesSinceKeyframe++;
+        }
+        else {
+            const size_t encodingPos = _dataBlock.size();
+            serializeObject(_dataBlock, Encoding::Full);
+            serializeObject(_dataBlock, _frameNumber);
+            if (hasVariables) {
+                _dataBlock[encodingPos] |= std::byte { VariablesFlag };
+            }
+            _dataBlock.insert(
+                _dataBlock.end(),
+                _encodeBuffer.begin(),
+                _encodeBuffer.end()
+            );
+            _framesSinceKeyframe = 0;
+        }
+
+        // Swapping keeps the capacity of both buffers for the next frames. The scratch
+        // buffer is empty after the first swap and would otherwise grow in the next frame
+        std::swap(_payload, _encodeBuffer);
+        _encodeBuffer.reserve(_payload.capacity());
+    }
+
+    const size_t size = _dataBlock.size() - Network::HeaderSize;
+    if (_recorder) {
+        _recorder->record(
+            _frameNumber,
+            ClusterClock::instance().time(),
+            _dataBlock.data() + Network::HeaderSize,
+            size
         );
     }
 
-    if (_encodeFn) {
-        std::vector<std::byte> data = _encodeFn();
-        _dataBlock.insert(_dataBlock.end(), data.begin(), data.end());
+    if (!_useCompression || size < static_cast<size_t>(_compressionThreshold)) {
+        return;
+    }
+
+    ZoneScopedN("Compress")
+
+    // The sync data is latency-critical, so we trade compression ratio for speed
+    uLongf compressedSize = compressBound(static_cast<uLong>(size));
+    _compressedBlock.resize(Network::HeaderSize + compressedSize);
+    const int err = compress2(
+        reinterpret_cast<Bytef*>(_compressedBlock.data() + Network::HeaderSize),
+        &compressedSize,
+        reinterpret_cast<const Bytef*>(_dataBlock.data() + Network::HeaderSize),
+        static_cast<uLong>(size),
+        Z_BEST_SPEED
+    );
+    if (err != Z_OK) {
+        throw Err(5024, fmt::format("Failed to compress data: {}", err));
+    }
+
+    // Incompressible data is sent as is since the clients would only pay for it
+    if (compressedSize >= size) {
+        return;
+    }
+
+    std::memcpy(_compressedBlock.data(), _headerSpace.data(), Network::HeaderSize);
+    _compressedBlock[0] = std::byte { Network::CompressedDataId };
+    const uint32_t uncompressedSize = static_cast<uint32_t>(size);
+    std::memcpy(_compressedBlock.data() + 9, &uncompressedSize, sizeof(uint32_t));
+    _compressedBlock.resize(Network::HeaderSize + compressedSize);
+
+    std::swap(_dataBlock, _compressedBlock);
+}
+
+void SharedData::startRecording(std::string path) {
+    _recorder = std::make_unique<SyncRecorder>(std::move(path));
+    _forceKeyframe = true;
+}
+
+void SharedData::stopRecording() {
+    _recorder = nullptr;
+}
+
+bool SharedData::encodeData(std::vector<std::byte>& buffer, bool isKeyframe) {
+    bool hasVariables = false;
+    {
+        ZoneScopedN("Encode Variables")
+
+        // Without variables nothing is written, so that the data of the encode function
+        // starts at the beginning of the frame as it did before variables existed
+        TimedLock lock(_variablesMutex);
+        hasVariables = !_variables.empty();
+        if (hasVariables) {
+            const size_t nVariablesPos = buffer.size();
+            serializeObject(buffer, uint32_t(0));
+
+            uint32_t nVariables = 0;
+            for (SharedVariableBase* variable : _variables) {
+                if (!isKeyframe && !variable->isDirty()) {
+                    continue;
+                }
+
+                serializeObject(buffer, variable->id());
+                const size_t lengthPos = buffer.size();
+                serializeObject(buffer, uint32_t(0));
+                variable->encode(buffer);
+                const uint32_t length =
+                    static_cast<uint32_t>(buffer.size() - lengthPos - sizeof(uint32_t));
+                std::memcpy(buffer.data() + lengthPos, &length, sizeof(uint32_t));
+                nVariables++;
+            }
+            std::memcpy(buffer.data() + nVariablesPos, &nVariables, sizeof(uint32_t));
+        }
+    }
+
+    if (_encodeInPlaceFn) {
+        _encodeInPlaceFn(buffer);
+    }
+    else if (_encodeFn) {
+        const std::vector<std::byte> data = _encodeFn();
+        buffer.insert(buffer.end(), data.begin(), data.end());
+    }
+    return hasVariables;
+}
+
+bool SharedData::encodeDelta(const std::vector<std::byte>& data, bool hasVariables) {
+    ZoneScoped
+
+    const size_t start = _dataBlock.size();
+    serializeObject(_dataBlock, Encoding::Delta);
+    if (hasVariables) {
+        _dataBlock[start] |= std::byte { VariablesFlag };
+    }
+    serializeObject(_dataBlock, _frameNumber);
+    serializeObject(_dataBlock, _frameNumber - 1);
+    serializeObject(_dataBlock, static_cast<uint32_t>(data.size()));
+    const size_t nSegmentsPos = _dataBlock.size();
+    serializeObject(_dataBlock, uint32_t(0));
+
+    // Everything past the end of the previous frame counts as changed
+    const size_t common = std::min(data.size(), _payload.size());
+    auto isChanged = [&](size_t i) { return i >= common || data[i] != _payload[i]; };
+
+    // The delta is only worth it if it is smaller than sending the full frame
+    const size_t maxSize = sizeof(Encoding) + sizeof(uint32_t) + data.size();
+
+    uint32_t nSegments = 0;
+    size_t i = 0;
+    while (i < data.size()) {
+        if (!isChanged(i)) {
+            i++;
+            continue;
+        }
+
+        // Extend the segment until we find a long enough run of unchanged bytes
+        const size_t begin = i;
+        size_t end = i + 1;
+        for (i = end; i < data.size() && i - end < SegmentOverhead; i++) {
+            if (isChanged(i)) {
+                end = i + 1;
+            }
+        }
+        i = end;
+
+        serializeObject(_dataBlock, static_cast<uint32_t>(begin));
+        serializeObject(_dataBlock, static_cast<uint32_t>(end - begin));
+        _dataBlock.insert(_dataBlock.end(), data.begin() + begin, data.begin() + end);
+        nSegments++;
+
+        if (_dataBlock.size() - start >= maxSize) {
+            _dataBlock.resize(start);
+            return false;
+        }
     }
+
+    std::memcpy(_dataBlock.data() + nSegmentsPos, &nSegments, sizeof(uint32_t));
+    return true;
+}
+
+void SharedData::registerVariable(SharedVariableBase& variable) {
+    std::unique_lock lock(_variablesMutex);
+    const auto it = std::find_if(
+        _variables.cbegin(),
+        _variables.cend(),
+        [&variable](SharedVariableBase* v) { return v->id() == variable.id(); }
+    );
+    if (it != _variables.cend()) {
+        throw Err(
+            5018,
+            fmt::format("Shared variable id {} is already registered", variable.id())
+        );
+    }
+    _variables.push_back(&variable);
+}
+
+void SharedData::unregisterVariable(SharedVariableBase& variable) {
+    std::unique_lock lock(_variablesMutex);
+    _variables.erase(
+        std::remove(_variables.begin(), _variables.end(), &variable),
+        _variables.end()
+    );
+}
+
+void SharedData::setDeltaEncoding(bool state, int keyframeInterval) {
+    _useDeltaEncoding = state;
+    _keyframeInterval = keyframeInterval;
+}
+
+void SharedData::requestKeyframe() {
+    _forceKeyframe = true;
+}
+
+void SharedData::setCompression(bool state, int threshold) {
+    _useCompression = state;
+    _compressionThreshold = threshold;
 }
 
 unsigned char* SharedData::dataBlock() {
@@ -145,32 +563,36 @@ void serializeObject(std::vector<std::byte>& buffer, const std::wstring& value)
     buffer.insert(buffer.end(), ws, ws + length * sizeof(wchar_t));
 }
 
+void deserializeObject(const std::byte* buffer, unsigned int& pos, std::string& value) {
+    uint32_t size;
+    deserializeObject(buffer, pos, size);
+
+    value.assign(reinterpret_cast<const char*>(buffer + pos), size);
+    pos += size * sizeof(std::string::value_type);
+}
+
+void deserializeObject(const std::byte* buffer, unsigned int& pos, std::wstring& value) {
+    uint32_t size;
+    deserializeObject(buffer, pos, size);
+
+    // The characters are not necessarily aligned in the buffer
+    value.resize(size);
+    std::memcpy(value.data(), buffer + pos, size * sizeof(std::wstring::value_type));
+    pos += size * sizeof(std::wstring::value_type);
+}
+
 template <>
 void deserializeObject(const std::vector<std::byte>& buffer, unsigned int& pos,
                        std::string& value)
 {
-    uint32_t size;
-    deserializeObject<uint32_t>(buffer, pos, size);
-
-    value = std::string(
-        reinterpret_cast<const char*>(buffer.data() + pos),
-        reinterpret_cast<const char*>(buffer.data() + pos + size)
-    );
-    pos += size * sizeof(std::string::value_type);
+    deserializeObject(buffer.data(), pos, value);
 }
 
 template <>
 void deserializeObject(const std::vector<std::byte>& buffer, unsigned int& pos,
                        std::wstring& value)
 {
-    uint32_t size;
-    deserializeObject<uint32_t>(buffer, pos, size);
-
-    value = std::wstring(
-        reinterpret_cast<const char*>(buffer.data() + pos),
-        reinterpret_cast<const char*>(buffer.data() + pos + size)
-    );
-    pos += size * sizeof(std::wstring::value_type);
+    deserializeObject(buffer.data(), pos, value);
 }
 
 } // namespace sgct
@@ -0,0 +1,345 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/sharedmemorychannel.h>
+
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif // __linux__
+
+#define Err(code, msg) Error(Error::Component::Network, code, msg)
+
+namespace {
+    // Size of each of the two ring buffers; this has to be a power of two so that the
+    // positions can wrap around at 2^32
+    constexpr const uint32_t RingSize = 1 << 20;
+
+    // Written by the server once the segment is initialized
+    constexpr const uint32_t Magic = 0x53474354; // SGCT
+
+    constexpr const uint32_t Waiting = 0;
+    constexpr const uint32_t Connected = 1;
+
+    // Time after which a blocked call checks whether the other process still exists
+    constexpr const long WaitTimeout = 100 * 1000 * 1000; // ns
+
+    std::atomic<uint64_t> nSyscalls = 0;
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+#ifdef __linux__
+    // The futexes are not private as they are shared between processes
+    bool futexWait(std::atomic<uint32_t>& word, uint32_t value) {
+        timespec timeout = { 0, WaitTimeout };
+        nSyscalls++;
+        const long res = syscall(
+            SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, value, &timeout,
+            nullptr, 0
+        );
+        return res == 0 || errno != ETIMEDOUT;
+    }
+
+    void futexWake(std::atomic<uint32_t>& word) {
+        nSyscalls++;
+        syscall(
+            SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0
+        );
+    }
+#else // __linux__
+    // The channel cannot be created on other operating systems, so this is never used
+    void futexWake(std::atomic<uint32_t>&) {}
+#endif // __linux__
+} // namespace
+
+namespace sgct {
+
+struct SharedMemoryChannel::Ring {
+    // The total number of bytes that were written and read. Each position is only
+    // modified by one side and they are kept on separate cache lines
+    alignas(64) std::atomic<uint32_t> head = 0;
+    std::atomic<uint32_t> isReaderWaiting = 0;
+    alignas(64) std::atomic<uint32_t> tail = 0;
+    std::atomic<uint32_t> isWriterWaiting = 0;
+    alignas(64) char data[RingSize];
+};
+
+struct SharedMemoryChannel::Segment {
+    std::atomic<uint32_t> magic = 0;
+    std::atomic<uint32_t> state = Waiting;
+    std::atomic<int32_t> serverPid = 0;
+    std::atomic<int32_t> clientPid = 0;
+
+    // The ring from the server to the client followed by the one in the other direction
+    Ring rings[2];
+};
+
+bool SharedMemoryChannel::isSupported() {
+#ifdef __linux__
+    return true;
+#else // __linux__
+    return false;
+#endif // __linux__
+}
+
+uint64_t SharedMemoryChannel::syscallCount() {
+    return nSyscalls;
+}
+
+SharedMemoryChannel::SharedMemoryChannel(int port, bool isServer)
+    : _name(fmt::format("/sgct-{}", port))
+    , _isServer(isServer)
+{
+    ZoneScoped
+
+#ifdef __linux__
+    if (!_isServer) {
+        return;
+    }
+
+    // Remove the segment of a previous run that was not shut down properly
+    shm_unlink(_name.c_str());
+    const int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        throw Err(
+            5038,
+            fmt::format("Failed to create shared memory segment {}: {}", _name, errno)
+        );
+    }
+    if (ftruncate(fd, sizeof(Segment)) == -1) {
+        ::close(fd);
+        shm_unlink(_name.c_str());
+        throw Err(
+            5038,
+            fmt::format("Failed to create shared memory segment {}: {}", _name, errno)
+        );
+    }
+    void* p = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        shm_unlink(_name.c_str());
+        throw Err(
+            5038,
+            fmt::format("Failed to create shared memory segment {}: {}", _name, errno)
+        );
+    }
+
+    _segment = new (p) Segment;
+    _segment->serverPid = static_cast<int32_t>(getpid());
+    _segment->magic = Magic;
+#else // __linux__
+    throw Err(5039, "Shared memory channel is not supported on this operating system");
+#endif // __linux__
+}
+
+SharedMemoryChannel::~SharedMemoryChannel() {
+    close();
+
+#ifdef __linux__
+    if (_segment) {
+        munmap(_segment, sizeof(Segment));
+    }
+    if (_isServer) {
+        shm_unlink(_name.c_str());
+    }
+#endif // __linux__
+}
+
+bool SharedMemoryChannel::accept() {
+    while (_segment->state != Connected) {
+        if (!wait(_segment->state, Waiting)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SharedMemoryChannel::connect() {
+#ifdef __linux__
+    if (!_segment) {
+        const int fd = shm_open(_name.c_str(), O_RDWR, 0);
+        if (fd == -1) {
+            return false;
+        }
+        // The server might not have resized the segment yet
+        struct stat info;
+        if (fstat(fd, &info) == -1 || info.st_size < static_cast<off_t>(sizeof(Segment)))
+        {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(
+            nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0
+        );
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            return false;
+        }
+        _segment = static_cast<Segment*>(p);
+    }
+
+    // The segment might still belong to a server of a previous run that crashed
+    if (_segment->magic != Magic || kill(_segment->serverPid, 0) == -1) {
+        munmap(_segment, sizeof(Segment));
+        _segment = nullptr;
+        return false;
+    }
+
+    _segment->clientPid = static_cast<int32_t>(getpid());
+    uint32_t state = Waiting;
+    if (!_segment->state.compare_exchange_strong(state, Connected)) {
+        return false;
+    }
+    futexWake(_segment->state);
+    return true;
+#else // __linux__
+    return false;
+#endif // __linux__
+}
+
+void SharedMemoryChannel::reset() {
+    for (Ring& ring : _segment->rings) {
+        ring.head = 0;
+        ring.tail = 0;
+        ring.isReaderWaiting = 0;
+        ring.isWriterWaiting = 0;
+    }
+    _segment->clientPid = 0;
+    _segment->state = Waiting;
+}
+
+bool SharedMemoryChannel::send(const void* data, uint32_t size, bool shouldNotify) {
+    Ring& ring = _segment->rings[_isServer ? 0 : 1];
+    const char* src = static_cast<const char*>(data);
+
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    while (size > 0) {
+        const uint32_t tail = ring.tail.load(std::memory_order_acquire);
+        const uint32_t space = RingSize - (head - tail);
+        if (space == 0) {
+            // The reader might be waiting for a part of the message that we did not
+            // notify it about yet
+            if (ring.isReaderWaiting) {
+                futexWake(ring.head);
+            }
+
+            // The flag has to be visible before the tail is checked again, otherwise the
+            // reader might miss that it has to wake us up
+            ring.isWriterWaiting = 1;
+            const bool isAlive = ring.tail != tail || wait(ring.tail, tail);
+            ring.isWriterWaiting = 0;
+            if (!isAlive) {
+                return false;
+            }
+            continue;
+        }
+
+        // Copy as much as fits, which might wrap around the end of the ring
+        const uint32_t n = std::min(space, size);
+        const uint32_t offset = head & (RingSize - 1);
+        const uint32_t first = std::min(n, RingSize - offset);
+        std::memcpy(ring.data + offset, src, first);
+        std::memcpy(ring.data, src + first, n - first);
+        src += n;
+        size -= n;
+        head += n;
+
+        ring.head = head;
+        if (shouldNotify && ring.isReaderWaiting) {
+            futexWake(ring.head);
+        }
+    }
+    return true;
+}
+
+bool SharedMemoryChannel::receive(char* buffer, uint32_t size) {
+    Ring& ring = _segment->rings[_isServer ? 1 : 0];
+
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    while (size > 0) {
+        const uint32_t head = ring.head.load(std::memory_order_acquire);
+        const uint32_t available = head - tail;
+        if (available == 0) {
+            ring.isReaderWaiting = 1;
+            const bool isAlive = ring.head != head || wait(ring.head, head);
+            ring.isReaderWaiting = 0;
+            if (!isAlive) {
+                return false;
+            }
+            continue;
+        }
+
+        const uint32_t n = std::min(available, size);
+        const uint32_t offset = tail & (RingSize - 1);
+        const uint32_t first = std::min(n, RingSize - offset);
+        std::memcpy(buffer, ring.data + offset, first);
+        std::memcpy(buffer + first, ring.data, n - first);
+        buffer += n;
+        size -= n;
+        tail += n;
+
+        ring.tail = tail;
+        if (ring.isWriterWaiting) {
+            futexWake(ring.tail);
+        }
+    }
+    return true;
+}
+
+void SharedMemoryChannel::close() {
+    _isClosed = true;
+
+#ifdef __linux__
+    if (_segment) {
+        futexWake(_segment->state);
+        for (Ring& ring : _segment->rings) {
+            futexWake(ring.head);
+            futexWake(ring.tail);
+        }
+    }
+#endif // __linux__
+}
+
+bool SharedMemoryChannel::wait([[maybe_unused]] std::atomic<uint32_t>& word,
+                               [[maybe_unused]] uint32_t value)
+{
+#ifdef __linux__
+    if (_isClosed) {
+        return false;
+    }
+    if (futexWait(word, value)) {
+        return !_isClosed;
+    }
+
+    // The other process is gone if it terminated without disconnecting
+    const pid_t pid = _isServer ? _segment->clientPid : _segment->serverPid;
+    return !_isClosed && (pid == 0 || kill(pid, 0) == 0 || errno != ESRCH);
+#else // __linux__
+    return false;
+#endif // __linux__
+}
+
+} // namespace sgct
@@ -0,0 +1,262 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/stagetimings.h>
+
+#include <sgct/allocationcounter.h>
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cmath>
+
+#define Err(code, msg) Error(Error::Component::Engine, code, msg)
+
+namespace {
+    constexpr const std::array<const char*, 8> StageNames = {
+        "Poll events", "PreSync", "Encode", "Frame lock pre stage", "PostSyncPreDraw",
+        "PostDraw", "Frame lock post stage", "Swap"
+    };
+    constexpr const std::array<const char*, 3> WindowStageNames = {
+        "cubemaps", "viewports", "warp"
+    };
+
+    // The first bucket starts at 1 us and every bucket is 2^(1/4) times larger than the
+    // previous one, so the buckets span 24 octaves up to about 16 s
+    constexpr const double BucketOrigin = 1e-6;
+    constexpr const double BucketsPerOctave = 4.0;
+
+    int bucket(double time) {
+        if (time <= BucketOrigin) {
+            return 0;
+        }
+        const int b = static_cast<int>(BucketsPerOctave * std::log2(time / BucketOrigin));
+        return std::min(b, sgct::StageTimings::BucketCount - 1);
+    }
+
+    double bucketCenter(int bucket) {
+        return BucketOrigin * std::exp2((bucket + 0.5) / BucketsPerOctave);
+    }
+
+    double percentile(const std::array<uint64_t, sgct::StageTimings::BucketCount>& b,
+                      uint64_t total, double p)
+    {
+        if (total == 0) {
+            return 0.0;
+        }
+        const uint64_t rank = std::max<uint64_t>(
+            static_cast<uint64_t>(std::ceil(p * static_cast<double>(total))),
+            1
+        );
+        uint64_t sum = 0;
+        for (int i = 0; i < sgct::StageTimings::BucketCount; ++i) {
+            sum += b[i];
+            if (sum >= rank) {
+                return bucketCenter(i);
+            }
+        }
+        return bucketCenter(sgct::StageTimings::BucketCount - 1);
+    }
+} // namespace
+
+namespace sgct {
+
+StageTimings::Scope::Scope(StageTimings& timings, Stage stage)
+    : _timings(timings)
+    , _stage(static_cast<int>(stage))
+    , _start(std::chrono::steady_clock::now())
+    , _startAllocations(AllocationCounter::threadCounts().nAllocations)
+{}
+
+StageTimings::Scope::Scope(StageTimings& timings, int window, WindowStage stage)
+    : _timings(timings)
+    , _stage(
+        timings._nGlobalStages +
+        window * static_cast<int>(WindowStageNames.size()) + static_cast<int>(stage)
+    )
+    , _start(std::chrono::steady_clock::now())
+    , _startAllocations(AllocationCounter::threadCounts().nAllocations)
+{}
+
+StageTimings::Scope::~Scope() {
+    const std::chrono::duration<double> d = std::chrono::steady_clock::now() - _start;
+    const uint64_t n = AllocationCounter::threadCounts().nAllocations;
+    _timings.add(_stage, d.count(), n - _startAllocations);
+}
+
+StageTimings::StageTimings(int nWindows)
+    : _nGlobalStages(static_cast<int>(StageNames.size()))
+{
+    for (const char* name : StageNames) {
+        _stages.push_back(std::make_unique<Data>());
+        _stages.back()->name = name;
+    }
+    for (int i = 0; i < nWindows; ++i) {
+        for (const char* name : WindowStageNames) {
+            _stages.push_back(std::make_unique<Data>());
+            _stages.back()->name = fmt::format("Window {} {}", i, name);
+        }
+    }
+}
+
+StageTimings::~StageTimings() {
+    if (_exportFile.is_open()) {
+        writeSnapshot();
+    }
+}
+
+void StageTimings::add(int stage, double time, uint64_t nAllocations) {
+    if (stage < 0 || stage >= static_cast<int>(_stages.size())) {
+        return;
+    }
+    Data& data = *_stages[stage];
+    data.current += time;
+    data.currentAllocations += nAllocations;
+    data.isMeasured = true;
+}
+
+void StageTimings::endFrame() {
+    ZoneScoped
+
+    for (const std::unique_ptr<Data>& data : _stages) {
+        if (!data->isMeasured) {
+            continue;
+        }
+
+        // This is the only thread that writes, so the values only have to be published
+        // by the counter
+        const uint64_t n = data->count.load(std::memory_order_relaxed);
+        data->history[n % HistoryLength].store(
+            static_cast<float>(data->current),
+            std::memory_order_relaxed
+        );
+        data->buckets[bucket(data->current)].fetch_add(1, std::memory_order_relaxed);
+        data->lastAllocations.store(data->currentAllocations, std::memory_order_relaxed);
+        data->totalAllocations.fetch_add(
+            data->currentAllocations,
+            std::memory_order_relaxed
+        );
+        data->count.store(n + 1, std::memory_order_release);
+
+        data->current = 0.0;
+        data->currentAllocations = 0;
+        data->isMeasured = false;
+    }
+
+    if (_exportFile.is_open()) {
+        const auto now = std::chrono::steady_clock::now();
+        const std::chrono::duration<double> d = now - _lastExport;
+        if (d.count() >= _exportInterval) {
+            writeSnapshot();
+            _lastExport = now;
+        }
+    }
+}
+
+std::vector<StageTimings::Snapshot> StageTimings::snapshot() const {
+    std::vector<Snapshot> res;
+    res.reserve(_stages.size());
+    for (const std::unique_ptr<Data>& data : _stages) {
+        Snapshot s;
+        s.name = data->name;
+        s.count = data->count.load(std::memory_order_acquire);
+
+        const uint64_t n = std::min<uint64_t>(s.count, HistoryLength);
+        s.history.reserve(n);
+        for (uint64_t i = s.count - n; i < s.count; ++i) {
+            s.history.push_back(
+                data->history[i % HistoryLength].load(std::memory_order_relaxed)
+            );
+        }
+        if (!s.history.empty()) {
+            s.last = s.history.back();
+            const auto [min, max] = std::minmax_element(
+                s.history.cbegin(),
+                s.history.cend()
+            );
+            s.min = *min;
+            s.max = *max;
+            double sum = 0.0;
+            for (float v : s.history) {
+                sum += v;
+            }
+            s.mean = sum / static_cast<double>(s.history.size());
+        }
+
+        std::array<uint64_t, BucketCount> buckets;
+        uint64_t total = 0;
+        for (int i = 0; i < BucketCount; ++i) {
+            buckets[i] = data->buckets[i].load(std::memory_order_relaxed);
+            total += buckets[i];
+        }
+        s.p50 = percentile(buckets, total, 0.5);
+        s.p95 = percentile(buckets, total, 0.95);
+        s.p99 = percentile(buckets, total, 0.99);
+        s.allocations = data->lastAllocations.load(std::memory_order_relaxed);
+        s.totalAllocations = data->totalAllocations.load(std::memory_order_relaxed);
+
+        res.push_back(std::move(s));
+    }
+    return res;
+}
+
+void StageTimings::exportTo(const std::string& path, double interval) {
+    if (_exportFile.is_open()) {
+        _exportFile.close();
+    }
+    _exportFile.open(path, std::ios::out | std::ios::trunc);
+    if (!_exportFile.good()) {
+        throw Err(3009, fmt::format("Failed to open stage timings file {}", path));
+    }
+    const size_t dot = path.find_last_of('.');
+    _isJson = dot != std::string::npos && path.substr(dot) == ".json";
+    _exportInterval = interval;
+    _exportStart = std::chrono::steady_clock::now();
+    _lastExport = _exportStart;
+
+    if (!_isJson) {
+        _exportFile << "time,stage,count,last,mean,min,max,p50,p95,p99,allocations,"
+            "totalAllocations\n";
+    }
+    Log::Info("Exporting the stage timings to {} every {} s", path, interval);
+}
+
+void StageTimings::writeSnapshot() {
+    ZoneScoped
+
+    const std::chrono::duration<double> t =
+        std::chrono::steady_clock::now() - _exportStart;
+    const std::vector<Snapshot> snapshots = snapshot();
+
+    if (_isJson) {
+        _exportFile << fmt::format(R"({{"time":{},"stages":[)", t.count());
+        for (size_t i = 0; i < snapshots.size(); ++i) {
+            const Snapshot& s = snapshots[i];
+            _exportFile << fmt::format(
+                R"({}{{"name":"{}","count":{},"last":{},"mean":{},"min":{},"max":{},)"
+                R"("p50":{},"p95":{},"p99":{},"allocations":{},"totalAllocations":{}}})",
+                i == 0 ? "" : ",", s.name, s.count, s.last, s.mean, s.min, s.max,
+                s.p50, s.p95, s.p99, s.allocations, s.totalAllocations
+            );
+        }
+        _exportFile << "]}\n";
+    }
+    else {
+        for (const Snapshot& s : snapshots) {
+            _exportFile << fmt::format(
+                "{},{},{},{},{},{},{},{},{},{},{},{}\n",
+                t.count(), s.name, s.count, s.last, s.mean, s.min, s.max, s.p50, s.p95,
+                s.p99, s.allocations, s.totalAllocations
+            );
+        }
+    }
+    _exportFile.flush();
+}
+
+} // namespace sgct
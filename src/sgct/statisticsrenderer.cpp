@@ -8,6 +8,7 @@
 
 #include <sgct/statisticsrenderer.h>
 
+#include <sgct/allocationcounter.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
 #ifdef SGCT_HAS_TEXT
@@ -30,6 +31,9 @@ namespace {
     constexpr const sgct::vec4 ColorSyncTime = sgct::vec4{ 0.1f, 1.f, 1.f, 0.8f };
     constexpr const sgct::vec4 ColorLoopTimeMin = sgct::vec4{ 0.4f, 0.4f, 1.f, 0.8f };
     constexpr const sgct::vec4 ColorLoopTimeMax = sgct::vec4{ 0.15f, 0.15f, 0.8f, 0.8f };
+    constexpr const sgct::vec4 ColorNode = sgct::vec4{ 0.8f, 0.8f, 0.8f, 0.8f };
+    constexpr const sgct::vec4 ColorSlowestNode = sgct::vec4{ 1.f, 0.2f, 0.2f, 1.f };
+    constexpr const sgct::vec4 ColorAllocations = sgct::vec4{ 1.f, 0.6f, 0.2f, 0.8f };
 
     constexpr const char* StatsVertShader = R"(
 #version 330 core
@@ -397,6 +401,38 @@ void StatisticsRenderer::render(const Window& window, const Viewport& viewport)
             ColorLoopTimeMax,
             fmt::format("Max Loop time: {} ms", _statistics.loopTimeMax[0] * 1000.0)
         );
+        if (AllocationCounter::isEnabled()) {
+            text::print(
+                window,
+                viewport,
+                f2,
+                mode,
+                Pos.x, Pos.y + 5 * Offset,
+                ColorAllocations,
+                fmt::format("Allocations: {}", _statistics.allocations[0])
+            );
+        }
+
+        // The timings that the nodes reported to the master, with the node that took
+        // the longest to draw and decode the last frame highlighted
+        for (size_t i = 0; i < _statistics.nodeTimes.size(); ++i) {
+            const Engine::Statistics::NodeTimes& t = _statistics.nodeTimes[i];
+            const bool isSlowest = _statistics.slowestNodes[0] == static_cast<int>(i);
+            text::print(
+                window,
+                viewport,
+                f2,
+                mode,
+                Pos.x, Pos.y + (9.f + static_cast<float>(i)) * Offset,
+                isSlowest ? ColorSlowestNode : ColorNode,
+                fmt::format(
+                    "Node {}: frame {:.2f} ms, draw {:.2f} ms, decode {:.2f} ms, "
+                    "sync {:.2f} ms, swap {:.2f} ms", i, t.frameTimes[0] * 1000.0,
+                    t.drawTimes[0] * 1000.0, t.decodeTimes[0] * 1000.0,
+                    t.syncTimes[0] * 1000.0, t.swapTimes[0] * 1000.0
+                )
+            );
+        }
 #endif // SGCT_HAS_TEXT
     }
 
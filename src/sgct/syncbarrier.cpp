@@ -0,0 +1,20 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/syncbarrier.h>
+
+namespace sgct {
+
+void SyncBarrier::notify() {
+    std::unique_lock lock(_mutex);
+    if (_isComplete && _isComplete()) {
+        _cond.notify_one();
+    }
+}
+
+} // namespace sgct
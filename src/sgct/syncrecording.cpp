@@ -0,0 +1,335 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/syncrecording.h>
+
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#ifdef WIN32
+#include <windows.h>
+#else // WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+#define Err(code, msg) Error(Error::Component::Network, code, msg)
+
+namespace {
+    constexpr const std::array<char, 8> Magic = {
+        'S', 'G', 'C', 'T', 'S', 'Y', 'N', 'C'
+    };
+    constexpr const uint32_t Version = 1;
+
+    // The magic identifier, the version, and four unused bytes
+    constexpr const size_t FileHeaderSize = 16;
+
+    // Each frame starts with its number, its size, and the time it was encoded. Recorded
+    // frames are never empty, so a zero size marks the unused end of the file
+    constexpr const size_t FrameHeaderSize = 2 * sizeof(uint32_t) + sizeof(double);
+
+    // The file grows in large steps so that it only rarely has to be mapped again
+    constexpr const size_t GrowthSize = 64 * 1024 * 1024;
+
+    int lastError() {
+#ifdef WIN32
+        return static_cast<int>(GetLastError());
+#else // WIN32
+        return errno;
+#endif // WIN32
+    }
+} // namespace
+
+namespace sgct {
+
+SyncRecorder::SyncRecorder(std::string path)
+    : _path(std::move(path))
+{
+    ZoneScoped
+
+#ifdef WIN32
+    _file = CreateFileA(
+        _path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (_file == INVALID_HANDLE_VALUE) {
+        _file = nullptr;
+#else // WIN32
+    _file = open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (_file == -1) {
+#endif // WIN32
+        throw Err(
+            5041,
+            fmt::format("Failed to create recording {}: {}", _path, lastError())
+        );
+    }
+
+    try {
+        resize(GrowthSize);
+    }
+    catch (const Error&) {
+        closeFile();
+        throw;
+    }
+    std::memcpy(_data, Magic.data(), Magic.size());
+    std::memcpy(_data + Magic.size(), &Version, sizeof(Version));
+    _size = FileHeaderSize;
+
+    Log::Info("Recording the shared data to {}", _path);
+}
+
+SyncRecorder::~SyncRecorder() {
+    closeFile();
+    Log::Info("Recorded {} frames to {}", _nFrames, _path);
+}
+
+void SyncRecorder::record(uint32_t frame, double time, const std::byte* data,
+                          size_t size)
+{
+    ZoneScoped
+
+    const size_t required = _size + FrameHeaderSize + size;
+    if (required > _capacity) {
+        resize(std::max(_capacity + GrowthSize, required));
+    }
+
+    const uint32_t s = static_cast<uint32_t>(size);
+    std::byte* p = _data + _size;
+    std::memcpy(p, &frame, sizeof(uint32_t));
+    std::memcpy(p + sizeof(uint32_t), &s, sizeof(uint32_t));
+    std::memcpy(p + 2 * sizeof(uint32_t), &time, sizeof(double));
+    std::memcpy(p + FrameHeaderSize, data, size);
+    _size = required;
+    _nFrames++;
+}
+
+uint64_t SyncRecorder::nFrames() const {
+    return _nFrames;
+}
+
+void SyncRecorder::resize(size_t capacity) {
+    ZoneScoped
+
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+        _data = nullptr;
+    }
+    if (_mapping) {
+        CloseHandle(_mapping);
+    }
+    const uint64_t c = static_cast<uint64_t>(capacity);
+    _mapping = CreateFileMappingA(
+        _file,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(c >> 32),
+        static_cast<DWORD>(c & 0xFFFFFFFF),
+        nullptr
+    );
+    if (_mapping) {
+        _data = static_cast<std::byte*>(
+            MapViewOfFile(_mapping, FILE_MAP_WRITE, 0, 0, capacity)
+        );
+    }
+    if (!_data) {
+#else // WIN32
+    if (_data) {
+        munmap(_data, _capacity);
+        _data = nullptr;
+    }
+    void* p = MAP_FAILED;
+    if (ftruncate(_file, static_cast<off_t>(capacity)) == 0) {
+        p = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _file, 0);
+    }
+    if (p != MAP_FAILED) {
+        _data = static_cast<std::byte*>(p);
+    }
+    else {
+#endif // WIN32
+        throw Err(
+            5042,
+            fmt::format("Failed to write recording {}: {}", _path, lastError())
+        );
+    }
+    _capacity = capacity;
+}
+
+void SyncRecorder::closeFile() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+        _data = nullptr;
+    }
+    if (_mapping) {
+        CloseHandle(_mapping);
+        _mapping = nullptr;
+    }
+    if (_file) {
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(_size);
+        SetFilePointerEx(_file, size, nullptr, FILE_BEGIN);
+        SetEndOfFile(_file);
+        CloseHandle(_file);
+        _file = nullptr;
+    }
+#else // WIN32
+    if (_data) {
+        munmap(_data, _capacity);
+        _data = nullptr;
+    }
+    if (_file != -1) {
+        if (ftruncate(_file, static_cast<off_t>(_size)) == -1) {
+            Log::Warning("Failed to truncate recording {}", _path);
+        }
+        close(_file);
+        _file = -1;
+    }
+#endif // WIN32
+}
+
+SyncPlayer::SyncPlayer(std::string path)
+    : _path(std::move(path))
+{
+    ZoneScoped
+
+#ifdef WIN32
+    _file = CreateFileA(
+        _path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    LARGE_INTEGER size;
+    if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size)) {
+        const int err = lastError();
+        if (_file == INVALID_HANDLE_VALUE) {
+            _file = nullptr;
+        }
+        closeFile();
+        throw Err(5043, fmt::format("Failed to open recording {}: {}", _path, err));
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size >= FileHeaderSize) {
+        _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping) {
+            _data = static_cast<const std::byte*>(
+                MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)
+            );
+        }
+        if (!_data) {
+            const int err = lastError();
+            closeFile();
+            throw Err(5043, fmt::format("Failed to open recording {}: {}", _path, err));
+        }
+    }
+#else // WIN32
+    _file = open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (_file == -1 || fstat(_file, &info) == -1) {
+        const int err = lastError();
+        closeFile();
+        throw Err(5043, fmt::format("Failed to open recording {}: {}", _path, err));
+    }
+    _size = static_cast<size_t>(info.st_size);
+    if (_size >= FileHeaderSize) {
+        void* p = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _file, 0);
+        if (p == MAP_FAILED) {
+            const int err = lastError();
+            closeFile();
+            throw Err(5043, fmt::format("Failed to open recording {}: {}", _path, err));
+        }
+        _data = static_cast<const std::byte*>(p);
+    }
+#endif // WIN32
+
+    uint32_t version = 0;
+    if (_data) {
+        std::memcpy(&version, _data + Magic.size(), sizeof(version));
+    }
+    if (!_data || std::memcmp(_data, Magic.data(), Magic.size()) != 0 ||
+        version != Version)
+    {
+        closeFile();
+        throw Err(5044, fmt::format("File {} is not a valid recording", _path));
+    }
+    _position = FileHeaderSize;
+
+    Log::Info("Replaying the shared data from {}", _path);
+}
+
+SyncPlayer::~SyncPlayer() {
+    closeFile();
+}
+
+std::optional<SyncPlayer::Frame> SyncPlayer::next() {
+    if (_position + FrameHeaderSize > _size) {
+        return std::nullopt;
+    }
+
+    const std::byte* p = _data + _position;
+    Frame frame;
+    uint32_t size = 0;
+    std::memcpy(&frame.number, p, sizeof(uint32_t));
+    std::memcpy(&size, p + sizeof(uint32_t), sizeof(uint32_t));
+    std::memcpy(&frame.time, p + 2 * sizeof(uint32_t), sizeof(double));
+
+    // The rest of the file is unused if the recording was not closed properly
+    if (size == 0 || _position + FrameHeaderSize + size > _size) {
+        return std::nullopt;
+    }
+
+    frame.data = reinterpret_cast<const char*>(p + FrameHeaderSize);
+    frame.size = static_cast<int>(size);
+    _position += FrameHeaderSize + size;
+    return frame;
+}
+
+void SyncPlayer::closeFile() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+        _data = nullptr;
+    }
+    if (_mapping) {
+        CloseHandle(_mapping);
+        _mapping = nullptr;
+    }
+    if (_file) {
+        CloseHandle(_file);
+        _file = nullptr;
+    }
+#else // WIN32
+    if (_data) {
+        munmap(const_cast<std::byte*>(_data), _size);
+        _data = nullptr;
+    }
+    if (_file != -1) {
+        close(_file);
+        _file = -1;
+    }
+#endif // WIN32
+}
+
+} // namespace sgct
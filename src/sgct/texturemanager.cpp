@@ -32,10 +32,10 @@ namespace {
             }
         }(img.channels());
 
-        sgct::Log::Debug(fmt::format(
+        sgct::Log::Debug(
             "Creating texture. Size: {}x{}, {}-channels, Type: {:#04x}, Format: {:#04x}",
             img.size().x, img.size().y, img.channels(), type, internalFormat
-        ));
+        );
 
         glPixelStorei(GL_PACK_ALIGNMENT, 1);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -132,7 +132,7 @@ unsigned int TextureManager::loadTexture(const std::string& filename, bool inter
         anisotropicFilterSize,
         mipmapLevels
     );
-    Log::Debug(fmt::format("Texture created from '{}' [id={}]", filename, t));
+    Log::Debug("Texture created from '{}' [id={}]", filename, t);
     return t;
 }
 
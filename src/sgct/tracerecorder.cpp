@@ -0,0 +1,208 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/tracerecorder.h>
+
+#include <sgct/clusterclock.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // The fields of an event are atomic so that a dump can read them while the thread
+    // overwrites them. The sequence number is the index of the event plus one and it is
+    // set to 0 while the event is written, so that a torn event can be detected
+    struct Event {
+        std::atomic<uint64_t> sequence = 0;
+        std::atomic<const char*> name = nullptr;
+        std::atomic<int64_t> start = 0;
+        std::atomic<int64_t> duration = 0;
+        std::atomic<uint64_t> frame = 0;
+    };
+
+    struct ThreadBuffer {
+        int id = 0;
+        std::array<Event, sgct::TraceRecorder::BufferSize> events;
+        std::atomic<uint64_t> head = 0;
+    };
+
+    // A plain copy of an event that is formatted after the buffers have been unlocked
+    struct DumpedEvent {
+        const char* name;
+        int64_t start;
+        int64_t duration;
+        uint64_t frame;
+        int thread;
+    };
+
+    // The buffer of a thread that ended is kept, so that its zones are still part of the
+    // next dump, and is handed to the next thread that starts recording. So there are
+    // never more buffers than threads that were recording at the same time
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> freeBuffers;
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+
+    // Set once the thread is exiting, as the buffer must not be taken again after it
+    // was released
+    thread_local bool isThreadExiting = false;
+
+    struct ThreadBufferRelease {
+        ~ThreadBufferRelease() {
+            isThreadExiting = true;
+            if (threadBuffer) {
+                std::unique_lock lock(buffersMutex);
+                freeBuffers.push_back(threadBuffer);
+                threadBuffer = nullptr;
+            }
+        }
+    };
+    thread_local ThreadBufferRelease threadBufferRelease;
+
+    ThreadBuffer& acquireThreadBuffer() {
+        // Touching the thread-local object makes sure that it is destroyed on exit
+        [[maybe_unused]] ThreadBufferRelease& release = threadBufferRelease;
+
+        std::unique_lock lock(buffersMutex);
+        if (!freeBuffers.empty()) {
+            ThreadBuffer* buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+            return *buffer;
+        }
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffers.back()->id = static_cast<int>(buffers.size());
+        return *buffers.back();
+    }
+
+    std::string escape(std::string_view str) {
+        std::string res;
+        res.reserve(str.size());
+        for (char c : str) {
+            if (c == '"' || c == '\\') {
+                res += '\\';
+            }
+            res += c;
+        }
+        return res;
+    }
+} // namespace
+
+namespace sgct {
+
+void TraceRecorder::setEnabled(bool enabled) {
+    _isEnabled = enabled;
+}
+
+bool TraceRecorder::isEnabled() {
+    return _isEnabled;
+}
+
+void TraceRecorder::setFrameNumber(uint64_t frame) {
+    _frame.store(frame, std::memory_order_relaxed);
+}
+
+void TraceRecorder::requestDump() {
+    _isDumpRequested = true;
+}
+
+bool TraceRecorder::takeDumpRequest() {
+    return _isDumpRequested.exchange(false);
+}
+
+int64_t TraceRecorder::now() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::record(const char* name, int64_t start) {
+    const int64_t end = now();
+    if (!threadBuffer) {
+        if (isThreadExiting) {
+            return;
+        }
+        threadBuffer = &acquireThreadBuffer();
+    }
+
+    // This thread is the only one writing into the buffer
+    const uint64_t i = threadBuffer->head.load(std::memory_order_relaxed);
+    Event& e = threadBuffer->events[i % BufferSize];
+    e.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    e.name.store(name, std::memory_order_relaxed);
+    e.start.store(start, std::memory_order_relaxed);
+    e.duration.store(end - start, std::memory_order_relaxed);
+    e.frame.store(_frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    e.sequence.store(i + 1, std::memory_order_release);
+    threadBuffer->head.store(i + 1, std::memory_order_release);
+}
+
+void TraceRecorder::dump(const std::string& path, int node) {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.good()) {
+        Log::Error("Failed to open trace file {}", path);
+        return;
+    }
+
+    // The timestamps are converted from the steady clock into the cluster time in us
+    const double offset =
+        ClusterClock::instance().time() * 1e6 - static_cast<double>(now()) / 1e3;
+
+    file << "{\"traceEvents\":[\n";
+    file << fmt::format(
+        R"({{"name":"process_name","ph":"M","pid":{},"args":{{"name":"Node {}"}}}})",
+        node, node
+    );
+
+    // Only the events are copied while the buffers are locked, so that threads that start
+    // or end in the meantime do not have to wait for the file to be written
+    std::vector<DumpedEvent> events;
+    std::unique_lock lock(buffersMutex);
+    events.reserve(buffers.size() * BufferSize);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const uint64_t first = head > BufferSize ? head - BufferSize : 0;
+        for (uint64_t i = first; i < head; ++i) {
+            const Event& e = buffer->events[i % BufferSize];
+            if (e.sequence.load(std::memory_order_acquire) != i + 1) {
+                continue;
+            }
+            const char* name = e.name.load(std::memory_order_relaxed);
+            const int64_t start = e.start.load(std::memory_order_relaxed);
+            const int64_t duration = e.duration.load(std::memory_order_relaxed);
+            const uint64_t frame = e.frame.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (e.sequence.load(std::memory_order_relaxed) != i + 1) {
+                // The event was overwritten while we were reading it
+                continue;
+            }
+
+            events.push_back({ name, start, duration, frame, buffer->id });
+        }
+    }
+    lock.unlock();
+
+    for (const DumpedEvent& e : events) {
+        file << fmt::format(
+            ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},"
+            "\"dur\":{:.3f},\"args\":{{\"frame\":{}}}}}",
+            escape(e.name), node, e.thread,
+            static_cast<double>(e.start) / 1e3 + offset,
+            static_cast<double>(e.duration) / 1e3, e.frame
+        );
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    Log::Info("Wrote {} trace events to {}", events.size(), path);
+}
+
+} // namespace sgct
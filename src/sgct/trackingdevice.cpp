@@ -63,7 +63,7 @@ void TrackingDevice::setSensorTransform(vec3 vec, quat rot) {
     Tracker* parent = TrackingManager::instance().trackers()[_parentIndex].get();
 
     if (parent == nullptr) {
-        Log::Error(fmt::format("Error getting handle to tracker for device '{}'", _name));
+        Log::Error("Error getting handle to tracker for device '{}'", _name);
         return;
     }
 
@@ -220,9 +220,7 @@ void TrackingManager::startSampling() {
     }
 
     if (_head == nullptr && !trackerName.empty() && !deviceName.empty()) {
-        Log::Error(fmt::format(
-            "Failed to set head tracker to {}@{}", deviceName, trackerName
-        ));
+        Log::Error("Failed to set head tracker to {}@{}", deviceName, trackerName);
         return;
     }
 
@@ -245,10 +243,10 @@ void TrackingManager::addTracker(std::string name) {
     if (!tracker(name)) {
         _trackers.push_back(std::make_unique<Tracker>(name));
         gTrackers.emplace_back(std::vector<VRPNPointer>());
-        Log::Info(fmt::format("Tracker '{}' added successfully", name));
+        Log::Info("Tracker '{}' added successfully", name);
     }
     else {
-        Log::Warning(fmt::format("Tracker '{}' already exists", name));
+        Log::Warning("Tracker '{}' already exists", name);
     }
 }
 
@@ -271,7 +269,7 @@ void TrackingManager::addSensorToCurrentDevice(std::string address, int id) {
         device->setSensorId(id);
 
         if (retVal.second && ptr.sensorDevice == nullptr) {
-            Log::Info(fmt::format("Connecting to sensor '{}'", address));
+            Log::Info("Connecting to sensor '{}'", address);
             ptr.sensorDevice = std::make_unique<vrpn_Tracker_Remote>(address.c_str());
             ptr.sensorDevice->register_change_handler(
                 _trackers.back().get(),
@@ -280,7 +278,7 @@ void TrackingManager::addSensorToCurrentDevice(std::string address, int id) {
         }
     }
     else {
-        Log::Error(fmt::format("Failed to connect to sensor '{}'", address));
+        Log::Error("Failed to connect to sensor '{}'", address);
     }
 }
 
@@ -293,15 +291,13 @@ void TrackingManager::addButtonsToCurrentDevice(std::string address, int nButton
     TrackingDevice* device = _trackers.back()->devices().back().get();
 
     if (ptr.buttonDevice == nullptr && device) {
-        Log::Info(fmt::format(
-            "Connecting to buttons '{}' on device {}", address, device->name()
-        ));
+        Log::Info("Connecting to buttons '{}' on device {}", address, device->name());
         ptr.buttonDevice = std::make_unique<vrpn_Button_Remote>(address.c_str());
         ptr.buttonDevice->register_change_handler(device, updateButton);
         device->setNumberOfButtons(nButtons);
     }
     else {
-        Log::Error(fmt::format("Failed to connect to buttons '{}'", address));
+        Log::Error("Failed to connect to buttons '{}'", address);
     }
 }
 
@@ -314,16 +310,14 @@ void TrackingManager::addAnalogsToCurrentDevice(std::string address, int nAxes)
     TrackingDevice* device = _trackers.back()->devices().back().get();
 
     if (ptr.analogDevice == nullptr && device) {
-        Log::Info(fmt::format(
-            "Connecting to analog '{}' on device {}", address, device->name()
-        ));
+        Log::Info("Connecting to analog '{}' on device {}", address, device->name());
 
         ptr.analogDevice = std::make_unique<vrpn_Analog_Remote>(address.c_str());
         ptr.analogDevice->register_change_handler(device, updateAnalog);
         device->setNumberOfAxes(nAxes);
     }
     else {
-        Log::Error(fmt::format("Failed to connect to analogs '{}'", address));
+        Log::Error("Failed to connect to analogs '{}'", address);
     }
 }
 
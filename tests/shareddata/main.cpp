@@ -0,0 +1,143 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/sgct.h>
+#include <sgct/allocationcounter.h>
+
+// Encodes a payload of a fixed size through the in-place callbacks as the master and
+// decodes the frames as a client afterwards. The test fails if any frame after the first
+// one allocates on the heap while it is encoded or decoded, or if a value is lost
+
+namespace {
+    constexpr const int NFrames = 1000;
+    constexpr const int KeyframeInterval = 60;
+
+    // Larger than any encoded frame so that storing the frames does not allocate
+    constexpr const size_t MaxFrameSize = 4096;
+
+    struct Payload {
+        double time = 0.0;
+        int32_t frame = 0;
+        std::vector<float> values = std::vector<float>(256);
+    };
+    Payload sent;
+    Payload received;
+} // namespace
+
+using namespace sgct;
+
+void encode(std::vector<std::byte>& data) {
+    serializeObject(data, sent.time);
+    serializeObject(data, sent.frame);
+    serializeObject(data, sent.values);
+}
+
+void decode(const std::byte* data, size_t) {
+    unsigned int pos = 0;
+    deserializeObject(data, pos, received.time);
+    deserializeObject(data, pos, received.frame);
+    deserializeObject(data, pos, received.values);
+}
+
+void updatePayload(Payload& payload, int frame) {
+    // Only some of the values change, so that the delta frames stay small
+    payload.time = frame * 0.016;
+    payload.frame = frame;
+    payload.values[frame % payload.values.size()] = static_cast<float>(frame);
+}
+
+/// \return the number of heap allocations that the calling thread made in \p function
+template <typename F>
+uint64_t countAllocations(F&& function) {
+    AllocationCounter::setEnabled(true);
+    const uint64_t before = AllocationCounter::threadCounts().nAllocations;
+    function();
+    const uint64_t n = AllocationCounter::threadCounts().nAllocations - before;
+    AllocationCounter::setEnabled(false);
+    return n;
+}
+
+bool runFrames(bool useDeltaEncoding) {
+    const std::string_view mode = useDeltaEncoding ? "delta" : "full";
+
+    std::vector<std::vector<std::byte>> frames(NFrames);
+    for (std::vector<std::byte>& frame : frames) {
+        frame.reserve(MaxFrameSize);
+    }
+
+    // The master and the client are separate instances, as they are in a cluster
+    SharedData& master = SharedData::instance();
+    master.setEncodeInPlaceFunction(encode);
+    master.setDeltaEncoding(useDeltaEncoding, KeyframeInterval);
+    sent = Payload();
+    uint64_t nEncodeAllocations = 0;
+    for (int i = 0; i < NFrames; ++i) {
+        updatePayload(sent, i);
+
+        // The first frame sizes the buffers, which are reused by all following frames
+        const uint64_t n = countAllocations([&master]() { master.encode(); });
+        nEncodeAllocations += i > 0 ? n : 0;
+
+        const std::byte* data =
+            reinterpret_cast<const std::byte*>(master.dataBlock()) + Network::HeaderSize;
+        frames[i].assign(data, data + master.dataSize() - Network::HeaderSize);
+    }
+    SharedData::destroy();
+
+    SharedData& client = SharedData::instance();
+    client.setDecodeInPlaceFunction(decode);
+    client.setDeltaEncoding(useDeltaEncoding, KeyframeInterval);
+    Payload expected;
+    received = Payload();
+    uint64_t nDecodeAllocations = 0;
+    bool isCorrect = true;
+    for (int i = 0; i < NFrames; ++i) {
+        updatePayload(expected, i);
+
+        const std::vector<std::byte>& frame = frames[i];
+        const uint64_t n = countAllocations([&client, &frame]() {
+            client.decode(
+                reinterpret_cast<const char*>(frame.data()),
+                static_cast<int>(frame.size())
+            );
+        });
+        nDecodeAllocations += i > 0 ? n : 0;
+
+        isCorrect &= received.time == expected.time &&
+                     received.frame == expected.frame &&
+                     received.values == expected.values;
+    }
+    SharedData::destroy();
+
+    if (!isCorrect) {
+        Log::Error("Decoded wrong values with {} encoding", mode);
+        return false;
+    }
+    if (nEncodeAllocations > 0 || nDecodeAllocations > 0) {
+        Log::Error(
+            "{} heap allocations when encoding and {} when decoding {} frames with {} "
+            "encoding",
+            nEncodeAllocations, nDecodeAllocations, NFrames - 1, mode
+        );
+        return false;
+    }
+    Log::Info("{} frames without heap allocations with {} encoding", NFrames - 1, mode);
+    return true;
+}
+
+int main() {
+    if (!AllocationCounter::isAvailable()) {
+        Log::Warning("SGCT was built without the allocation counter");
+        // Reported as a skipped test by CTest
+        return SGCT_TEST_SKIP_CODE;
+    }
+
+    const bool isFullCorrect = runFrames(false);
+    const bool isDeltaCorrect = runFrames(true);
+    return isFullCorrect && isDeltaCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
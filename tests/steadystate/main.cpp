@@ -0,0 +1,120 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2021                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/sgct.h>
+#include <sgct/allocationcounter.h>
+#include <sgct/opengl.h>
+#include <cmath>
+
+// Runs the render loop headless and fails if any frame after the warm-up allocates on
+// the heap of the render thread
+
+namespace {
+    // The first frames create the framebuffers and shaders and fill the network buffers,
+    // so they are not expected to be free of allocations
+    constexpr const int WarmupFrames = 100;
+
+    double currentTime = 0.0;
+
+    int nMeasuredFrames = 0;
+    int nFramesWithAllocations = 0;
+    uint64_t nAllocations = 0;
+} // namespace
+
+using namespace sgct;
+
+void preSync() {
+    if (Engine::instance().isMaster()) {
+        currentTime = Engine::getTime();
+    }
+}
+
+void postSyncPreDraw() {
+    const Engine& engine = Engine::instance();
+    if (engine.currentFrameNumber() <= static_cast<unsigned int>(WarmupFrames)) {
+        return;
+    }
+
+    // At this point, the newest entry of the statistics is the previous frame
+    const uint64_t n = engine.statistics().allocations[0];
+    nMeasuredFrames++;
+    if (n > 0) {
+        nFramesWithAllocations++;
+        nAllocations += n;
+    }
+}
+
+void draw(const RenderData&) {
+    const float v = static_cast<float>(std::fmod(currentTime, 1.0));
+    glClearColor(v, v, v, 1.f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void encode(std::vector<std::byte>& data) {
+    serializeObject(data, currentTime);
+}
+
+void decode(const std::byte* data, size_t) {
+    unsigned int pos = 0;
+    deserializeObject(data, pos, currentTime);
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> arg(argv + 1, argv + argc);
+    Configuration config = parseArguments(arg);
+    config::Cluster cluster = loadCluster(config.configFilename);
+    if (!cluster.success) {
+        return EXIT_FAILURE;
+    }
+
+    if (!AllocationCounter::isAvailable()) {
+        Log::Warning("SGCT was built without the allocation counter");
+        // Reported as a skipped test by CTest
+        return SGCT_TEST_SKIP_CODE;
+    }
+    if (!config.maxFrames || *config.maxFrames <= WarmupFrames) {
+        Log::Error(
+            "The test requires --max-frames with more than {} frames", WarmupFrames
+        );
+        return EXIT_FAILURE;
+    }
+    config.countAllocations = true;
+
+    Engine::Callbacks callbacks;
+    callbacks.preSync = preSync;
+    callbacks.postSyncPreDraw = postSyncPreDraw;
+    callbacks.draw = draw;
+    callbacks.encodeInPlace = encode;
+    callbacks.decodeInPlace = decode;
+
+    try {
+        Engine::create(cluster, callbacks, config);
+    }
+    catch (const std::runtime_error& e) {
+        Log::Error(e.what());
+        Engine::destroy();
+        return EXIT_FAILURE;
+    }
+
+    Engine::instance().render();
+    Engine::destroy();
+
+    if (nMeasuredFrames == 0) {
+        Log::Error("The render loop ended before the warm-up was over");
+        return EXIT_FAILURE;
+    }
+    if (nFramesWithAllocations > 0) {
+        Log::Error(
+            "{} of {} frames allocated on the heap, {} allocations in total",
+            nFramesWithAllocations, nMeasuredFrames, nAllocations
+        );
+        return EXIT_FAILURE;
+    }
+    Log::Info("{} frames without heap allocations", nMeasuredFrames);
+    return EXIT_SUCCESS;
+}